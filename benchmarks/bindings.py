@@ -0,0 +1,64 @@
+#!/usr/bin/env python3
+#
+# Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+#
+# SPDX-License-Identifier: LGPL-3.0-or-later
+
+# Runs the same formatting workloads in C and through the bindings,
+# and reports the time per value of each against the C baseline.
+#
+# Usage: bindings.py N-VALUES C-COMMAND [COMMAND...]
+#
+# Every command is run with N-VALUES as its last argument, and must
+# print lines like "Lang workload: 123.4 ns/value".
+
+import re
+import shlex
+import subprocess
+import sys
+
+LINE_RE = re.compile(r'^(\S+) (\S+): ([0-9.]+) ns/value$')
+
+
+def run(command, n_values):
+    output = subprocess.run(shlex.split(command) + [n_values], check=True,
+                            stdout=subprocess.PIPE, text=True).stdout
+
+    for line in output.splitlines():
+        match = LINE_RE.match(line)
+        if match:
+            yield match.group(1), match.group(2), float(match.group(3))
+
+
+def main():
+    if len(sys.argv) < 3:
+        sys.exit(f'Usage: {sys.argv[0]} N-VALUES C-COMMAND [COMMAND...]')
+
+    n_values = sys.argv[1]
+    baseline = {}
+    failed = False
+
+    for i, command in enumerate(sys.argv[2:]):
+        try:
+            results = list(run(command, n_values))
+        except (OSError, subprocess.CalledProcessError) as e:
+            print(f'{command}: {e}', file=sys.stderr)
+            failed = True
+            continue
+
+        for lang, workload, ns in results:
+            if i == 0:
+                baseline[workload] = ns
+
+            if workload in baseline and baseline[workload] > 0:
+                ratio = f'{ns / baseline[workload]:6.2f}x C'
+            else:
+                ratio = ''
+
+            print(f'{lang:<8} {workload:<12} {ns:10.1f} ns/value  {ratio}')
+
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,152 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+// Measures the cost per value of formatting a list of numbers from C,
+// the baseline for the same workloads run through the bindings by
+// bulk-format.{js,py,vala}.
+//
+// Usage: bulk-format [N-VALUES]
+
+#define ICU_USE_UNSTABLE_API
+#include <icu-gobject.h>
+
+#define SKELETON "currency/EUR"
+#define LOCALE "de"
+
+typedef gboolean (*Workload) (IcuNumberFormatter  *formatter,
+                              const gint64        *values,
+                              gsize                n_values,
+                              GError             **error);
+
+static gboolean
+one_by_one (IcuNumberFormatter  *formatter,
+            const gint64        *values,
+            gsize                n_values,
+            GError             **error)
+{
+  gsize i = 0;
+
+  for (i = 0; i < n_values; i++)
+    {
+      g_autoptr (IcuFormattedNumber) number = NULL;
+      g_autofree gchar *string = NULL;
+
+      number = icu_number_formatter_format_int (formatter, values[i], error);
+      if (number == NULL)
+        return FALSE;
+
+      string = icu_formatted_number_to_string (number, error);
+      if (string == NULL)
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+static gboolean
+strv (IcuNumberFormatter  *formatter,
+      const gint64        *values,
+      gsize                n_values,
+      GError             **error)
+{
+  g_auto (GStrv) strings = NULL;
+
+  strings = icu_number_formatter_format_int_strv (formatter, values, n_values, error);
+
+  return strings != NULL;
+}
+
+static gboolean
+packed (IcuNumberFormatter  *formatter,
+        const gint64        *values,
+        gsize                n_values,
+        GError             **error)
+{
+  g_autoptr (GBytes) bytes = NULL;
+  g_autofree gsize *offsets = NULL;
+  gsize n_offsets = 0;
+
+  bytes = icu_number_formatter_format_int_packed (formatter, values, n_values, &offsets, &n_offsets, error);
+
+  return bytes != NULL;
+}
+
+static gboolean
+append (IcuNumberFormatter  *formatter,
+        const gint64        *values,
+        gsize                n_values,
+        GError             **error)
+{
+  g_autoptr (GString) out = NULL;
+  gsize i = 0;
+
+  out = g_string_new (NULL);
+
+  for (i = 0; i < n_values; i++)
+    {
+      g_string_truncate (out, 0);
+
+      if (!icu_number_formatter_append_int (formatter, values[i], out, NULL, error))
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+int
+main (int    argc,
+      char **argv)
+{
+  static const struct {
+    const gchar *name;
+    Workload workload;
+  } workloads[] = {
+    { "one-by-one", one_by_one },
+    { "strv", strv },
+    { "packed", packed },
+    { "append", append },
+  };
+  g_autoptr (IcuNumberFormatter) formatter = NULL;
+  g_autoptr (GError) error = NULL;
+  g_autofree gint64 *values = NULL;
+  gsize n_values = 100000;
+  gsize i = 0;
+
+  if (argc > 1)
+    n_values = g_ascii_strtoull (argv[1], NULL, 10);
+
+  values = g_new (gint64, n_values);
+
+  for (i = 0; i < n_values; i++)
+    values[i] = i * 37 % 100000;
+
+  formatter = icu_number_formatter_new (SKELETON, LOCALE, &error);
+  if (formatter == NULL)
+    {
+      g_printerr ("Could not create formatter: %s\n", error->message);
+      return 1;
+    }
+
+  for (i = 0; i < G_N_ELEMENTS (workloads); i++)
+    {
+      gint64 start = 0;
+      gint64 elapsed = 0;
+
+      start = g_get_monotonic_time ();
+
+      if (!workloads[i].workload (formatter, values, n_values, &error))
+        {
+          g_printerr ("%s: %s\n", workloads[i].name, error->message);
+          return 1;
+        }
+
+      elapsed = g_get_monotonic_time () - start;
+
+      g_print ("C %s: %.1f ns/value\n", workloads[i].name, elapsed * 1000.0 / n_values);
+    }
+
+  return 0;
+}
@@ -0,0 +1,56 @@
+#!/usr/bin/env -S gjs -m
+//
+// Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+//
+// SPDX-License-Identifier: LGPL-3.0-or-later
+
+// Measures the cost per value of formatting a list of numbers from
+// GJS, one call at a time and through the bulk APIs.
+//
+// Usage: gjs -m bulk-format.js [N-VALUES]
+//
+// Run it with GI_TYPELIB_PATH and LD_LIBRARY_PATH pointing at the
+// build directory of the library.
+
+import GLib from 'gi://GLib';
+import Icu from 'gi://Icu?version=0.0';
+import System from 'system';
+
+const SKELETON = 'currency/EUR';
+const LOCALE = 'de';
+
+function oneByOne(formatter, values) {
+    return values.map(value => formatter.format_int(value).to_string());
+}
+
+function strv(formatter, values) {
+    return formatter.format_int_strv(values);
+}
+
+function packed(formatter, values) {
+    const [bytes, offsets] = formatter.format_int_packed(values);
+    const data = bytes.toArray();
+    const decoder = new TextDecoder();
+
+    return values.map((_, i) => decoder.decode(data.subarray(offsets[i], offsets[i + 1])));
+}
+
+const nValues = ARGV.length > 0 ? parseInt(ARGV[0]) : 100000;
+const values = Array.from({length: nValues}, (_, i) => i * 37 % 100000);
+const formatter = Icu.NumberFormatter.new(SKELETON, LOCALE);
+let expected = null;
+
+for (const [name, workload] of [['one-by-one', oneByOne], ['strv', strv], ['packed', packed]]) {
+    const start = GLib.get_monotonic_time();
+    const result = workload(formatter, values);
+    const elapsed = GLib.get_monotonic_time() - start;
+
+    if (expected === null) {
+        expected = result;
+    } else if (result.join('\n') !== expected.join('\n')) {
+        printerr(`${name}: results differ from one-by-one`);
+        System.exit(1);
+    }
+
+    print(`GJS ${name}: ${(elapsed * 1000 / nValues).toFixed(1)} ns/value`);
+}
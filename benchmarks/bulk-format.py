@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+#
+# Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+#
+# SPDX-License-Identifier: LGPL-3.0-or-later
+
+# Measures the cost per value of formatting a list of numbers from
+# PyGObject, one call at a time and through the bulk APIs.
+#
+# Usage: bulk-format.py [N-VALUES]
+#
+# Run it with GI_TYPELIB_PATH and LD_LIBRARY_PATH pointing at the
+# build directory of the library.
+
+import sys
+import time
+
+import gi
+
+gi.require_version('Icu', '0.0')
+
+from gi.repository import Icu  # noqa: E402
+
+SKELETON = 'currency/EUR'
+LOCALE = 'de'
+
+
+def one_by_one(formatter, values):
+    return [formatter.format_int(value).to_string() for value in values]
+
+
+def strv(formatter, values):
+    return formatter.format_int_strv(values)
+
+
+def packed(formatter, values):
+    data, offsets = formatter.format_int_packed(values)
+    data = data.get_data()
+    return [data[offsets[i]:offsets[i + 1]].decode() for i in range(len(values))]
+
+
+def main():
+    n_values = int(sys.argv[1]) if len(sys.argv) > 1 else 100000
+    values = [i * 37 % 100000 for i in range(n_values)]
+    formatter = Icu.NumberFormatter.new(SKELETON, LOCALE)
+    expected = None
+
+    for name, workload in [('one-by-one', one_by_one), ('strv', strv), ('packed', packed)]:
+        start = time.perf_counter_ns()
+        result = workload(formatter, values)
+        elapsed = time.perf_counter_ns() - start
+
+        if expected is None:
+            expected = result
+        elif result != expected:
+            sys.exit(f'{name}: results differ from one-by-one')
+
+        print(f'Python {name}: {elapsed / n_values:.1f} ns/value')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,64 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+// Measures the cost per value of formatting a list of numbers from
+// Vala, one call at a time and through the bulk APIs.
+//
+// Usage: bulk-format-vala [N-VALUES]
+
+const string SKELETON = "currency/EUR";
+const string LOCALE = "de";
+
+[CCode (has_target = false)]
+delegate void Workload (Icu.NumberFormatter formatter, int64[] values) throws Error;
+
+void one_by_one (Icu.NumberFormatter formatter, int64[] values) throws Error {
+    foreach (var value in values) {
+        var number = formatter.format_int (value);
+        var text = number.to_string ();
+        assert (text != null);
+    }
+}
+
+void strv (Icu.NumberFormatter formatter, int64[] values) throws Error {
+    var strings = formatter.format_int_strv (values);
+    assert (strings.length == values.length);
+}
+
+void packed (Icu.NumberFormatter formatter, int64[] values) throws Error {
+    size_t[] offsets;
+    var bytes = formatter.format_int_packed (values, out offsets);
+    assert (offsets.length == values.length + 1 && bytes != null);
+}
+
+int main (string[] args) {
+    var n_values = args.length > 1 ? int.parse (args[1]) : 100000;
+    var values = new int64[n_values];
+
+    for (var i = 0; i < n_values; i++) {
+        values[i] = i * 37 % 100000;
+    }
+
+    try {
+        var formatter = new Icu.NumberFormatter (SKELETON, LOCALE);
+
+        string[] names = { "one-by-one", "strv", "packed" };
+        Workload[] workloads = { one_by_one, strv, packed };
+
+        for (var i = 0; i < workloads.length; i++) {
+            var start = get_monotonic_time ();
+            workloads[i] (formatter, values);
+            var elapsed = get_monotonic_time () - start;
+
+            print ("Vala %s: %.1f ns/value\n", names[i], elapsed * 1000.0 / n_values);
+        }
+    } catch (Error e) {
+        printerr ("Could not format: %s\n", e.message);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+// Measures how long it takes a fresh process to format its first
+// numbers, and how much memory it ends up using, optionally after
+// loading an ICU data file with icu_data_load_mmap().
+//
+// Usage: startup [DATA-FILE] [LOCALE...]
+
+#define ICU_USE_UNSTABLE_API
+#include <icu-gobject.h>
+
+static const gchar * const default_locales[] = { "en-US", "de", "pt-BR", NULL };
+
+static void
+print_memory_usage (void)
+{
+  g_autofree gchar *status = NULL;
+  g_auto (GStrv) lines = NULL;
+  gsize i = 0;
+
+  if (!g_file_get_contents ("/proc/self/status", &status, NULL, NULL))
+    return;
+
+  lines = g_strsplit (status, "\n", -1);
+
+  for (i = 0; lines[i] != NULL; i++)
+    {
+      if (g_str_has_prefix (lines[i], "VmRSS:") || g_str_has_prefix (lines[i], "VmHWM:"))
+        g_print ("%s\n", lines[i]);
+    }
+}
+
+int
+main (int    argc,
+      char **argv)
+{
+  g_autoptr (GError) error = NULL;
+  const gchar * const *locales = default_locales;
+  gint64 start = 0;
+  gint64 loaded = 0;
+  gint64 formatted = 0;
+  gsize i = 0;
+
+  start = g_get_monotonic_time ();
+
+  if (argc > 1 && *argv[1] != '\0')
+    {
+      if (!icu_data_load_mmap (argv[1], ICU_DATA_ADVICE_WILL_NEED, &error))
+        {
+          g_printerr ("Could not load %s: %s\n", argv[1], error->message);
+          return 1;
+        }
+    }
+
+  if (argc > 2)
+    locales = (const gchar * const *) &argv[2];
+
+  loaded = g_get_monotonic_time ();
+
+  for (i = 0; locales[i] != NULL; i++)
+    {
+      g_autoptr (IcuNumberFormatter) formatter = NULL;
+      g_autoptr (IcuFormattedNumber) number = NULL;
+      g_autofree gchar *string = NULL;
+
+      formatter = icu_number_formatter_new ("currency/EUR", locales[i], &error);
+      if (formatter == NULL)
+        break;
+
+      number = icu_number_formatter_format_double (formatter, 1234.5, &error);
+      if (number == NULL)
+        break;
+
+      string = icu_formatted_number_to_string (number, &error);
+      if (string == NULL)
+        break;
+    }
+
+  if (error != NULL)
+    {
+      g_printerr ("Could not format: %s\n", error->message);
+      return 1;
+    }
+
+  formatted = g_get_monotonic_time ();
+
+  g_print ("Data loading: %.3f ms\n", (loaded - start) / 1000.0);
+  g_print ("First formatting: %.3f ms\n", (formatted - loaded) / 1000.0);
+  print_memory_usage ();
+
+  return 0;
+}
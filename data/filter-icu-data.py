@@ -0,0 +1,121 @@
+#!/usr/bin/env python3
+#
+# Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+#
+# SPDX-License-Identifier: LGPL-3.0-or-later
+
+"""Trims an ICU common data file down to some locales and features.
+
+The main tree, which holds the number, date and plural data of every
+locale, is always kept for the requested locales, their parents and
+root. Whole trees and item kinds are kept or dropped by feature.
+Items that the kept ones depend on, like the targets of aliases, are
+then added back until icupkg reports no missing dependencies.
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+FEATURES = {
+    'break': lambda item: item.startswith('brkitr/'),
+    'collation': lambda item: item.startswith('coll/'),
+    'conversion': lambda item: item.endswith('.cnv'),
+    'currency': lambda item: item.startswith('curr/'),
+    'language': lambda item: item.startswith('lang/'),
+    'names': lambda item: item == 'unames.icu',
+    'region': lambda item: item.startswith('region/'),
+    'spellout': lambda item: item.startswith('rbnf/'),
+    'spoof': lambda item: item.endswith('.cfu'),
+    'stringprep': lambda item: item.endswith('.spp'),
+    'translit': lambda item: item.startswith('translit/'),
+    'unit': lambda item: item.startswith('unit/'),
+    'zone': lambda item: item.startswith('zone/'),
+}
+
+LOCALE_BUNDLE = re.compile(r'^[a-z]{2,3}(_[A-Za-z0-9]+)*\.res$')
+MISSING_ITEM = re.compile(r'depends on missing item (\S+)')
+
+
+def run_icupkg(icupkg, *args, check=True):
+    return subprocess.run([icupkg, *args], check=check, capture_output=True, text=True)
+
+
+def expand_locales(locales):
+    expanded = {'root'}
+
+    for locale in locales:
+        parts = locale.replace('-', '_').split('_')
+        for i in range(1, len(parts) + 1):
+            expanded.add('_'.join(parts[:i]))
+
+    return expanded
+
+
+def is_wanted(item, locales, features):
+    for feature, matches in FEATURES.items():
+        if matches(item) and feature not in features:
+            return False
+
+    name = item.rsplit('/', 1)[-1]
+    if name in ('pool.res', 'res_index.res') or not LOCALE_BUNDLE.match(name):
+        return True
+
+    return name[:-len('.res')] in locales
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument('--icupkg', default='icupkg')
+    parser.add_argument('--locales', required=True,
+                        help='comma-separated list of locales to keep')
+    parser.add_argument('--features', default='',
+                        help='comma-separated list of features to keep: ' + ', '.join(FEATURES))
+    parser.add_argument('input')
+    parser.add_argument('output')
+    args = parser.parse_args()
+
+    if os.path.basename(args.input) != os.path.basename(args.output):
+        # icupkg derives the package name ICU looks items up with from
+        # the file name, so it must stay the same.
+        parser.error('the input and output files must have the same name')
+
+    locales = expand_locales(filter(None, args.locales.split(',')))
+    features = set(filter(None, args.features.split(',')))
+
+    unknown = features - FEATURES.keys()
+    if unknown:
+        parser.error('unknown features: ' + ', '.join(sorted(unknown)))
+
+    items = run_icupkg(args.icupkg, '--list', args.input).stdout.split()
+    removed = {item for item in items if not is_wanted(item, locales, features)}
+
+    with tempfile.TemporaryDirectory() as tmpdir:
+        remove_list = os.path.join(tmpdir, 'remove.txt')
+
+        while True:
+            with open(remove_list, 'w') as f:
+                f.write('\n'.join(sorted(removed)) + '\n')
+
+            if os.path.exists(args.output):
+                os.remove(args.output)
+
+            run_icupkg(args.icupkg, '--ignore-deps', '--remove', remove_list, args.input, args.output)
+
+            # Listing fails when dependencies are missing, reporting
+            # each of them.
+            report = run_icupkg(args.icupkg, '--list', args.output, check=False)
+            missing = set(MISSING_ITEM.findall(report.stderr)) & removed
+            if not missing:
+                break
+
+            removed -= missing
+
+    print(f'Kept {len(items) - len(removed)} of {len(items)} items', file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "fuzz-common.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unicode/uclean.h>
+
+// Keeps the memory ICU allocates aligned like malloc() does.
+#define HEADER_SIZE 16
+
+#define DEFAULT_TIME_BUDGET_MS 250
+#define DEFAULT_ALLOC_BUDGET_KB (16 * 1024)
+
+static gboolean initialized = FALSE;
+static gint64 time_budget = 0;
+static gsize alloc_budget = 0;
+
+static gint64 start_time = 0;
+static gsize allocated = 0;
+static gsize allocated_at_start = 0;
+static gsize peak_allocated = 0;
+
+static void *
+counting_alloc (const void *context,
+                size_t      size)
+{
+  guint8 *mem = NULL;
+
+  mem = malloc (HEADER_SIZE + size);
+  if (mem == NULL)
+    return NULL;
+
+  memcpy (mem, &size, sizeof size);
+
+  allocated += size;
+  peak_allocated = MAX (peak_allocated, allocated);
+
+  return mem + HEADER_SIZE;
+}
+
+static void
+counting_free (const void *context,
+               void       *mem)
+{
+  guint8 *block = NULL;
+  size_t size = 0;
+
+  if (mem == NULL)
+    return;
+
+  block = (guint8 *) mem - HEADER_SIZE;
+  memcpy (&size, block, sizeof size);
+
+  allocated -= size;
+
+  free (block);
+}
+
+static void *
+counting_realloc (const void *context,
+                  void       *mem,
+                  size_t      size)
+{
+  guint8 *block = NULL;
+  size_t old_size = 0;
+
+  if (mem == NULL)
+    return counting_alloc (context, size);
+
+  block = (guint8 *) mem - HEADER_SIZE;
+  memcpy (&old_size, block, sizeof old_size);
+
+  block = realloc (block, HEADER_SIZE + size);
+  if (block == NULL)
+    return NULL;
+
+  memcpy (block, &size, sizeof size);
+
+  allocated = allocated - old_size + size;
+  peak_allocated = MAX (peak_allocated, allocated);
+
+  return block + HEADER_SIZE;
+}
+
+static gint64
+get_budget (const gchar *variable,
+            gint64       default_value)
+{
+  const gchar *value = NULL;
+
+  value = g_getenv (variable);
+  if (value == NULL || *value == '\0')
+    return default_value;
+
+  return g_ascii_strtoll (value, NULL, 10);
+}
+
+static void
+initialize (void)
+{
+  UErrorCode ec = U_ZERO_ERROR;
+
+  // Budgets of 0 disable the corresponding check.
+  time_budget = get_budget ("ICU_FUZZ_TIME_BUDGET_MS", DEFAULT_TIME_BUDGET_MS) * 1000;
+  alloc_budget = (gsize) get_budget ("ICU_FUZZ_ALLOC_BUDGET_KB", DEFAULT_ALLOC_BUDGET_KB) * 1024;
+
+  // This only works before ICU allocates anything, which is why it is
+  // done on the first input rather than whenever.
+  u_setMemoryFunctions (NULL, counting_alloc, counting_realloc, counting_free, &ec);
+  if (U_FAILURE (ec))
+    g_error ("Could not count ICU allocations: %s", u_errorName (ec));
+
+  initialized = TRUE;
+}
+
+// Starts measuring the time and ICU memory an input takes.
+void
+fuzz_begin (void)
+{
+  if (!initialized)
+    initialize ();
+
+  allocated_at_start = allocated;
+  peak_allocated = allocated;
+  start_time = g_get_monotonic_time ();
+}
+
+// Aborts if the input went over any budget, so that fuzzers report it
+// like any other crash and keep it.
+void
+fuzz_end (void)
+{
+  gint64 elapsed = 0;
+  gsize peak = 0;
+
+  elapsed = g_get_monotonic_time () - start_time;
+  peak = peak_allocated - allocated_at_start;
+
+  if (time_budget > 0 && elapsed > time_budget)
+    {
+      fprintf (stderr, "Time budget exceeded: %" G_GINT64_FORMAT " ms, budget is %" G_GINT64_FORMAT " ms\n",
+               elapsed / 1000, time_budget / 1000);
+      abort ();
+    }
+
+  if (alloc_budget > 0 && peak > alloc_budget)
+    {
+      fprintf (stderr, "Allocation budget exceeded: %" G_GSIZE_FORMAT " KiB, budget is %" G_GSIZE_FORMAT " KiB\n",
+               peak / 1024, alloc_budget / 1024);
+      abort ();
+    }
+}
+
+// Turns an input into a nul-terminated string, or returns NULL if it
+// is not valid UTF-8, like the strings the library accepts.
+gchar *
+fuzz_dup_string (const guint8 *data,
+                 gsize         size)
+{
+  if (!g_utf8_validate_len ((const gchar *) data, size, NULL))
+    return NULL;
+
+  return g_strndup ((const gchar *) data, size);
+}
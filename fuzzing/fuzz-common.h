@@ -0,0 +1,23 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#pragma once
+
+#define ICU_USE_UNSTABLE_API
+#include <icu-gobject.h>
+
+G_BEGIN_DECLS
+
+int LLVMFuzzerTestOneInput (const guint8 *data,
+                            gsize         size);
+
+void fuzz_begin (void);
+void fuzz_end   (void);
+
+gchar *fuzz_dup_string (const guint8 *data,
+                        gsize         size);
+
+G_END_DECLS
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+// Feeds inputs to the decimal number parser, as imported values would.
+// The first byte picks the skeleton to format them with.
+
+#include "fuzz-common.h"
+
+static const gchar * const skeletons[] = {
+  "",
+  "currency/EUR",
+  "precision-increment/0.05",
+  "scientific",
+  "compact-long",
+  "@@@",
+  "percent scale/100",
+  "precision-unlimited",
+};
+
+int
+LLVMFuzzerTestOneInput (const guint8 *data,
+                        gsize         size)
+{
+  static IcuNumberFormatter *formatters[G_N_ELEMENTS (skeletons)] = {0};
+  g_autoptr (IcuFormattedNumber) number = NULL;
+  g_autofree gchar *string = NULL;
+  g_autofree gchar *decimal = NULL;
+  gsize i = 0;
+
+  if (size == 0)
+    return 0;
+
+  fuzz_begin ();
+
+  i = data[0] % G_N_ELEMENTS (skeletons);
+
+  if (formatters[i] == NULL)
+    formatters[i] = icu_number_formatter_new (skeletons[i], "de", NULL);
+
+  // The value is not nul-terminated, so that reads past its end are
+  // caught by the sanitizers.
+  if (icu_number_formatter_try_format_decimal_len (formatters[i], (const gchar *) data + 1, size - 1, &number) == ICU_STATUS_OK)
+    {
+      string = icu_formatted_number_to_string (number, NULL);
+      decimal = icu_formatted_number_to_decimal_number (number, NULL);
+    }
+
+  fuzz_end ();
+
+  return 0;
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+// Formats the value after the first newline of inputs with the
+// skeleton before it, and checks the field positions of the result.
+
+#include "fuzz-common.h"
+
+#include <string.h>
+
+// Also covers the fields newer ICU versions have after the ones in
+// IcuNumberFormatField.
+#define N_FIELDS (ICU_NUM_COMPACT_FIELD + 4)
+
+static void
+check_utf16_positions (IcuFormattedNumber *number)
+{
+  g_autofree gchar *string = NULL;
+  glong length = 0;
+  gint32 field = 0;
+
+  string = icu_formatted_number_to_string (number, NULL);
+  if (string == NULL)
+    return;
+
+  g_free (g_utf8_to_utf16 (string, -1, NULL, &length, NULL));
+
+  for (field = 0; field < N_FIELDS; field++)
+    {
+      IcuFieldPosition position = { .field = field };
+
+      while (icu_formatted_number_next_field_position (number, &position, NULL))
+        {
+          if (position.begin_index < 0 || position.begin_index > position.end_index || position.end_index > length)
+            g_error ("Field %d of “%s” spans %d to %d", field, string, position.begin_index, position.end_index);
+        }
+    }
+}
+
+static void
+check_utf8_positions (IcuNumberFormatter *formatter,
+                      const gchar        *value)
+{
+  g_autoptr (GString) out = NULL;
+  g_autoptr (GArray) fields = NULL;
+  guint i = 0;
+
+  out = g_string_new ("prefix ");
+  fields = g_array_new (FALSE, FALSE, sizeof (IcuFieldPosition));
+
+  if (!icu_number_formatter_append_double (formatter, g_ascii_strtod (value, NULL), out, fields, NULL))
+    return;
+
+  for (i = 0; i < fields->len; i++)
+    {
+      const IcuFieldPosition *position = &g_array_index (fields, IcuFieldPosition, i);
+
+      if (position->begin_index < (gint32) strlen ("prefix ")
+          || position->begin_index > position->end_index
+          || (gsize) position->end_index > out->len)
+        g_error ("Field %d of “%s” spans %d to %d", position->field, out->str, position->begin_index, position->end_index);
+
+      // Byte offsets must never point into the middle of a character.
+      if ((out->str[position->begin_index] & 0xc0) == 0x80 || (out->str[position->end_index] & 0xc0) == 0x80)
+        g_error ("Field %d of “%s” splits a character", position->field, out->str);
+    }
+}
+
+int
+LLVMFuzzerTestOneInput (const guint8 *data,
+                        gsize         size)
+{
+  g_autofree gchar *skeleton = NULL;
+  g_autofree gchar *value = NULL;
+  g_autoptr (IcuNumberFormatter) formatter = NULL;
+  g_autoptr (IcuFormattedNumber) number = NULL;
+  const guint8 *newline = NULL;
+
+  newline = memchr (data, '\n', size);
+  if (newline == NULL)
+    return 0;
+
+  skeleton = fuzz_dup_string (data, newline - data);
+  if (skeleton == NULL)
+    return 0;
+
+  value = g_strndup ((const gchar *) newline + 1, size - (newline - data) - 1);
+
+  fuzz_begin ();
+
+  // Eastern Arabic digits take two bytes in UTF-8, which exercises
+  // the mapping of field positions to byte offsets.
+  formatter = icu_number_formatter_new (skeleton, "ar-EG", NULL);
+
+  if (formatter != NULL)
+    {
+      number = icu_number_formatter_format_decimal (formatter, value, NULL);
+      if (number != NULL)
+        check_utf16_positions (number);
+
+      check_utf8_positions (formatter, value);
+    }
+
+  fuzz_end ();
+
+  return 0;
+}
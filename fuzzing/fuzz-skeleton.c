@@ -0,0 +1,46 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+// Feeds inputs to the skeleton parser, as user-defined number formats
+// would, and formats a number with the skeletons it accepts.
+
+#include "fuzz-common.h"
+
+int
+LLVMFuzzerTestOneInput (const guint8 *data,
+                        gsize         size)
+{
+  g_autofree gchar *skeleton = NULL;
+  g_autofree gchar *canonical = NULL;
+  g_autofree gchar *string = NULL;
+  g_autoptr (IcuNumberFormatter) formatter = NULL;
+  g_autoptr (IcuFormattedNumber) number = NULL;
+
+  skeleton = fuzz_dup_string (data, size);
+  if (skeleton == NULL)
+    return 0;
+
+  fuzz_begin ();
+
+  canonical = icu_number_skeleton_canonicalize (skeleton);
+  formatter = icu_number_formatter_new (skeleton, "en", NULL);
+
+  if (formatter != NULL)
+    {
+      // Canonicalizing must never turn a valid skeleton into an
+      // invalid one, or the shared formatter cache would break.
+      if (!icu_number_skeleton_validate (canonical, NULL))
+        g_error ("“%s” is valid but its canonical form “%s” is not", skeleton, canonical);
+
+      number = icu_number_formatter_format_double (formatter, -1234567.891, NULL);
+      if (number != NULL)
+        string = icu_formatted_number_to_string (number, NULL);
+    }
+
+  fuzz_end ();
+
+  return 0;
+}
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+// Runs a fuzz target over the given files, and every file in the given
+// directories, or over standard input if there are none. This is what
+// replays the regression corpus, and what AFL runs when the compiler
+// has no libFuzzer.
+//
+// Usage: fuzz-TARGET-standalone [FILE-OR-DIRECTORY...]
+
+#include "fuzz-common.h"
+
+#include <stdio.h>
+
+static gboolean
+run_file (const gchar *filename)
+{
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *contents = NULL;
+  gsize length = 0;
+
+  if (!g_file_get_contents (filename, &contents, &length, &error))
+    {
+      g_printerr ("%s\n", error->message);
+      return FALSE;
+    }
+
+  LLVMFuzzerTestOneInput ((const guint8 *) contents, length);
+
+  return TRUE;
+}
+
+static gboolean
+run_stdin (void)
+{
+  g_autoptr (GByteArray) contents = NULL;
+  guint8 buffer[4096];
+  gsize n_read = 0;
+
+  contents = g_byte_array_new ();
+
+  while ((n_read = fread (buffer, 1, sizeof buffer, stdin)) > 0)
+    g_byte_array_append (contents, buffer, n_read);
+
+  LLVMFuzzerTestOneInput (contents->data, contents->len);
+
+  return !ferror (stdin);
+}
+
+int
+main (int    argc,
+      char **argv)
+{
+  guint n_inputs = 0;
+  gboolean success = TRUE;
+  int i = 0;
+
+  if (argc < 2)
+    return run_stdin () ? 0 : 1;
+
+  for (i = 1; i < argc; i++)
+    {
+      g_autoptr (GDir) dir = NULL;
+      const gchar *name = NULL;
+
+      if (!g_file_test (argv[i], G_FILE_TEST_IS_DIR))
+        {
+          success &= run_file (argv[i]);
+          n_inputs++;
+          continue;
+        }
+
+      dir = g_dir_open (argv[i], 0, NULL);
+
+      while (dir != NULL && (name = g_dir_read_name (dir)) != NULL)
+        {
+          g_autofree gchar *filename = g_build_filename (argv[i], name, NULL);
+
+          success &= run_file (filename);
+          n_inputs++;
+        }
+    }
+
+  g_print ("Ran %u inputs\n", n_inputs);
+
+  return success ? 0 : 1;
+}
@@ -0,0 +1,471 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "icu-break-iterator.h"
+
+#include <string.h>
+#include <unicode/ubrk.h>
+#include <unicode/utext.h>
+#include "icu-error-private.h"
+
+/**
+ * IcuBreakIterator:
+ *
+ * Locates boundaries (characters, words, lines or sentences) in
+ * UTF-8 text.
+ *
+ * The text is never converted nor copied: the iterator reads it in
+ * place through a UTF-8 `UText`, so every offset it returns is a
+ * byte offset into the text that was passed to
+ * [method@BreakIterator.set_text].
+ *
+ * A [class@BreakIterator] must not be used from more than one thread
+ * at a time. To segment several documents in parallel, create one
+ * iterator and give each worker its own copy with
+ * [method@BreakIterator.clone], which does not need to reload the
+ * break rules.
+ */
+
+struct _IcuBreakIterator
+{
+  guint ref_count;
+  UBreakIterator *ubrk;
+  GBytes *bytes;
+};
+
+G_DEFINE_BOXED_TYPE (IcuBreakIterator, icu_break_iterator, icu_break_iterator_ref, icu_break_iterator_unref)
+
+static void
+icu_break_iterator_free (IcuBreakIterator *self)
+{
+  g_assert_nonnull (self);
+  g_assert_cmpuint (self->ref_count, ==, 0);
+
+  g_clear_pointer (&self->ubrk, ubrk_close);
+  g_clear_pointer (&self->bytes, g_bytes_unref);
+
+  g_slice_free (IcuBreakIterator, self);
+}
+
+/**
+ * icu_break_iterator_new:
+ * @type: The kind of boundaries to locate.
+ * @locale: (nullable): The locale whose rules should be used, or
+ *   `NULL` to use the default locale.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Creates a new [class@BreakIterator] with no text set.
+ *
+ * Returns: (transfer full): A newly created [class@BreakIterator].
+ */
+IcuBreakIterator *
+icu_break_iterator_new (IcuBreakIteratorType   type,
+                        const gchar           *locale,
+                        GError               **error)
+{
+  g_autoptr (IcuBreakIterator) self = NULL;
+  UErrorCode ec = U_ZERO_ERROR;
+
+  self = g_slice_new0 (IcuBreakIterator);
+  self->ref_count = 1;
+
+  self->ubrk = ubrk_open ((UBreakIteratorType) type, locale, NULL, 0, &ec);
+  if (icu_has_failed (ec, error))
+    return NULL;
+
+  return g_steal_pointer (&self);
+}
+
+/**
+ * icu_break_iterator_ref:
+ * @self: A [class@BreakIterator].
+ *
+ * Increases the reference count of `self` by one.
+ *
+ * Returns: (transfer full): The passed in [class@BreakIterator].
+ */
+IcuBreakIterator *
+icu_break_iterator_ref (IcuBreakIterator *self)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+
+  g_atomic_int_inc (&self->ref_count);
+
+  return self;
+}
+
+/**
+ * icu_break_iterator_unref:
+ * @self: A [class@BreakIterator].
+ *
+ * Decreases the reference count of `self` by one.
+ *
+ * If the resulting reference count is zero, frees the memory of
+ * `self`.
+ */
+void
+icu_break_iterator_unref (IcuBreakIterator *self)
+{
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (self->ref_count >= 1);
+
+  if (g_atomic_int_dec_and_test (&self->ref_count))
+    icu_break_iterator_free (self);
+}
+
+/**
+ * icu_break_iterator_clone:
+ * @self: A [class@BreakIterator].
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Creates an independent copy of `self`, sharing its break rules.
+ *
+ * The copy starts out over the same text and at the same position
+ * as `self`, and can then be moved to another text. This is the
+ * cheap way to obtain one iterator per thread.
+ *
+ * Returns: (transfer full): A newly created [class@BreakIterator].
+ */
+IcuBreakIterator *
+icu_break_iterator_clone (IcuBreakIterator  *self,
+                          GError           **error)
+{
+  g_autoptr (IcuBreakIterator) clone = NULL;
+  UErrorCode ec = U_ZERO_ERROR;
+
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+
+  clone = g_slice_new0 (IcuBreakIterator);
+  clone->ref_count = 1;
+
+  clone->ubrk = ubrk_clone (self->ubrk, &ec);
+  if (icu_has_failed (ec, error))
+    return NULL;
+
+  if (self->bytes != NULL)
+    clone->bytes = g_bytes_ref (self->bytes);
+
+  return g_steal_pointer (&clone);
+}
+
+/**
+ * icu_break_iterator_set_text:
+ * @self: A [class@BreakIterator].
+ * @text: (array length=length) (element-type guint8): The UTF-8
+ *   text to iterate over.
+ * @length: The length of `text` in bytes, or -1 if it is
+ *   nul-terminated.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Points `self` at `text` and resets its position to the start.
+ *
+ * `text` is not copied, so it must stay alive and unmodified for as
+ * long as `self` (or any clone made afterwards) iterates over it.
+ * Use [method@BreakIterator.set_bytes] to have `self` keep the text
+ * alive instead.
+ *
+ * Because boundaries are reported as `gint32` byte offsets, `text`
+ * must be shorter than 2 GiB.
+ *
+ * Returns: `TRUE` on success, `FALSE` if `error` is set.
+ */
+gboolean
+icu_break_iterator_set_text (IcuBreakIterator  *self,
+                             const gchar       *text,
+                             gssize             length,
+                             GError           **error)
+{
+  UText utext = UTEXT_INITIALIZER;
+  UErrorCode ec = U_ZERO_ERROR;
+
+  g_return_val_if_fail (self != NULL, FALSE);
+  g_return_val_if_fail (self->ref_count >= 1, FALSE);
+  g_return_val_if_fail (text != NULL || length == 0, FALSE);
+
+  if (length < 0)
+    length = strlen (text);
+
+  if (length > G_MAXINT32)
+    {
+      icu_has_failed (U_INPUT_TOO_LONG_ERROR, error);
+      return FALSE;
+    }
+
+  utext_openUTF8 (&utext, text, length, &ec);
+  if (icu_has_failed (ec, error))
+    return FALSE;
+
+  // The break iterator keeps a shallow clone of the UText, which
+  // still points to the caller's memory.
+  ubrk_setUText (self->ubrk, &utext, &ec);
+  utext_close (&utext);
+  if (icu_has_failed (ec, error))
+    return FALSE;
+
+  g_clear_pointer (&self->bytes, g_bytes_unref);
+
+  return TRUE;
+}
+
+/**
+ * icu_break_iterator_set_bytes:
+ * @self: A [class@BreakIterator].
+ * @bytes: The UTF-8 text to iterate over.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Like [method@BreakIterator.set_text], but takes a reference on
+ * `bytes` so the text stays alive while `self` iterates over it.
+ *
+ * Returns: `TRUE` on success, `FALSE` if `error` is set.
+ */
+gboolean
+icu_break_iterator_set_bytes (IcuBreakIterator  *self,
+                              GBytes            *bytes,
+                              GError           **error)
+{
+  gconstpointer data = NULL;
+  gsize size = 0;
+
+  g_return_val_if_fail (self != NULL, FALSE);
+  g_return_val_if_fail (self->ref_count >= 1, FALSE);
+  g_return_val_if_fail (bytes != NULL, FALSE);
+
+  data = g_bytes_get_data (bytes, &size);
+
+  if (!icu_break_iterator_set_text (self, data, size, error))
+    return FALSE;
+
+  self->bytes = g_bytes_ref (bytes);
+
+  return TRUE;
+}
+
+/**
+ * icu_break_iterator_first:
+ * @self: A [class@BreakIterator].
+ *
+ * Moves `self` to the start of the text.
+ *
+ * Returns: The byte offset of the first boundary, which is always
+ *   zero.
+ */
+gint32
+icu_break_iterator_first (IcuBreakIterator *self)
+{
+  g_return_val_if_fail (self != NULL, ICU_BREAK_ITERATOR_DONE);
+  g_return_val_if_fail (self->ref_count >= 1, ICU_BREAK_ITERATOR_DONE);
+
+  return ubrk_first (self->ubrk);
+}
+
+/**
+ * icu_break_iterator_last:
+ * @self: A [class@BreakIterator].
+ *
+ * Moves `self` to the end of the text.
+ *
+ * Returns: The byte offset of the last boundary, which is the
+ *   length of the text.
+ */
+gint32
+icu_break_iterator_last (IcuBreakIterator *self)
+{
+  g_return_val_if_fail (self != NULL, ICU_BREAK_ITERATOR_DONE);
+  g_return_val_if_fail (self->ref_count >= 1, ICU_BREAK_ITERATOR_DONE);
+
+  return ubrk_last (self->ubrk);
+}
+
+/**
+ * icu_break_iterator_next:
+ * @self: A [class@BreakIterator].
+ *
+ * Advances `self` to the next boundary.
+ *
+ * Returns: The byte offset of the next boundary, or
+ *   [const@BREAK_ITERATOR_DONE] if the end of the text was reached.
+ */
+gint32
+icu_break_iterator_next (IcuBreakIterator *self)
+{
+  g_return_val_if_fail (self != NULL, ICU_BREAK_ITERATOR_DONE);
+  g_return_val_if_fail (self->ref_count >= 1, ICU_BREAK_ITERATOR_DONE);
+
+  return ubrk_next (self->ubrk);
+}
+
+/**
+ * icu_break_iterator_previous:
+ * @self: A [class@BreakIterator].
+ *
+ * Moves `self` back to the previous boundary.
+ *
+ * Returns: The byte offset of the previous boundary, or
+ *   [const@BREAK_ITERATOR_DONE] if `self` was at the start of the
+ *   text.
+ */
+gint32
+icu_break_iterator_previous (IcuBreakIterator *self)
+{
+  g_return_val_if_fail (self != NULL, ICU_BREAK_ITERATOR_DONE);
+  g_return_val_if_fail (self->ref_count >= 1, ICU_BREAK_ITERATOR_DONE);
+
+  return ubrk_previous (self->ubrk);
+}
+
+/**
+ * icu_break_iterator_following:
+ * @self: A [class@BreakIterator].
+ * @offset: A byte offset into the text.
+ *
+ * Moves `self` to the first boundary after `offset`.
+ *
+ * Returns: The byte offset of the boundary, or
+ *   [const@BREAK_ITERATOR_DONE] if there is none.
+ */
+gint32
+icu_break_iterator_following (IcuBreakIterator *self,
+                              gint32            offset)
+{
+  g_return_val_if_fail (self != NULL, ICU_BREAK_ITERATOR_DONE);
+  g_return_val_if_fail (self->ref_count >= 1, ICU_BREAK_ITERATOR_DONE);
+
+  return ubrk_following (self->ubrk, offset);
+}
+
+/**
+ * icu_break_iterator_preceding:
+ * @self: A [class@BreakIterator].
+ * @offset: A byte offset into the text.
+ *
+ * Moves `self` to the last boundary before `offset`.
+ *
+ * Returns: The byte offset of the boundary, or
+ *   [const@BREAK_ITERATOR_DONE] if there is none.
+ */
+gint32
+icu_break_iterator_preceding (IcuBreakIterator *self,
+                              gint32            offset)
+{
+  g_return_val_if_fail (self != NULL, ICU_BREAK_ITERATOR_DONE);
+  g_return_val_if_fail (self->ref_count >= 1, ICU_BREAK_ITERATOR_DONE);
+
+  return ubrk_preceding (self->ubrk, offset);
+}
+
+/**
+ * icu_break_iterator_current:
+ * @self: A [class@BreakIterator].
+ *
+ * Gets the boundary `self` is currently at.
+ *
+ * Returns: The byte offset of the most recently returned boundary.
+ */
+gint32
+icu_break_iterator_current (IcuBreakIterator *self)
+{
+  g_return_val_if_fail (self != NULL, ICU_BREAK_ITERATOR_DONE);
+  g_return_val_if_fail (self->ref_count >= 1, ICU_BREAK_ITERATOR_DONE);
+
+  return ubrk_current (self->ubrk);
+}
+
+/**
+ * icu_break_iterator_is_boundary:
+ * @self: A [class@BreakIterator].
+ * @offset: A byte offset into the text.
+ *
+ * Determines whether `offset` is a boundary, and moves `self` to the
+ * first boundary at or after `offset`.
+ *
+ * Returns: `TRUE` if `offset` is a boundary, `FALSE` otherwise.
+ */
+gboolean
+icu_break_iterator_is_boundary (IcuBreakIterator *self,
+                                gint32            offset)
+{
+  g_return_val_if_fail (self != NULL, FALSE);
+  g_return_val_if_fail (self->ref_count >= 1, FALSE);
+
+  return ubrk_isBoundary (self->ubrk, offset);
+}
+
+/**
+ * icu_break_iterator_get_rule_status:
+ * @self: A [class@BreakIterator].
+ *
+ * Gets the status tag of the rule that determined the current
+ * boundary.
+ *
+ * For word iterators, this tells apart the segments made of letters,
+ * numbers, kana or ideographs from whitespace and punctuation.
+ *
+ * Returns: The rule status of the current boundary.
+ */
+gint32
+icu_break_iterator_get_rule_status (IcuBreakIterator *self)
+{
+  g_return_val_if_fail (self != NULL, 0);
+  g_return_val_if_fail (self->ref_count >= 1, 0);
+
+  return ubrk_getRuleStatus (self->ubrk);
+}
+
+/**
+ * icu_break_iterator_next_boundaries:
+ * @self: A [class@BreakIterator].
+ * @boundaries: (array length=n_boundaries) (out caller-allocates):
+ *   The return location for the byte offsets of the boundaries.
+ * @rule_statuses: (array length=n_boundaries) (out caller-allocates) (optional):
+ *   The return location for the rule status of each boundary, or
+ *   `NULL`.
+ * @n_boundaries: The number of elements available in `boundaries`
+ *   (and `rule_statuses`, if given).
+ *
+ * Advances `self` by up to `n_boundaries` boundaries, storing each
+ * of them in `boundaries`.
+ *
+ * This is equivalent to calling [method@BreakIterator.next] (and
+ * [method@BreakIterator.get_rule_status]) repeatedly, but fills a
+ * whole block per call.
+ *
+ * Returns: The number of boundaries stored, which is less than
+ *   `n_boundaries` only when the end of the text was reached, and
+ *   zero once there are no more boundaries.
+ */
+gsize
+icu_break_iterator_next_boundaries (IcuBreakIterator *self,
+                                    gint32           *boundaries,
+                                    gint32           *rule_statuses,
+                                    gsize             n_boundaries)
+{
+  gsize i = 0;
+
+  g_return_val_if_fail (self != NULL, 0);
+  g_return_val_if_fail (self->ref_count >= 1, 0);
+  g_return_val_if_fail (boundaries != NULL || n_boundaries == 0, 0);
+
+  for (i = 0; i < n_boundaries; i++)
+    {
+      gint32 boundary = ubrk_next (self->ubrk);
+
+      if (boundary == UBRK_DONE)
+        break;
+
+      boundaries[i] = boundary;
+
+      if (rule_statuses != NULL)
+        rule_statuses[i] = ubrk_getRuleStatus (self->ubrk);
+    }
+
+  return i;
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#pragma once
+
+#if !defined(_ICU_GOBJECT_INSIDE) && !defined(ICU_GOBJECT_COMPILATION)
+#  error "Only <icu-gobject.h> can be included directly"
+#endif
+
+#include <glib-object.h>
+#include "icu-version.h"
+
+G_BEGIN_DECLS
+
+/**
+ * ICU_BREAK_ITERATOR_DONE:
+ *
+ * Value returned by the [class@BreakIterator] methods when there are
+ * no more boundaries to return.
+ */
+#define ICU_BREAK_ITERATOR_DONE (-1)
+
+typedef enum {
+  ICU_BREAK_ITERATOR_TYPE_CHARACTER = 0,
+  ICU_BREAK_ITERATOR_TYPE_WORD      = 1,
+  ICU_BREAK_ITERATOR_TYPE_LINE      = 2,
+  ICU_BREAK_ITERATOR_TYPE_SENTENCE  = 3,
+} IcuBreakIteratorType;
+
+#define ICU_TYPE_BREAK_ITERATOR (icu_break_iterator_get_type())
+
+typedef struct _IcuBreakIterator IcuBreakIterator;
+
+ICU_AVAILABLE_IN_ALL
+GType icu_break_iterator_get_type (void);
+
+ICU_AVAILABLE_IN_ALL
+IcuBreakIterator *icu_break_iterator_new (IcuBreakIteratorType   type,
+                                          const gchar           *locale,
+                                          GError               **error);
+
+ICU_AVAILABLE_IN_ALL
+IcuBreakIterator *icu_break_iterator_ref   (IcuBreakIterator *self);
+ICU_AVAILABLE_IN_ALL
+void              icu_break_iterator_unref (IcuBreakIterator *self);
+
+ICU_AVAILABLE_IN_ALL
+IcuBreakIterator *icu_break_iterator_clone (IcuBreakIterator  *self,
+                                            GError           **error);
+
+ICU_AVAILABLE_IN_ALL
+gboolean icu_break_iterator_set_text  (IcuBreakIterator  *self,
+                                       const gchar       *text,
+                                       gssize             length,
+                                       GError           **error);
+ICU_AVAILABLE_IN_ALL
+gboolean icu_break_iterator_set_bytes (IcuBreakIterator  *self,
+                                       GBytes            *bytes,
+                                       GError           **error);
+
+ICU_AVAILABLE_IN_ALL
+gint32 icu_break_iterator_first     (IcuBreakIterator *self);
+ICU_AVAILABLE_IN_ALL
+gint32 icu_break_iterator_last      (IcuBreakIterator *self);
+ICU_AVAILABLE_IN_ALL
+gint32 icu_break_iterator_next      (IcuBreakIterator *self);
+ICU_AVAILABLE_IN_ALL
+gint32 icu_break_iterator_previous  (IcuBreakIterator *self);
+ICU_AVAILABLE_IN_ALL
+gint32 icu_break_iterator_following (IcuBreakIterator *self,
+                                     gint32            offset);
+ICU_AVAILABLE_IN_ALL
+gint32 icu_break_iterator_preceding (IcuBreakIterator *self,
+                                     gint32            offset);
+ICU_AVAILABLE_IN_ALL
+gint32 icu_break_iterator_current   (IcuBreakIterator *self);
+
+ICU_AVAILABLE_IN_ALL
+gboolean icu_break_iterator_is_boundary     (IcuBreakIterator *self,
+                                             gint32            offset);
+ICU_AVAILABLE_IN_ALL
+gint32   icu_break_iterator_get_rule_status (IcuBreakIterator *self);
+
+ICU_AVAILABLE_IN_ALL
+gsize icu_break_iterator_next_boundaries (IcuBreakIterator *self,
+                                          gint32           *boundaries,
+                                          gint32           *rule_statuses,
+                                          gsize             n_boundaries);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (IcuBreakIterator, icu_break_iterator_unref)
+
+G_END_DECLS
@@ -0,0 +1,473 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "icu-case-map.h"
+
+#include <string.h>
+#include <unicode/ucasemap.h>
+#include <unicode/uloc.h>
+#include "icu-error-private.h"
+
+/**
+ * IcuCaseMap:
+ *
+ * Performs locale-sensitive case mapping and case folding of UTF-8
+ * text, without converting it to UTF-16.
+ *
+ * Strings made only of ASCII characters are mapped without calling
+ * into ICU whenever the result is known to be the same, which is
+ * the case for lowercasing, uppercasing and folding outside of the
+ * Turkic locales.
+ *
+ * A [class@CaseMap] can be shared between threads.
+ */
+
+struct _IcuCaseMap
+{
+  guint ref_count;
+  UCaseMap *ucasemap;
+
+  // ucasemap_utf8ToTitle() lazily creates and then reuses a break
+  // iterator, so it must not run concurrently.
+  GMutex title_lock;
+
+  gboolean ascii_lower_upper;
+  gboolean ascii_fold;
+};
+
+G_DEFINE_BOXED_TYPE (IcuCaseMap, icu_case_map, icu_case_map_ref, icu_case_map_unref)
+
+static void
+icu_case_map_free (IcuCaseMap *self)
+{
+  g_assert_nonnull (self);
+  g_assert_cmpuint (self->ref_count, ==, 0);
+
+  g_clear_pointer (&self->ucasemap, ucasemap_close);
+  g_mutex_clear (&self->title_lock);
+
+  g_slice_free (IcuCaseMap, self);
+}
+
+static gboolean
+is_ascii (const gchar *src,
+          gsize        length)
+{
+  guchar acc = 0;
+  gsize i = 0;
+
+  for (i = 0; i < length; i++)
+    acc |= (guchar) src[i];
+
+  return acc < 0x80;
+}
+
+static gboolean
+can_map_as_ascii (IcuCaseMap     *self,
+                  IcuCaseMapping  mapping,
+                  const gchar    *src,
+                  gsize           length)
+{
+  switch (mapping)
+    {
+    case ICU_CASE_MAPPING_LOWER:
+    case ICU_CASE_MAPPING_UPPER:
+      if (!self->ascii_lower_upper)
+        return FALSE;
+      break;
+
+    case ICU_CASE_MAPPING_FOLD:
+      if (!self->ascii_fold)
+        return FALSE;
+      break;
+
+    case ICU_CASE_MAPPING_TITLE:
+    default:
+      return FALSE;
+    }
+
+  return is_ascii (src, length);
+}
+
+static void
+map_ascii (IcuCaseMapping  mapping,
+           const gchar    *src,
+           gsize           length,
+           gchar          *dest)
+{
+  gsize i = 0;
+
+  if (mapping == ICU_CASE_MAPPING_UPPER)
+    {
+      for (i = 0; i < length; i++)
+        dest[i] = g_ascii_toupper (src[i]);
+    }
+  else
+    {
+      for (i = 0; i < length; i++)
+        dest[i] = g_ascii_tolower (src[i]);
+    }
+}
+
+static gint32
+map_utf8 (IcuCaseMap     *self,
+          IcuCaseMapping  mapping,
+          const gchar    *src,
+          gint32          src_length,
+          gchar          *dest,
+          gint32          dest_capacity,
+          UErrorCode     *ec)
+{
+  gint32 length = 0;
+
+  switch (mapping)
+    {
+    case ICU_CASE_MAPPING_LOWER:
+      return ucasemap_utf8ToLower (self->ucasemap, dest, dest_capacity, src, src_length, ec);
+
+    case ICU_CASE_MAPPING_UPPER:
+      return ucasemap_utf8ToUpper (self->ucasemap, dest, dest_capacity, src, src_length, ec);
+
+    case ICU_CASE_MAPPING_FOLD:
+      return ucasemap_utf8FoldCase (self->ucasemap, dest, dest_capacity, src, src_length, ec);
+
+    case ICU_CASE_MAPPING_TITLE:
+      g_mutex_lock (&self->title_lock);
+      length = ucasemap_utf8ToTitle (self->ucasemap, dest, dest_capacity, src, src_length, ec);
+      g_mutex_unlock (&self->title_lock);
+      return length;
+
+    default:
+      *ec = U_ILLEGAL_ARGUMENT_ERROR;
+      return 0;
+    }
+}
+
+/**
+ * icu_case_map_new:
+ * @locale: (nullable): The locale whose case mapping rules should be
+ *   used, or `NULL` to use the default locale.
+ * @options: Options for case folding and titlecasing.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Creates a new [class@CaseMap].
+ *
+ * Returns: (transfer full): A newly created [class@CaseMap].
+ */
+IcuCaseMap *
+icu_case_map_new (const gchar        *locale,
+                  IcuCaseMapOptions   options,
+                  GError            **error)
+{
+  g_autoptr (IcuCaseMap) self = NULL;
+  gchar language[ULOC_LANG_CAPACITY] = {0};
+  UErrorCode ec = U_ZERO_ERROR;
+
+  self = g_slice_new0 (IcuCaseMap);
+  self->ref_count = 1;
+  g_mutex_init (&self->title_lock);
+
+  self->ucasemap = ucasemap_open (locale, options, &ec);
+  if (icu_has_failed (ec, error))
+    return NULL;
+
+  uloc_getLanguage (ucasemap_getLocale (self->ucasemap), language, sizeof language, &ec);
+  if (icu_has_failed (ec, error))
+    return NULL;
+
+  // Turkish and Azeri map the ASCII letters I and i to non-ASCII
+  // dotless and dotted variants, and so does folding when asked to
+  // exclude the special I.
+  self->ascii_lower_upper = g_strcmp0 (language, "tr") != 0 && g_strcmp0 (language, "az") != 0;
+  self->ascii_fold = (options & ICU_CASE_MAP_OPTIONS_FOLD_EXCLUDE_SPECIAL_I) == 0;
+
+  return g_steal_pointer (&self);
+}
+
+/**
+ * icu_case_map_ref:
+ * @self: A [class@CaseMap].
+ *
+ * Increases the reference count of `self` by one.
+ *
+ * Returns: (transfer full): The passed in [class@CaseMap].
+ */
+IcuCaseMap *
+icu_case_map_ref (IcuCaseMap *self)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+
+  g_atomic_int_inc (&self->ref_count);
+
+  return self;
+}
+
+/**
+ * icu_case_map_unref:
+ * @self: A [class@CaseMap].
+ *
+ * Decreases the reference count of `self` by one.
+ *
+ * If the resulting reference count is zero, frees the memory of
+ * `self`.
+ */
+void
+icu_case_map_unref (IcuCaseMap *self)
+{
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (self->ref_count >= 1);
+
+  if (g_atomic_int_dec_and_test (&self->ref_count))
+    icu_case_map_free (self);
+}
+
+/**
+ * icu_case_map_map_to_buffer:
+ * @self: A [class@CaseMap].
+ * @mapping: The case mapping to apply.
+ * @src: The UTF-8 string to map.
+ * @src_length: The length of `src` in bytes, or -1 if it is
+ *   nul-terminated.
+ * @dest: (array length=dest_capacity) (out caller-allocates) (nullable):
+ *   The buffer to write the result to.
+ * @dest_capacity: The size of `dest` in bytes.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Maps `src` into the caller-provided `dest` buffer.
+ *
+ * The result is not nul-terminated. Pass `NULL` and zero as `dest`
+ * and `dest_capacity` to only compute the length of the result.
+ *
+ * Returns: The length of the result in bytes, or -1 if `error` is
+ *   set. If it is greater than `dest_capacity`, the contents of
+ *   `dest` are undefined and the call should be repeated with a
+ *   buffer at least this large.
+ */
+gssize
+icu_case_map_map_to_buffer (IcuCaseMap      *self,
+                            IcuCaseMapping   mapping,
+                            const gchar     *src,
+                            gssize           src_length,
+                            gchar           *dest,
+                            gsize            dest_capacity,
+                            GError         **error)
+{
+  gint32 length = 0;
+  UErrorCode ec = U_ZERO_ERROR;
+
+  g_return_val_if_fail (self != NULL, -1);
+  g_return_val_if_fail (self->ref_count >= 1, -1);
+  g_return_val_if_fail (src != NULL || src_length == 0, -1);
+  g_return_val_if_fail (dest != NULL || dest_capacity == 0, -1);
+
+  if (src_length < 0)
+    src_length = strlen (src);
+
+  if (src_length > G_MAXINT32)
+    {
+      icu_has_failed (U_INPUT_TOO_LONG_ERROR, error);
+      return -1;
+    }
+
+  if (can_map_as_ascii (self, mapping, src, src_length))
+    {
+      if ((gsize) src_length <= dest_capacity)
+        map_ascii (mapping, src, src_length, dest);
+
+      return src_length;
+    }
+
+  length = map_utf8 (self, mapping, src, src_length, dest, MIN (dest_capacity, G_MAXINT32), &ec);
+  if (ec == U_BUFFER_OVERFLOW_ERROR)
+    ec = U_ZERO_ERROR;
+
+  if (icu_has_failed (ec, error))
+    return -1;
+
+  return length;
+}
+
+/**
+ * icu_case_map_append:
+ * @self: A [class@CaseMap].
+ * @mapping: The case mapping to apply.
+ * @src: The UTF-8 string to map.
+ * @src_length: The length of `src` in bytes, or -1 if it is
+ *   nul-terminated.
+ * @out: The string to append the result to.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Maps `src` and appends the result to `out`, growing it as needed.
+ *
+ * On failure, `out` is left unchanged.
+ *
+ * Returns: `TRUE` on success, `FALSE` if `error` is set.
+ */
+gboolean
+icu_case_map_append (IcuCaseMap      *self,
+                     IcuCaseMapping   mapping,
+                     const gchar     *src,
+                     gssize           src_length,
+                     GString         *out,
+                     GError         **error)
+{
+  gsize start = 0;
+  gint32 length = 0;
+  UErrorCode ec = U_ZERO_ERROR;
+
+  g_return_val_if_fail (self != NULL, FALSE);
+  g_return_val_if_fail (self->ref_count >= 1, FALSE);
+  g_return_val_if_fail (src != NULL || src_length == 0, FALSE);
+  g_return_val_if_fail (out != NULL, FALSE);
+
+  if (src_length < 0)
+    src_length = strlen (src);
+
+  if (src_length > G_MAXINT32)
+    {
+      icu_has_failed (U_INPUT_TOO_LONG_ERROR, error);
+      return FALSE;
+    }
+
+  start = out->len;
+
+  // Most mappings preserve the length in bytes, so try with that
+  // first and only preflight when the result turns out longer.
+  g_string_set_size (out, start + src_length);
+
+  if (can_map_as_ascii (self, mapping, src, src_length))
+    {
+      map_ascii (mapping, src, src_length, out->str + start);
+      return TRUE;
+    }
+
+  length = map_utf8 (self, mapping, src, src_length, out->str + start, src_length, &ec);
+  if (ec == U_BUFFER_OVERFLOW_ERROR)
+    {
+      ec = U_ZERO_ERROR;
+      g_string_set_size (out, start + length);
+      length = map_utf8 (self, mapping, src, src_length, out->str + start, length, &ec);
+    }
+
+  if (icu_has_failed (ec, error))
+    {
+      g_string_truncate (out, start);
+      return FALSE;
+    }
+
+  g_string_set_size (out, start + length);
+
+  return TRUE;
+}
+
+/**
+ * icu_case_map_map:
+ * @self: A [class@CaseMap].
+ * @mapping: The case mapping to apply.
+ * @src: The UTF-8 string to map.
+ * @src_length: The length of `src` in bytes, or -1 if it is
+ *   nul-terminated.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Maps `src` into a newly allocated string.
+ *
+ * Returns: (transfer full): The mapped string, or `NULL` if `error`
+ *   is set.
+ */
+gchar *
+icu_case_map_map (IcuCaseMap      *self,
+                  IcuCaseMapping   mapping,
+                  const gchar     *src,
+                  gssize           src_length,
+                  GError         **error)
+{
+  g_autoptr (GString) out = NULL;
+
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+
+  out = g_string_new (NULL);
+
+  if (!icu_case_map_append (self, mapping, src, src_length, out, error))
+    return NULL;
+
+  return g_string_free (g_steal_pointer (&out), FALSE);
+}
+
+/**
+ * icu_case_map_map_batch: (skip)
+ * @self: A [class@CaseMap].
+ * @mapping: The case mapping to apply.
+ * @strings: The packed UTF-8 strings to map.
+ * @offsets: The `n_strings + 1` offsets
+ *   delimiting the strings: string `i` spans from `offsets[i]` up to
+ *   `offsets[i + 1]` in `strings`.
+ * @n_strings: The number of strings to map.
+ * @arena: The string to append all results to.
+ * @out_offsets: The return location for the `n_strings + 1` offsets delimiting each
+ *   result in `arena`.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Maps every string of a packed array, appending the results one
+ * after the other to `arena`.
+ *
+ * Results are not nul-terminated. On failure, `arena` is left
+ * unchanged.
+ *
+ * Returns: `TRUE` on success, `FALSE` if `error` is set.
+ */
+gboolean
+icu_case_map_map_batch (IcuCaseMap      *self,
+                        IcuCaseMapping   mapping,
+                        const gchar     *strings,
+                        const gsize     *offsets,
+                        gsize            n_strings,
+                        GString         *arena,
+                        gsize           *out_offsets,
+                        GError         **error)
+{
+  gsize start = 0;
+  gsize i = 0;
+
+  g_return_val_if_fail (self != NULL, FALSE);
+  g_return_val_if_fail (self->ref_count >= 1, FALSE);
+  g_return_val_if_fail (offsets != NULL, FALSE);
+  g_return_val_if_fail (strings != NULL || offsets[n_strings] == offsets[0], FALSE);
+  g_return_val_if_fail (arena != NULL, FALSE);
+  g_return_val_if_fail (out_offsets != NULL, FALSE);
+
+  start = arena->len;
+
+  // Reserve room for all the results up front
+  g_string_set_size (arena, start + (offsets[n_strings] - offsets[0]));
+  g_string_truncate (arena, start);
+
+  for (i = 0; i < n_strings; i++)
+    {
+      out_offsets[i] = arena->len;
+
+      if (!icu_case_map_append (self,
+                                mapping,
+                                strings + offsets[i],
+                                offsets[i + 1] - offsets[i],
+                                arena,
+                                error))
+        {
+          g_string_truncate (arena, start);
+          return FALSE;
+        }
+    }
+
+  out_offsets[n_strings] = arena->len;
+
+  return TRUE;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#pragma once
+
+#if !defined(_ICU_GOBJECT_INSIDE) && !defined(ICU_GOBJECT_COMPILATION)
+#  error "Only <icu-gobject.h> can be included directly"
+#endif
+
+#include <glib-object.h>
+#include "icu-version.h"
+
+G_BEGIN_DECLS
+
+typedef enum {
+  ICU_CASE_MAPPING_LOWER,
+  ICU_CASE_MAPPING_UPPER,
+  ICU_CASE_MAPPING_TITLE,
+  ICU_CASE_MAPPING_FOLD,
+} IcuCaseMapping;
+
+typedef enum {
+  ICU_CASE_MAP_OPTIONS_NONE                          = 0,
+  ICU_CASE_MAP_OPTIONS_FOLD_EXCLUDE_SPECIAL_I        = 1 << 0,
+  ICU_CASE_MAP_OPTIONS_TITLECASE_WHOLE_STRING        = 1 << 5,
+  ICU_CASE_MAP_OPTIONS_TITLECASE_SENTENCES           = 1 << 6,
+  ICU_CASE_MAP_OPTIONS_TITLECASE_NO_LOWERCASE        = 1 << 8,
+  ICU_CASE_MAP_OPTIONS_TITLECASE_NO_BREAK_ADJUSTMENT = 1 << 9,
+  ICU_CASE_MAP_OPTIONS_TITLECASE_ADJUST_TO_CASED     = 1 << 10,
+} IcuCaseMapOptions;
+
+#define ICU_TYPE_CASE_MAP (icu_case_map_get_type())
+
+typedef struct _IcuCaseMap IcuCaseMap;
+
+ICU_AVAILABLE_IN_ALL
+GType icu_case_map_get_type (void);
+
+ICU_AVAILABLE_IN_ALL
+IcuCaseMap *icu_case_map_new (const gchar        *locale,
+                              IcuCaseMapOptions   options,
+                              GError            **error);
+
+ICU_AVAILABLE_IN_ALL
+IcuCaseMap *icu_case_map_ref   (IcuCaseMap *self);
+ICU_AVAILABLE_IN_ALL
+void        icu_case_map_unref (IcuCaseMap *self);
+
+ICU_AVAILABLE_IN_ALL
+gssize   icu_case_map_map_to_buffer (IcuCaseMap      *self,
+                                     IcuCaseMapping   mapping,
+                                     const gchar     *src,
+                                     gssize           src_length,
+                                     gchar           *dest,
+                                     gsize            dest_capacity,
+                                     GError         **error);
+ICU_AVAILABLE_IN_ALL
+gboolean icu_case_map_append        (IcuCaseMap      *self,
+                                     IcuCaseMapping   mapping,
+                                     const gchar     *src,
+                                     gssize           src_length,
+                                     GString         *out,
+                                     GError         **error);
+ICU_AVAILABLE_IN_ALL
+gchar   *icu_case_map_map           (IcuCaseMap      *self,
+                                     IcuCaseMapping   mapping,
+                                     const gchar     *src,
+                                     gssize           src_length,
+                                     GError         **error);
+
+ICU_AVAILABLE_IN_ALL
+gboolean icu_case_map_map_batch (IcuCaseMap      *self,
+                                 IcuCaseMapping   mapping,
+                                 const gchar     *strings,
+                                 const gsize     *offsets,
+                                 gsize            n_strings,
+                                 GString         *arena,
+                                 gsize           *out_offsets,
+                                 GError         **error);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (IcuCaseMap, icu_case_map_unref)
+
+G_END_DECLS
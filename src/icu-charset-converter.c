@@ -0,0 +1,651 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "icu-charset-converter.h"
+
+#include <unicode/ucnv.h>
+#include <unicode/ucnv_err.h>
+#include "icu-enum-types.h"
+#include "icu-error-private.h"
+
+/**
+ * IcuCharsetConverter:
+ *
+ * A [iface@Gio.Converter] that converts between character sets
+ * using the ICU converters.
+ *
+ * It is a drop-in replacement for [class@Gio.CharsetConverter] that
+ * can be used with [class@Gio.ConverterInputStream] and
+ * [class@Gio.ConverterOutputStream].
+ *
+ * Text is converted through an internal UTF-16 pivot buffer whose
+ * size can be chosen at construction time: a larger pivot means
+ * fewer round trips between the two ICU converters per chunk.
+ *
+ * The underlying ICU converters are recycled: when a
+ * [class@CharsetConverter] is finalized, its converters are reset
+ * and kept around to be reused by the next one created for the same
+ * character sets.
+ */
+
+#define DEFAULT_PIVOT_SIZE 16384
+#define MIN_PIVOT_SIZE 64
+#define MAX_PIVOT_SIZE (16 * 1024 * 1024)
+
+#define MAX_IDLE_CONVERTERS_PER_CHARSET 8
+
+struct _IcuCharsetConverter
+{
+  GObject parent_instance;
+
+  gchar *from_charset;
+  gchar *to_charset;
+  IcuCharsetConverterErrorAction error_action;
+  guint pivot_size;
+
+  gchar *from_key;
+  gchar *to_key;
+  UConverter *from_ucnv;
+  UConverter *to_ucnv;
+
+  UChar *pivot;
+  UChar *pivot_source;
+  UChar *pivot_target;
+
+  // A conversion error found after some output was already
+  // produced, to be reported by the next call to convert().
+  UErrorCode pending_error;
+  gboolean pending_error_in_source;
+};
+
+static void icu_charset_converter_converter_iface_init (GConverterIface *iface);
+static void icu_charset_converter_initable_iface_init  (GInitableIface  *iface);
+
+G_DEFINE_TYPE_WITH_CODE (IcuCharsetConverter, icu_charset_converter, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (G_TYPE_CONVERTER, icu_charset_converter_converter_iface_init)
+                         G_IMPLEMENT_INTERFACE (G_TYPE_INITABLE, icu_charset_converter_initable_iface_init))
+
+enum {
+  PROP_0,
+  PROP_FROM_CHARSET,
+  PROP_TO_CHARSET,
+  PROP_ERROR_ACTION,
+  PROP_PIVOT_SIZE,
+  N_PROPS
+};
+
+static GParamSpec *properties [N_PROPS];
+
+G_LOCK_DEFINE_STATIC (idle_converters);
+static GHashTable *idle_converters = NULL;
+
+static gchar *
+get_converter_key (const gchar *charset)
+{
+  const gchar *name = NULL;
+  UErrorCode ec = U_ZERO_ERROR;
+
+  // Alias zero is the canonical name of the converter, so that
+  // e.g. "SJIS" and "Shift_JIS" share the same idle converters.
+  name = ucnv_getAlias (charset, 0, &ec);
+  if (U_FAILURE (ec) || name == NULL)
+    name = charset;
+
+  return g_ascii_strdown (name, -1);
+}
+
+static void
+set_error_action (UConverter                     *ucnv,
+                  IcuCharsetConverterErrorAction  error_action,
+                  UErrorCode                     *ec)
+{
+  UConverterToUCallback to_u_action = NULL;
+  UConverterFromUCallback from_u_action = NULL;
+  UConverterToUCallback old_to_u_action = NULL;
+  UConverterFromUCallback old_from_u_action = NULL;
+  const void *old_context = NULL;
+
+  switch (error_action)
+    {
+    case ICU_CHARSET_CONVERTER_ERROR_ACTION_SKIP:
+      to_u_action = UCNV_TO_U_CALLBACK_SKIP;
+      from_u_action = UCNV_FROM_U_CALLBACK_SKIP;
+      break;
+
+    case ICU_CHARSET_CONVERTER_ERROR_ACTION_STOP:
+      to_u_action = UCNV_TO_U_CALLBACK_STOP;
+      from_u_action = UCNV_FROM_U_CALLBACK_STOP;
+      break;
+
+    case ICU_CHARSET_CONVERTER_ERROR_ACTION_SUBSTITUTE:
+    default:
+      to_u_action = UCNV_TO_U_CALLBACK_SUBSTITUTE;
+      from_u_action = UCNV_FROM_U_CALLBACK_SUBSTITUTE;
+      break;
+    }
+
+  ucnv_setToUCallBack (ucnv, to_u_action, NULL, &old_to_u_action, &old_context, ec);
+  ucnv_setFromUCallBack (ucnv, from_u_action, NULL, &old_from_u_action, &old_context, ec);
+}
+
+static UConverter *
+acquire_converter (const gchar *key,
+                   const gchar *charset,
+                   UErrorCode  *ec)
+{
+  UConverter *ucnv = NULL;
+  GPtrArray *idle = NULL;
+
+  G_LOCK (idle_converters);
+
+  if (idle_converters != NULL)
+    idle = g_hash_table_lookup (idle_converters, key);
+
+  if (idle != NULL && idle->len > 0)
+    ucnv = g_ptr_array_steal_index_fast (idle, idle->len - 1);
+
+  G_UNLOCK (idle_converters);
+
+  if (ucnv == NULL)
+    ucnv = ucnv_open (charset, ec);
+
+  return ucnv;
+}
+
+static void
+release_converter (const gchar *key,
+                   UConverter  *ucnv)
+{
+  GPtrArray *idle = NULL;
+  UErrorCode ec = U_ZERO_ERROR;
+
+  ucnv_reset (ucnv);
+
+  set_error_action (ucnv, ICU_CHARSET_CONVERTER_ERROR_ACTION_SUBSTITUTE, &ec);
+  if (U_FAILURE (ec))
+    {
+      ucnv_close (ucnv);
+      return;
+    }
+
+  G_LOCK (idle_converters);
+
+  if (idle_converters == NULL)
+    idle_converters = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_ptr_array_unref);
+
+  idle = g_hash_table_lookup (idle_converters, key);
+  if (idle == NULL)
+    {
+      idle = g_ptr_array_new_with_free_func ((GDestroyNotify) ucnv_close);
+      g_hash_table_insert (idle_converters, g_strdup (key), idle);
+    }
+
+  if (idle->len < MAX_IDLE_CONVERTERS_PER_CHARSET)
+    g_ptr_array_add (idle, g_steal_pointer (&ucnv));
+
+  G_UNLOCK (idle_converters);
+
+  g_clear_pointer (&ucnv, ucnv_close);
+}
+
+static gboolean
+is_conversion_error (UErrorCode ec)
+{
+  return ec == U_INVALID_CHAR_FOUND ||
+         ec == U_ILLEGAL_CHAR_FOUND ||
+         ec == U_TRUNCATED_CHAR_FOUND ||
+         ec == U_ILLEGAL_ESCAPE_SEQUENCE ||
+         ec == U_UNSUPPORTED_ESCAPE_SEQUENCE;
+}
+
+static void
+set_conversion_error (IcuCharsetConverter  *self,
+                      UErrorCode            ec,
+                      gboolean              in_source,
+                      GError              **error)
+{
+  if (!in_source)
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+                   "Character cannot be represented in %s",
+                   self->to_charset);
+      return;
+    }
+
+  if (ec == U_TRUNCATED_CHAR_FOUND)
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_PARTIAL_INPUT,
+                   "Incomplete %s sequence at the end of the input",
+                   self->from_charset);
+      return;
+    }
+
+  g_set_error (error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA,
+               "Invalid or unmappable byte sequence in %s input",
+               self->from_charset);
+}
+
+static GConverterResult
+icu_charset_converter_convert (GConverter       *converter,
+                               const void       *inbuf,
+                               gsize             inbuf_size,
+                               void             *outbuf,
+                               gsize             outbuf_size,
+                               GConverterFlags   flags,
+                               gsize            *bytes_read,
+                               gsize            *bytes_written,
+                               GError          **error)
+{
+  IcuCharsetConverter *self = ICU_CHARSET_CONVERTER (converter);
+  const gchar *source = inbuf;
+  gchar *target = outbuf;
+  gboolean flush = FALSE;
+  UErrorCode ec = U_ZERO_ERROR;
+
+  g_return_val_if_fail (self->from_ucnv != NULL, G_CONVERTER_ERROR);
+  g_return_val_if_fail (self->to_ucnv != NULL, G_CONVERTER_ERROR);
+
+  *bytes_read = 0;
+  *bytes_written = 0;
+
+  if (self->pending_error != U_ZERO_ERROR)
+    {
+      set_conversion_error (self, self->pending_error, self->pending_error_in_source, error);
+      self->pending_error = U_ZERO_ERROR;
+      return G_CONVERTER_ERROR;
+    }
+
+  flush = (flags & (G_CONVERTER_INPUT_AT_END | G_CONVERTER_FLUSH)) != 0;
+
+  ucnv_convertEx (self->to_ucnv,
+                  self->from_ucnv,
+                  &target,
+                  target + outbuf_size,
+                  &source,
+                  source + inbuf_size,
+                  self->pivot,
+                  &self->pivot_source,
+                  &self->pivot_target,
+                  self->pivot + self->pivot_size,
+                  FALSE,
+                  flush,
+                  &ec);
+
+  *bytes_read = source - (const gchar *) inbuf;
+  *bytes_written = target - (gchar *) outbuf;
+
+  if (ec == U_BUFFER_OVERFLOW_ERROR)
+    {
+      if (*bytes_written > 0)
+        return G_CONVERTER_CONVERTED;
+
+      g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_NO_SPACE,
+                           "Not enough space in destination");
+      return G_CONVERTER_ERROR;
+    }
+
+  if (is_conversion_error (ec))
+    {
+      // An empty pivot means the source converter hit the error
+      gboolean in_source = self->pivot_source == self->pivot_target;
+
+      // Don't lose what was converted before the faulty sequence
+      if (*bytes_written > 0)
+        {
+          self->pending_error = ec;
+          self->pending_error_in_source = in_source;
+          return G_CONVERTER_CONVERTED;
+        }
+
+      set_conversion_error (self, ec, in_source, error);
+      return G_CONVERTER_ERROR;
+    }
+
+  if (icu_has_failed (ec, error))
+    return G_CONVERTER_ERROR;
+
+  if (flags & G_CONVERTER_INPUT_AT_END)
+    return G_CONVERTER_FINISHED;
+
+  if (flags & G_CONVERTER_FLUSH)
+    return G_CONVERTER_FLUSHED;
+
+  return G_CONVERTER_CONVERTED;
+}
+
+static void
+icu_charset_converter_reset (GConverter *converter)
+{
+  IcuCharsetConverter *self = ICU_CHARSET_CONVERTER (converter);
+
+  if (self->from_ucnv != NULL)
+    ucnv_reset (self->from_ucnv);
+
+  if (self->to_ucnv != NULL)
+    ucnv_reset (self->to_ucnv);
+
+  self->pivot_source = self->pivot;
+  self->pivot_target = self->pivot;
+  self->pending_error = U_ZERO_ERROR;
+}
+
+static void
+icu_charset_converter_converter_iface_init (GConverterIface *iface)
+{
+  iface->convert = icu_charset_converter_convert;
+  iface->reset = icu_charset_converter_reset;
+}
+
+static gboolean
+icu_charset_converter_initable_init (GInitable     *initable,
+                                     GCancellable  *cancellable,
+                                     GError       **error)
+{
+  IcuCharsetConverter *self = ICU_CHARSET_CONVERTER (initable);
+  UErrorCode ec = U_ZERO_ERROR;
+
+  g_return_val_if_fail (self->from_charset != NULL, FALSE);
+  g_return_val_if_fail (self->to_charset != NULL, FALSE);
+
+  if (self->from_ucnv != NULL)
+    return TRUE;
+
+  self->from_key = get_converter_key (self->from_charset);
+  self->to_key = get_converter_key (self->to_charset);
+
+  self->from_ucnv = acquire_converter (self->from_key, self->from_charset, &ec);
+  if (icu_has_failed (ec, error))
+    return FALSE;
+
+  self->to_ucnv = acquire_converter (self->to_key, self->to_charset, &ec);
+  if (icu_has_failed (ec, error))
+    return FALSE;
+
+  set_error_action (self->from_ucnv, self->error_action, &ec);
+  set_error_action (self->to_ucnv, self->error_action, &ec);
+  if (icu_has_failed (ec, error))
+    return FALSE;
+
+  self->pivot = g_new (UChar, self->pivot_size);
+  self->pivot_source = self->pivot;
+  self->pivot_target = self->pivot;
+
+  return TRUE;
+}
+
+static void
+icu_charset_converter_initable_iface_init (GInitableIface *iface)
+{
+  iface->init = icu_charset_converter_initable_init;
+}
+
+static void
+icu_charset_converter_finalize (GObject *object)
+{
+  IcuCharsetConverter *self = ICU_CHARSET_CONVERTER (object);
+
+  if (self->from_ucnv != NULL)
+    release_converter (self->from_key, g_steal_pointer (&self->from_ucnv));
+
+  if (self->to_ucnv != NULL)
+    release_converter (self->to_key, g_steal_pointer (&self->to_ucnv));
+
+  g_clear_pointer (&self->from_charset, g_free);
+  g_clear_pointer (&self->to_charset, g_free);
+  g_clear_pointer (&self->from_key, g_free);
+  g_clear_pointer (&self->to_key, g_free);
+  g_clear_pointer (&self->pivot, g_free);
+
+  G_OBJECT_CLASS (icu_charset_converter_parent_class)->finalize (object);
+}
+
+static void
+icu_charset_converter_get_property (GObject    *object,
+                                    guint       prop_id,
+                                    GValue     *value,
+                                    GParamSpec *pspec)
+{
+  IcuCharsetConverter *self = ICU_CHARSET_CONVERTER (object);
+
+  switch (prop_id)
+    {
+    case PROP_FROM_CHARSET:
+      g_value_set_string (value, self->from_charset);
+      break;
+
+    case PROP_TO_CHARSET:
+      g_value_set_string (value, self->to_charset);
+      break;
+
+    case PROP_ERROR_ACTION:
+      g_value_set_enum (value, self->error_action);
+      break;
+
+    case PROP_PIVOT_SIZE:
+      g_value_set_uint (value, self->pivot_size);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+static void
+icu_charset_converter_set_property (GObject      *object,
+                                    guint         prop_id,
+                                    const GValue *value,
+                                    GParamSpec   *pspec)
+{
+  IcuCharsetConverter *self = ICU_CHARSET_CONVERTER (object);
+
+  switch (prop_id)
+    {
+    case PROP_FROM_CHARSET:
+      self->from_charset = g_value_dup_string (value);
+      break;
+
+    case PROP_TO_CHARSET:
+      self->to_charset = g_value_dup_string (value);
+      break;
+
+    case PROP_ERROR_ACTION:
+      self->error_action = g_value_get_enum (value);
+      break;
+
+    case PROP_PIVOT_SIZE:
+      self->pivot_size = g_value_get_uint (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+static void
+icu_charset_converter_class_init (IcuCharsetConverterClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = icu_charset_converter_finalize;
+  object_class->get_property = icu_charset_converter_get_property;
+  object_class->set_property = icu_charset_converter_set_property;
+
+  /**
+   * IcuCharsetConverter:from-charset:
+   *
+   * The character set to convert from.
+   */
+  properties [PROP_FROM_CHARSET] =
+    g_param_spec_string ("from-charset", NULL, NULL,
+                         NULL,
+                         (G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * IcuCharsetConverter:to-charset:
+   *
+   * The character set to convert to.
+   */
+  properties [PROP_TO_CHARSET] =
+    g_param_spec_string ("to-charset", NULL, NULL,
+                         NULL,
+                         (G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * IcuCharsetConverter:error-action:
+   *
+   * What to do with input that is invalid in the source character
+   * set or cannot be represented in the target one.
+   *
+   * When set to [enum@CharsetConverterErrorAction.STOP], such input
+   * makes the conversion fail with [error@Gio.IOErrorEnum.INVALID_DATA],
+   * or [error@Gio.IOErrorEnum.PARTIAL_INPUT] if the input ends in the
+   * middle of a character.
+   */
+  properties [PROP_ERROR_ACTION] =
+    g_param_spec_enum ("error-action", NULL, NULL,
+                       ICU_TYPE_CHARSET_CONVERTER_ERROR_ACTION,
+                       ICU_CHARSET_CONVERTER_ERROR_ACTION_SUBSTITUTE,
+                       (G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * IcuCharsetConverter:pivot-size:
+   *
+   * The size, in UTF-16 code units, of the internal pivot buffer.
+   */
+  properties [PROP_PIVOT_SIZE] =
+    g_param_spec_uint ("pivot-size", NULL, NULL,
+                       MIN_PIVOT_SIZE, MAX_PIVOT_SIZE, DEFAULT_PIVOT_SIZE,
+                       (G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_properties (object_class, N_PROPS, properties);
+}
+
+static void
+icu_charset_converter_init (IcuCharsetConverter *self)
+{
+  self->pivot_size = DEFAULT_PIVOT_SIZE;
+}
+
+/**
+ * icu_charset_converter_new:
+ * @to_charset: The character set to convert to.
+ * @from_charset: The character set to convert from.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Creates a new [class@CharsetConverter] that substitutes invalid
+ * input and uses a default-sized pivot buffer.
+ *
+ * Returns: (transfer full): A newly created [class@CharsetConverter],
+ *   or `NULL` if either character set is not supported.
+ */
+IcuCharsetConverter *
+icu_charset_converter_new (const gchar  *to_charset,
+                           const gchar  *from_charset,
+                           GError      **error)
+{
+  return icu_charset_converter_new_full (to_charset,
+                                         from_charset,
+                                         ICU_CHARSET_CONVERTER_ERROR_ACTION_SUBSTITUTE,
+                                         DEFAULT_PIVOT_SIZE,
+                                         error);
+}
+
+/**
+ * icu_charset_converter_new_full:
+ * @to_charset: The character set to convert to.
+ * @from_charset: The character set to convert from.
+ * @error_action: What to do with invalid or unmappable input.
+ * @pivot_size: The size of the pivot buffer, in UTF-16 code units.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Creates a new [class@CharsetConverter].
+ *
+ * Returns: (transfer full): A newly created [class@CharsetConverter],
+ *   or `NULL` if either character set is not supported.
+ */
+IcuCharsetConverter *
+icu_charset_converter_new_full (const gchar                     *to_charset,
+                                const gchar                     *from_charset,
+                                IcuCharsetConverterErrorAction   error_action,
+                                guint                            pivot_size,
+                                GError                         **error)
+{
+  g_return_val_if_fail (to_charset != NULL, NULL);
+  g_return_val_if_fail (from_charset != NULL, NULL);
+
+  return g_initable_new (ICU_TYPE_CHARSET_CONVERTER, NULL, error,
+                         "to-charset", to_charset,
+                         "from-charset", from_charset,
+                         "error-action", error_action,
+                         "pivot-size", CLAMP (pivot_size, MIN_PIVOT_SIZE, MAX_PIVOT_SIZE),
+                         NULL);
+}
+
+/**
+ * icu_charset_converter_get_from_charset:
+ * @self: A [class@CharsetConverter].
+ *
+ * Gets the character set `self` converts from.
+ *
+ * Returns: The [property@CharsetConverter:from-charset] of `self`.
+ */
+const gchar *
+icu_charset_converter_get_from_charset (IcuCharsetConverter *self)
+{
+  g_return_val_if_fail (ICU_IS_CHARSET_CONVERTER (self), NULL);
+
+  return self->from_charset;
+}
+
+/**
+ * icu_charset_converter_get_to_charset:
+ * @self: A [class@CharsetConverter].
+ *
+ * Gets the character set `self` converts to.
+ *
+ * Returns: The [property@CharsetConverter:to-charset] of `self`.
+ */
+const gchar *
+icu_charset_converter_get_to_charset (IcuCharsetConverter *self)
+{
+  g_return_val_if_fail (ICU_IS_CHARSET_CONVERTER (self), NULL);
+
+  return self->to_charset;
+}
+
+/**
+ * icu_charset_converter_get_error_action:
+ * @self: A [class@CharsetConverter].
+ *
+ * Gets what `self` does with invalid or unmappable input.
+ *
+ * Returns: The [property@CharsetConverter:error-action] of `self`.
+ */
+IcuCharsetConverterErrorAction
+icu_charset_converter_get_error_action (IcuCharsetConverter *self)
+{
+  g_return_val_if_fail (ICU_IS_CHARSET_CONVERTER (self), ICU_CHARSET_CONVERTER_ERROR_ACTION_SUBSTITUTE);
+
+  return self->error_action;
+}
+
+/**
+ * icu_charset_converter_get_pivot_size:
+ * @self: A [class@CharsetConverter].
+ *
+ * Gets the size of the pivot buffer of `self`.
+ *
+ * Returns: The [property@CharsetConverter:pivot-size] of `self`.
+ */
+guint
+icu_charset_converter_get_pivot_size (IcuCharsetConverter *self)
+{
+  g_return_val_if_fail (ICU_IS_CHARSET_CONVERTER (self), 0);
+
+  return self->pivot_size;
+}
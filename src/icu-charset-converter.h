@@ -0,0 +1,49 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#pragma once
+
+#if !defined(_ICU_GOBJECT_INSIDE) && !defined(ICU_GOBJECT_COMPILATION)
+#  error "Only <icu-gobject.h> can be included directly"
+#endif
+
+#include <gio/gio.h>
+#include "icu-version.h"
+
+G_BEGIN_DECLS
+
+typedef enum {
+  ICU_CHARSET_CONVERTER_ERROR_ACTION_SUBSTITUTE,
+  ICU_CHARSET_CONVERTER_ERROR_ACTION_SKIP,
+  ICU_CHARSET_CONVERTER_ERROR_ACTION_STOP,
+} IcuCharsetConverterErrorAction;
+
+#define ICU_TYPE_CHARSET_CONVERTER (icu_charset_converter_get_type())
+
+ICU_AVAILABLE_IN_ALL
+G_DECLARE_FINAL_TYPE (IcuCharsetConverter, icu_charset_converter, ICU, CHARSET_CONVERTER, GObject)
+
+ICU_AVAILABLE_IN_ALL
+IcuCharsetConverter *icu_charset_converter_new      (const gchar                     *to_charset,
+                                                     const gchar                     *from_charset,
+                                                     GError                         **error);
+ICU_AVAILABLE_IN_ALL
+IcuCharsetConverter *icu_charset_converter_new_full (const gchar                     *to_charset,
+                                                     const gchar                     *from_charset,
+                                                     IcuCharsetConverterErrorAction   error_action,
+                                                     guint                            pivot_size,
+                                                     GError                         **error);
+
+ICU_AVAILABLE_IN_ALL
+const gchar                    *icu_charset_converter_get_from_charset (IcuCharsetConverter *self);
+ICU_AVAILABLE_IN_ALL
+const gchar                    *icu_charset_converter_get_to_charset   (IcuCharsetConverter *self);
+ICU_AVAILABLE_IN_ALL
+IcuCharsetConverterErrorAction  icu_charset_converter_get_error_action (IcuCharsetConverter *self);
+ICU_AVAILABLE_IN_ALL
+guint                           icu_charset_converter_get_pivot_size   (IcuCharsetConverter *self);
+
+G_END_DECLS
@@ -14,4 +14,9 @@ G_BEGIN_DECLS
 G_GNUC_INTERNAL
 UConstrainedFieldPosition *icu_constrained_field_position_get_ucfpos (IcuConstrainedFieldPosition *self);
 
+G_GNUC_INTERNAL
+void icu_constrained_field_position_apply_constraint (IcuConstrainedFieldPosition *self,
+                                                      UConstrainedFieldPosition   *ucfpos,
+                                                      UErrorCode                  *ec);
+
 G_END_DECLS
@@ -24,10 +24,23 @@
  * 3. It is used for the newer [class@FormattedValue] APIs.
  */
 
+typedef enum
+{
+  CONSTRAINT_NONE,
+  CONSTRAINT_CATEGORY,
+  CONSTRAINT_FIELD,
+} Constraint;
+
 struct _IcuConstrainedFieldPosition
 {
   guint ref_count;
   UConstrainedFieldPosition *ucfpos;
+
+  // ICU has no way to read back the constraint, so it is kept here
+  // too, to apply it to other iterations.
+  Constraint constraint;
+  gint32 category;
+  gint32 field;
 };
 
 G_DEFINE_BOXED_TYPE (IcuConstrainedFieldPosition, icu_constrained_field_position, icu_constrained_field_position_ref, icu_constrained_field_position_unref)
@@ -133,6 +146,8 @@ icu_constrained_field_position_reset (IcuConstrainedFieldPosition  *self,
   ucfpos_reset (self->ucfpos, &ec);
   if (icu_has_failed (ec, error))
     return;
+
+  self->constraint = CONSTRAINT_NONE;
 }
 
 /**
@@ -181,6 +196,9 @@ icu_constrained_field_position_constrain_category (IcuConstrainedFieldPosition
   ucfpos_constrainCategory (self->ucfpos, category, &ec);
   if (icu_has_failed (ec, error))
     return;
+
+  self->constraint = CONSTRAINT_CATEGORY;
+  self->category = category;
 }
 
 /**
@@ -233,6 +251,10 @@ icu_constrained_field_position_constrain_field (IcuConstrainedFieldPosition  *se
   ucfpos_constrainField (self->ucfpos, category, field, &ec);
   if (icu_has_failed (ec, error))
     return;
+
+  self->constraint = CONSTRAINT_FIELD;
+  self->category = category;
+  self->field = field;
 }
 
 /**
@@ -466,3 +488,26 @@ icu_constrained_field_position_get_ucfpos (IcuConstrainedFieldPosition *self)
 {
   return self->ucfpos;
 }
+
+void
+icu_constrained_field_position_apply_constraint (IcuConstrainedFieldPosition *self,
+                                                 UConstrainedFieldPosition   *ucfpos,
+                                                 UErrorCode                  *ec)
+{
+  switch (self->constraint)
+    {
+    case CONSTRAINT_NONE:
+      break;
+
+    case CONSTRAINT_CATEGORY:
+      ucfpos_constrainCategory (ucfpos, self->category, ec);
+      break;
+
+    case CONSTRAINT_FIELD:
+      ucfpos_constrainField (ucfpos, self->category, self->field, ec);
+      break;
+
+    default:
+      g_assert_not_reached ();
+    }
+}
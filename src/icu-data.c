@@ -0,0 +1,166 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "icu-data.h"
+
+#include <string.h>
+#include <unicode/putil.h>
+#include <unicode/udata.h>
+#include <unicode/uversion.h>
+#include "icu-error-private.h"
+
+#ifdef G_OS_UNIX
+#  include <sys/mman.h>
+#endif
+
+// ICU reads the data in place for as long as the process lives, so
+// the files it accepted are never unmapped.
+G_LOCK_DEFINE_STATIC (mapped_files);
+static GSList *mapped_files = NULL;
+
+// Checks that the items in the table of contents of a common data
+// file are named after the package this ICU version looks up, as ICU
+// would otherwise ignore them all without reporting anything.
+static gboolean
+has_package_name (const gchar *contents,
+                  gsize        length)
+{
+  const gchar *prefix = U_ICUDATA_NAME "/";
+  guint16 header_size = 0;
+  guint32 n_items = 0;
+  guint32 name_offset = 0;
+
+  if (length < sizeof header_size)
+    return FALSE;
+
+  memcpy (&header_size, contents, sizeof header_size);
+
+  if (length < (gsize) header_size + 2 * sizeof n_items)
+    return FALSE;
+
+  memcpy (&n_items, contents + header_size, sizeof n_items);
+  if (n_items == 0)
+    return TRUE;
+
+  memcpy (&name_offset, contents + header_size + sizeof n_items, sizeof name_offset);
+
+  if (length - header_size < name_offset || length - header_size - name_offset < strlen (prefix))
+    return FALSE;
+
+  return strncmp (contents + header_size + name_offset, prefix, strlen (prefix)) == 0;
+}
+
+static void
+advise (gpointer      contents,
+        gsize         length,
+        IcuDataAdvice advice)
+{
+#if defined(G_OS_UNIX) && defined(MADV_RANDOM) && defined(MADV_WILLNEED)
+  switch (advice)
+    {
+    case ICU_DATA_ADVICE_RANDOM:
+      madvise (contents, length, MADV_RANDOM);
+      break;
+
+    case ICU_DATA_ADVICE_WILL_NEED:
+      madvise (contents, length, MADV_WILLNEED);
+      break;
+
+    case ICU_DATA_ADVICE_NORMAL:
+    default:
+      break;
+    }
+#endif
+}
+
+/**
+ * icu_data_set_path:
+ * @path: (type filename) (nullable): A list of directories to look
+ *   for ICU data files in, separated by the platform's path
+ *   separator.
+ *
+ * Sets the directories ICU loads its data files from.
+ *
+ * This only has an effect on items that are not part of the data
+ * linked into ICU or loaded with [func@data_load_mmap], and must be
+ * called before anything else in the process uses ICU.
+ */
+void
+icu_data_set_path (const gchar *path)
+{
+  u_setDataDirectory (path);
+}
+
+/**
+ * icu_data_load_mmap:
+ * @filename: (type filename): The path to an ICU common data file
+ *   (`.dat`).
+ * @advice: How the data is going to be accessed.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Maps `filename` into memory and makes ICU look for its data there
+ * before anywhere else.
+ *
+ * The file must have been built for the same ICU version and
+ * endianness the library is running with, e.g. `icudt72l.dat` for
+ * ICU 72 on a little-endian machine, and it might have been trimmed
+ * down to the locales and features an application needs, as
+ * described in the README. Data that is missing from it is still
+ * looked up in the data ICU was built with.
+ *
+ * Use [enum@DataAdvice.RANDOM] for large files, so the kernel does
+ * not read ahead the data of unrelated locales, and
+ * [enum@DataAdvice.WILL_NEED] for small trimmed files, so their pages
+ * are read in at load time rather than on first use.
+ *
+ * This must be called before anything else in the process uses ICU,
+ * and the file is kept mapped until the process exits.
+ *
+ * Returns: `TRUE` on success, `FALSE` if `error` is set.
+ */
+gboolean
+icu_data_load_mmap (const gchar    *filename,
+                    IcuDataAdvice   advice,
+                    GError        **error)
+{
+  g_autoptr (GMappedFile) file = NULL;
+  gchar *contents = NULL;
+  gsize length = 0;
+  UErrorCode ec = U_ZERO_ERROR;
+
+  g_return_val_if_fail (filename != NULL, FALSE);
+
+  file = g_mapped_file_new (filename, FALSE, error);
+  if (file == NULL)
+    return FALSE;
+
+  contents = g_mapped_file_get_contents (file);
+  length = g_mapped_file_get_length (file);
+
+  if (!has_package_name (contents, length))
+    {
+      icu_has_failed (U_INVALID_FORMAT_ERROR, error);
+      return FALSE;
+    }
+
+  advise (contents, length, advice);
+
+  udata_setCommonData (contents, &ec);
+  if (icu_has_failed (ec, error))
+    return FALSE;
+
+  // A warning means ICU already had this data, or no room for more,
+  // and did not keep a pointer to it.
+  if (ec == U_USING_DEFAULT_WARNING)
+    return TRUE;
+
+  G_LOCK (mapped_files);
+  mapped_files = g_slist_prepend (mapped_files, g_steal_pointer (&file));
+  G_UNLOCK (mapped_files);
+
+  return TRUE;
+}
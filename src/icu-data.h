@@ -0,0 +1,31 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#pragma once
+
+#if !defined(_ICU_GOBJECT_INSIDE) && !defined(ICU_GOBJECT_COMPILATION)
+#  error "Only <icu-gobject.h> can be included directly"
+#endif
+
+#include <glib.h>
+#include "icu-version.h"
+
+G_BEGIN_DECLS
+
+typedef enum {
+  ICU_DATA_ADVICE_NORMAL,
+  ICU_DATA_ADVICE_RANDOM,
+  ICU_DATA_ADVICE_WILL_NEED,
+} IcuDataAdvice;
+
+ICU_AVAILABLE_IN_ALL
+void     icu_data_set_path  (const gchar    *path);
+ICU_AVAILABLE_IN_ALL
+gboolean icu_data_load_mmap (const gchar    *filename,
+                             IcuDataAdvice   advice,
+                             GError        **error);
+
+G_END_DECLS
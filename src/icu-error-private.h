@@ -7,6 +7,7 @@
 #pragma once
 
 #include "icu-error.h"
+#include <unicode/parseerr.h>
 #include <unicode/utypes.h>
 
 G_BEGIN_DECLS
@@ -14,4 +15,7 @@ G_BEGIN_DECLS
 G_GNUC_INTERNAL
 gboolean icu_has_failed (UErrorCode ec, GError **error);
 
+G_GNUC_INTERNAL
+gboolean icu_has_failed_with_parse_error (UErrorCode ec, const UParseError *parse_error, GError **error);
+
 G_END_DECLS
@@ -230,3 +230,55 @@ icu_has_failed (UErrorCode   ec,
 
   return TRUE;
 }
+
+gboolean
+icu_has_failed_with_parse_error (UErrorCode          ec,
+                                 const UParseError  *parse_error,
+                                 GError            **error)
+{
+  g_autofree gchar *before = NULL;
+  g_autofree gchar *after = NULL;
+
+  if (U_SUCCESS (ec) || error == NULL)
+    return icu_has_failed (ec, error);
+
+  if (ec < U_FMT_PARSE_ERROR_START || ec >= U_FMT_PARSE_ERROR_LIMIT || parse_error->offset < 0)
+    return icu_has_failed (ec, error);
+
+  before = g_utf16_to_utf8 (parse_error->preContext, -1, NULL, NULL, NULL);
+  after = g_utf16_to_utf8 (parse_error->postContext, -1, NULL, NULL, NULL);
+
+  // The offset counts UTF-16 code units, as ICU works with UTF-16
+  // text internally.
+  g_set_error (error, ICU_FMT_PARSE_ERROR, ec, "%s at offset %d (after “%s”, before “%s”)",
+               get_fmt_parse_error_message (ec),
+               parse_error->offset,
+               before != NULL ? before : "",
+               after != NULL ? after : "");
+
+  return TRUE;
+}
+
+/**
+ * icu_status_get_message:
+ * @status: An [enum@Status].
+ *
+ * Gets the message an error with the same code as `status` would
+ * have.
+ *
+ * Returns: The message describing `status`, or an empty string for
+ *   [enum@Status.OK] and codes without one.
+ */
+const gchar *
+icu_status_get_message (IcuStatus status)
+{
+  UErrorCode ec = (UErrorCode) status;
+
+  if (ec > U_ZERO_ERROR && ec < U_STANDARD_ERROR_LIMIT)
+    return get_standard_error_message (ec);
+
+  if (ec >= U_FMT_PARSE_ERROR_START && ec < U_FMT_PARSE_ERROR_LIMIT)
+    return get_fmt_parse_error_message (ec);
+
+  return "";
+}
@@ -81,4 +81,62 @@ typedef enum {
   ICU_NUMBER_SKELETON_SYNTAX_ERROR,
 } IcuFmtParseError;
 
+typedef enum {
+  ICU_STATUS_OK                            = 0,
+  ICU_STATUS_ILLEGAL_ARGUMENT_ERROR        = 1,
+  ICU_STATUS_MISSING_RESOURCE_ERROR        = 2,
+  ICU_STATUS_INVALID_FORMAT_ERROR          = 3,
+  ICU_STATUS_FILE_ACCESS_ERROR             = 4,
+  ICU_STATUS_INTERNAL_PROGRAM_ERROR        = 5,
+  ICU_STATUS_MESSAGE_PARSE_ERROR           = 6,
+  ICU_STATUS_MEMORY_ALLOCATION_ERROR       = 7,
+  ICU_STATUS_INDEX_OUTOFBOUNDS_ERROR       = 8,
+  ICU_STATUS_PARSE_ERROR                   = 9,
+  ICU_STATUS_INVALID_CHAR_FOUND            = 10,
+  ICU_STATUS_TRUNCATED_CHAR_FOUND          = 11,
+  ICU_STATUS_ILLEGAL_CHAR_FOUND            = 12,
+  ICU_STATUS_INVALID_TABLE_FORMAT          = 13,
+  ICU_STATUS_INVALID_TABLE_FILE            = 14,
+  ICU_STATUS_BUFFER_OVERFLOW_ERROR         = 15,
+  ICU_STATUS_UNSUPPORTED_ERROR             = 16,
+  ICU_STATUS_RESOURCE_TYPE_MISMATCH        = 17,
+  ICU_STATUS_ILLEGAL_ESCAPE_SEQUENCE       = 18,
+  ICU_STATUS_UNSUPPORTED_ESCAPE_SEQUENCE   = 19,
+  ICU_STATUS_NO_SPACE_AVAILABLE            = 20,
+  ICU_STATUS_CE_NOT_FOUND_ERROR            = 21,
+  ICU_STATUS_PRIMARY_TOO_LONG_ERROR        = 22,
+  ICU_STATUS_STATE_TOO_OLD_ERROR           = 23,
+  ICU_STATUS_TOO_MANY_ALIASES_ERROR        = 24,
+  ICU_STATUS_ENUM_OUT_OF_SYNC_ERROR        = 25,
+  ICU_STATUS_INVARIANT_CONVERSION_ERROR    = 26,
+  ICU_STATUS_INVALID_STATE_ERROR           = 27,
+  ICU_STATUS_COLLATOR_VERSION_MISMATCH     = 28,
+  ICU_STATUS_USELESS_COLLATOR_ERROR        = 29,
+  ICU_STATUS_NO_WRITE_PERMISSION           = 30,
+  ICU_STATUS_INPUT_TOO_LONG_ERROR          = 31,
+  ICU_STATUS_UNEXPECTED_TOKEN              = 0x10100,
+  ICU_STATUS_MULTIPLE_DECIMAL_SEPARATORS   = 0x10101,
+  ICU_STATUS_MULTIPLE_EXPONENTIAL_SYMBOLS  = 0x10102,
+  ICU_STATUS_MALFORMED_EXPONENTIAL_PATTERN = 0x10103,
+  ICU_STATUS_MULTIPLE_PERCENT_SYMBOLS      = 0x10104,
+  ICU_STATUS_MULTIPLE_PERMILL_SYMBOLS      = 0x10105,
+  ICU_STATUS_MULTIPLE_PAD_SPECIFIERS       = 0x10106,
+  ICU_STATUS_PATTERN_SYNTAX_ERROR          = 0x10107,
+  ICU_STATUS_ILLEGAL_PAD_POSITION          = 0x10108,
+  ICU_STATUS_UNMATCHED_BRACES              = 0x10109,
+  ICU_STATUS_UNSUPPORTED_PROPERTY          = 0x1010a,
+  ICU_STATUS_UNSUPPORTED_ATTRIBUTE         = 0x1010b,
+  ICU_STATUS_ARGUMENT_TYPE_MISMATCH        = 0x1010c,
+  ICU_STATUS_DUPLICATE_KEYWORD             = 0x1010d,
+  ICU_STATUS_UNDEFINED_KEYWORD             = 0x1010e,
+  ICU_STATUS_DEFAULT_KEYWORD_MISSING       = 0x1010f,
+  ICU_STATUS_DECIMAL_NUMBER_SYNTAX_ERROR   = 0x10110,
+  ICU_STATUS_FORMAT_INEXACT_ERROR          = 0x10111,
+  ICU_STATUS_NUMBER_ARG_OUTOFBOUNDS_ERROR  = 0x10112,
+  ICU_STATUS_NUMBER_SKELETON_SYNTAX_ERROR  = 0x10113,
+} IcuStatus;
+
+ICU_AVAILABLE_IN_ALL
+const gchar *icu_status_get_message (IcuStatus status);
+
 G_END_DECLS
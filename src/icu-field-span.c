@@ -0,0 +1,43 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "icu-field-span.h"
+
+#include <string.h>
+
+/**
+ * IcuFieldSpan:
+ * @category: The category of the field.
+ * @field: The field.
+ * @begin_index: The start of the text range containing field.
+ * @end_index: The limit of the text range containing field.
+ *
+ * A struct representing a range of text containing a specific field
+ * of a given category, as collected by
+ * [method@FormattedValue.collect_positions].
+ */
+
+G_DEFINE_BOXED_TYPE (IcuFieldSpan, icu_field_span, icu_field_span_copy, icu_field_span_free)
+
+IcuFieldSpan *
+icu_field_span_copy (const IcuFieldSpan *self)
+{
+  IcuFieldSpan *copy = NULL;
+
+  g_return_val_if_fail (self != NULL, NULL);
+
+  copy = g_new0 (IcuFieldSpan, 1);
+  memcpy (copy, self, sizeof (IcuFieldSpan));
+
+  return copy;
+}
+
+void
+icu_field_span_free (IcuFieldSpan *self)
+{
+  g_return_if_fail (self != NULL);
+  g_free (self);
+}
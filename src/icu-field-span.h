@@ -0,0 +1,36 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#pragma once
+
+#if !defined(_ICU_GOBJECT_INSIDE) && !defined(ICU_GOBJECT_COMPILATION)
+#  error "Only <icu-gobject.h> can be included directly"
+#endif
+
+#include <glib-object.h>
+#include "icu-version.h"
+
+G_BEGIN_DECLS
+
+#define ICU_TYPE_FIELD_SPAN (icu_field_span_get_type())
+
+typedef struct _IcuFieldSpan
+{
+  gint32 category;
+  gint32 field;
+  gint32 begin_index;
+  gint32 end_index;
+} IcuFieldSpan;
+
+ICU_AVAILABLE_IN_ALL
+GType icu_field_span_get_type (void);
+
+ICU_AVAILABLE_IN_ALL
+IcuFieldSpan *icu_field_span_copy (const IcuFieldSpan *self);
+ICU_AVAILABLE_IN_ALL
+void          icu_field_span_free (IcuFieldSpan *self);
+
+G_END_DECLS
@@ -0,0 +1,507 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "icu-formatted-number-list-model.h"
+
+#include <string.h>
+
+// The number of items kept around, which is more than the rows of
+// any view, so scrolling back and forth does not format them again.
+#define CACHE_SIZE 512
+
+/**
+ * IcuFormattedNumberItem:
+ *
+ * An item of an [class@FormattedNumberListModel], holding the
+ * formatted number at a position.
+ */
+
+struct _IcuFormattedNumberItem
+{
+  GObject parent_instance;
+
+  guint position;
+  gchar *string;
+};
+
+G_DEFINE_TYPE (IcuFormattedNumberItem, icu_formatted_number_item, G_TYPE_OBJECT)
+
+enum {
+  ITEM_PROP_0,
+  ITEM_PROP_POSITION,
+  ITEM_PROP_STRING,
+  N_ITEM_PROPS
+};
+
+static GParamSpec *item_properties [N_ITEM_PROPS];
+
+static void
+icu_formatted_number_item_finalize (GObject *object)
+{
+  IcuFormattedNumberItem *self = ICU_FORMATTED_NUMBER_ITEM (object);
+
+  g_clear_pointer (&self->string, g_free);
+
+  G_OBJECT_CLASS (icu_formatted_number_item_parent_class)->finalize (object);
+}
+
+static void
+icu_formatted_number_item_get_property (GObject    *object,
+                                        guint       prop_id,
+                                        GValue     *value,
+                                        GParamSpec *pspec)
+{
+  IcuFormattedNumberItem *self = ICU_FORMATTED_NUMBER_ITEM (object);
+
+  switch (prop_id)
+    {
+    case ITEM_PROP_POSITION:
+      g_value_set_uint (value, self->position);
+      break;
+
+    case ITEM_PROP_STRING:
+      g_value_set_string (value, self->string);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+static void
+icu_formatted_number_item_class_init (IcuFormattedNumberItemClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = icu_formatted_number_item_finalize;
+  object_class->get_property = icu_formatted_number_item_get_property;
+
+  /**
+   * IcuFormattedNumberItem:position:
+   *
+   * The position of the number in the model.
+   */
+  item_properties [ITEM_PROP_POSITION] =
+    g_param_spec_uint ("position", NULL, NULL,
+                       0, G_MAXUINT, 0,
+                       (G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * IcuFormattedNumberItem:string:
+   *
+   * The formatted number.
+   */
+  item_properties [ITEM_PROP_STRING] =
+    g_param_spec_string ("string", NULL, NULL,
+                         NULL,
+                         (G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_properties (object_class, N_ITEM_PROPS, item_properties);
+}
+
+static void
+icu_formatted_number_item_init (IcuFormattedNumberItem *self)
+{
+}
+
+/**
+ * icu_formatted_number_item_get_position:
+ * @self: An [class@FormattedNumberItem].
+ *
+ * Gets the position of the number in the model `self` comes from.
+ *
+ * Returns: The [property@FormattedNumberItem:position] of `self`.
+ */
+guint
+icu_formatted_number_item_get_position (IcuFormattedNumberItem *self)
+{
+  g_return_val_if_fail (ICU_IS_FORMATTED_NUMBER_ITEM (self), 0);
+
+  return self->position;
+}
+
+/**
+ * icu_formatted_number_item_get_string:
+ * @self: An [class@FormattedNumberItem].
+ *
+ * Gets the formatted number, which is empty if it failed to format.
+ *
+ * Returns: The [property@FormattedNumberItem:string] of `self`.
+ */
+const gchar *
+icu_formatted_number_item_get_string (IcuFormattedNumberItem *self)
+{
+  g_return_val_if_fail (ICU_IS_FORMATTED_NUMBER_ITEM (self), NULL);
+
+  return self->string;
+}
+
+/**
+ * IcuFormattedNumberListModel:
+ *
+ * A [iface@Gio.ListModel] of formatted numbers.
+ *
+ * The model wraps an array of integers or doubles, without copying
+ * it, and only formats the numbers as their items are requested, so
+ * binding a view to a column of millions of numbers only formats the
+ * rows that are visible.
+ *
+ * The most recently requested items are cached, keyed by their
+ * position, so that a window of consecutive rows is never formatted
+ * twice while it stays in use. Replacing the formatter or the data
+ * drops the cache and reports every item as changed.
+ *
+ * Models created without a [property@FormattedNumberListModel:formatter],
+ * like those created by bindings or builders, have no items until
+ * they get one.
+ */
+
+struct _IcuFormattedNumberListModel
+{
+  GObject parent_instance;
+
+  IcuNumberFormatter *formatter;
+
+  GBytes *data;
+  gboolean is_double;
+  guint n_items;
+
+  // Items live in the slot of their position modulo CACHE_SIZE.
+  IcuFormattedNumberItem *cache[CACHE_SIZE];
+  GString *scratch;
+};
+
+static void icu_formatted_number_list_model_list_model_iface_init (GListModelInterface *iface);
+
+G_DEFINE_TYPE_WITH_CODE (IcuFormattedNumberListModel, icu_formatted_number_list_model, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL, icu_formatted_number_list_model_list_model_iface_init))
+
+enum {
+  PROP_0,
+  PROP_FORMATTER,
+  PROP_N_ITEMS,
+  N_PROPS
+};
+
+static GParamSpec *properties [N_PROPS];
+
+static void
+clear_cache (IcuFormattedNumberListModel *self)
+{
+  gsize i = 0;
+
+  for (i = 0; i < G_N_ELEMENTS (self->cache); i++)
+    g_clear_object (&self->cache[i]);
+}
+
+// Drops the cached items and reports every item as changed, after
+// the formatter or the data was replaced.
+static void
+reset_items (IcuFormattedNumberListModel *self)
+{
+  guint old_n_items = self->n_items;
+  gsize size = 0;
+
+  // Without a formatter, there is nothing to format the numbers with.
+  if (self->formatter != NULL && self->data != NULL)
+    size = g_bytes_get_size (self->data);
+
+  self->n_items = MIN (size / (self->is_double ? sizeof (gdouble) : sizeof (gint64)), G_MAXUINT);
+
+  clear_cache (self);
+
+  g_list_model_items_changed (G_LIST_MODEL (self), 0, old_n_items, self->n_items);
+
+  if (self->n_items != old_n_items)
+    g_object_notify_by_pspec (G_OBJECT (self), properties [PROP_N_ITEMS]);
+}
+
+static void
+set_data (IcuFormattedNumberListModel *self,
+          GBytes                      *data,
+          gboolean                     is_double)
+{
+  if (data != NULL)
+    g_bytes_ref (data);
+
+  g_clear_pointer (&self->data, g_bytes_unref);
+  self->data = data;
+  self->is_double = is_double;
+
+  reset_items (self);
+}
+
+static IcuFormattedNumberItem *
+format_item (IcuFormattedNumberListModel *self,
+             guint                        position)
+{
+  IcuFormattedNumberItem *item = NULL;
+  const guint8 *values = NULL;
+  gboolean formatted = FALSE;
+
+  values = g_bytes_get_data (self->data, NULL);
+  g_string_truncate (self->scratch, 0);
+
+  // The data may come from anywhere, like a file mapped at any
+  // offset, so values are copied out instead of assuming alignment.
+  if (self->is_double)
+    {
+      gdouble value = 0;
+
+      memcpy (&value, values + (gsize) position * sizeof value, sizeof value);
+      formatted = icu_number_formatter_append_double (self->formatter, value, self->scratch, NULL, NULL);
+    }
+  else
+    {
+      gint64 value = 0;
+
+      memcpy (&value, values + (gsize) position * sizeof value, sizeof value);
+      formatted = icu_number_formatter_append_int (self->formatter, value, self->scratch, NULL, NULL);
+    }
+
+  item = g_object_new (ICU_TYPE_FORMATTED_NUMBER_ITEM, NULL);
+  item->position = position;
+  item->string = g_strndup (self->scratch->str, formatted ? self->scratch->len : 0);
+
+  return item;
+}
+
+static GType
+icu_formatted_number_list_model_get_item_type (GListModel *list)
+{
+  return ICU_TYPE_FORMATTED_NUMBER_ITEM;
+}
+
+static guint
+icu_formatted_number_list_model_get_n_items (GListModel *list)
+{
+  IcuFormattedNumberListModel *self = ICU_FORMATTED_NUMBER_LIST_MODEL (list);
+
+  return self->n_items;
+}
+
+static gpointer
+icu_formatted_number_list_model_get_item (GListModel *list,
+                                          guint       position)
+{
+  IcuFormattedNumberListModel *self = ICU_FORMATTED_NUMBER_LIST_MODEL (list);
+  IcuFormattedNumberItem **slot = NULL;
+
+  if (position >= self->n_items)
+    return NULL;
+
+  slot = &self->cache[position % CACHE_SIZE];
+
+  if (*slot == NULL || (*slot)->position != position)
+    {
+      g_clear_object (slot);
+      *slot = format_item (self, position);
+    }
+
+  return g_object_ref (*slot);
+}
+
+static void
+icu_formatted_number_list_model_list_model_iface_init (GListModelInterface *iface)
+{
+  iface->get_item_type = icu_formatted_number_list_model_get_item_type;
+  iface->get_n_items = icu_formatted_number_list_model_get_n_items;
+  iface->get_item = icu_formatted_number_list_model_get_item;
+}
+
+static void
+icu_formatted_number_list_model_finalize (GObject *object)
+{
+  IcuFormattedNumberListModel *self = ICU_FORMATTED_NUMBER_LIST_MODEL (object);
+
+  clear_cache (self);
+
+  g_clear_pointer (&self->formatter, icu_number_formatter_unref);
+  g_clear_pointer (&self->data, g_bytes_unref);
+  g_string_free (g_steal_pointer (&self->scratch), TRUE);
+
+  G_OBJECT_CLASS (icu_formatted_number_list_model_parent_class)->finalize (object);
+}
+
+static void
+icu_formatted_number_list_model_get_property (GObject    *object,
+                                              guint       prop_id,
+                                              GValue     *value,
+                                              GParamSpec *pspec)
+{
+  IcuFormattedNumberListModel *self = ICU_FORMATTED_NUMBER_LIST_MODEL (object);
+
+  switch (prop_id)
+    {
+    case PROP_FORMATTER:
+      g_value_set_boxed (value, self->formatter);
+      break;
+
+    case PROP_N_ITEMS:
+      g_value_set_uint (value, self->n_items);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+static void
+icu_formatted_number_list_model_set_property (GObject      *object,
+                                              guint         prop_id,
+                                              const GValue *value,
+                                              GParamSpec   *pspec)
+{
+  IcuFormattedNumberListModel *self = ICU_FORMATTED_NUMBER_LIST_MODEL (object);
+
+  switch (prop_id)
+    {
+    case PROP_FORMATTER:
+      icu_formatted_number_list_model_set_formatter (self, g_value_get_boxed (value));
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+    }
+}
+
+static void
+icu_formatted_number_list_model_class_init (IcuFormattedNumberListModelClass *klass)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+  object_class->finalize = icu_formatted_number_list_model_finalize;
+  object_class->get_property = icu_formatted_number_list_model_get_property;
+  object_class->set_property = icu_formatted_number_list_model_set_property;
+
+  /**
+   * IcuFormattedNumberListModel:formatter:
+   *
+   * The formatter the numbers are formatted with.
+   */
+  properties [PROP_FORMATTER] =
+    g_param_spec_boxed ("formatter", NULL, NULL,
+                        ICU_TYPE_NUMBER_FORMATTER,
+                        (G_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY | G_PARAM_STATIC_STRINGS));
+
+  /**
+   * IcuFormattedNumberListModel:n-items:
+   *
+   * The number of items in the model.
+   */
+  properties [PROP_N_ITEMS] =
+    g_param_spec_uint ("n-items", NULL, NULL,
+                       0, G_MAXUINT, 0,
+                       (G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_properties (object_class, N_PROPS, properties);
+}
+
+static void
+icu_formatted_number_list_model_init (IcuFormattedNumberListModel *self)
+{
+  self->scratch = g_string_new (NULL);
+}
+
+/**
+ * icu_formatted_number_list_model_new:
+ * @formatter: The formatter to format the numbers with.
+ *
+ * Creates a new, empty [class@FormattedNumberListModel].
+ *
+ * Returns: (transfer full): A newly created
+ *   [class@FormattedNumberListModel].
+ */
+IcuFormattedNumberListModel *
+icu_formatted_number_list_model_new (IcuNumberFormatter *formatter)
+{
+  g_return_val_if_fail (formatter != NULL, NULL);
+
+  return g_object_new (ICU_TYPE_FORMATTED_NUMBER_LIST_MODEL,
+                       "formatter", formatter,
+                       NULL);
+}
+
+/**
+ * icu_formatted_number_list_model_get_formatter:
+ * @self: An [class@FormattedNumberListModel].
+ *
+ * Gets the formatter the numbers of `self` are formatted with.
+ *
+ * Returns: (transfer none): The
+ *   [property@FormattedNumberListModel:formatter] of `self`.
+ */
+IcuNumberFormatter *
+icu_formatted_number_list_model_get_formatter (IcuFormattedNumberListModel *self)
+{
+  g_return_val_if_fail (ICU_IS_FORMATTED_NUMBER_LIST_MODEL (self), NULL);
+
+  return self->formatter;
+}
+
+/**
+ * icu_formatted_number_list_model_set_formatter:
+ * @self: An [class@FormattedNumberListModel].
+ * @formatter: The formatter to format the numbers with.
+ *
+ * Replaces the formatter of `self`, which reports every item as
+ * changed, so that views format the visible ones again.
+ */
+void
+icu_formatted_number_list_model_set_formatter (IcuFormattedNumberListModel *self,
+                                               IcuNumberFormatter          *formatter)
+{
+  g_return_if_fail (ICU_IS_FORMATTED_NUMBER_LIST_MODEL (self));
+  g_return_if_fail (formatter != NULL);
+
+  if (self->formatter == formatter)
+    return;
+
+  g_clear_pointer (&self->formatter, icu_number_formatter_unref);
+  self->formatter = icu_number_formatter_ref (formatter);
+
+  reset_items (self);
+
+  g_object_notify_by_pspec (G_OBJECT (self), properties [PROP_FORMATTER]);
+}
+
+/**
+ * icu_formatted_number_list_model_set_int_data:
+ * @self: An [class@FormattedNumberListModel].
+ * @data: (nullable): The 64-bit integers to format, in native byte
+ *   order, or `NULL` to empty the model.
+ *
+ * Replaces the numbers of `self` with the integers in `data`, which
+ * is kept alive and read in place, and reports every item as changed.
+ */
+void
+icu_formatted_number_list_model_set_int_data (IcuFormattedNumberListModel *self,
+                                              GBytes                      *data)
+{
+  g_return_if_fail (ICU_IS_FORMATTED_NUMBER_LIST_MODEL (self));
+  g_return_if_fail (data == NULL || g_bytes_get_size (data) % sizeof (gint64) == 0);
+
+  set_data (self, data, FALSE);
+}
+
+/**
+ * icu_formatted_number_list_model_set_double_data:
+ * @self: An [class@FormattedNumberListModel].
+ * @data: (nullable): The doubles to format, in native byte order, or
+ *   `NULL` to empty the model.
+ *
+ * Replaces the numbers of `self` with the doubles in `data`, which is
+ * kept alive and read in place, and reports every item as changed.
+ */
+void
+icu_formatted_number_list_model_set_double_data (IcuFormattedNumberListModel *self,
+                                                 GBytes                      *data)
+{
+  g_return_if_fail (ICU_IS_FORMATTED_NUMBER_LIST_MODEL (self));
+  g_return_if_fail (data == NULL || g_bytes_get_size (data) % sizeof (gdouble) == 0);
+
+  set_data (self, data, TRUE);
+}
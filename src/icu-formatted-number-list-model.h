@@ -0,0 +1,49 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#pragma once
+
+#if !defined(_ICU_GOBJECT_INSIDE) && !defined(ICU_GOBJECT_COMPILATION)
+#  error "Only <icu-gobject.h> can be included directly"
+#endif
+
+#include <gio/gio.h>
+#include "icu-version.h"
+#include "icu-number-formatter.h"
+
+G_BEGIN_DECLS
+
+#define ICU_TYPE_FORMATTED_NUMBER_ITEM (icu_formatted_number_item_get_type())
+
+ICU_AVAILABLE_IN_ALL
+G_DECLARE_FINAL_TYPE (IcuFormattedNumberItem, icu_formatted_number_item, ICU, FORMATTED_NUMBER_ITEM, GObject)
+
+ICU_AVAILABLE_IN_ALL
+guint        icu_formatted_number_item_get_position (IcuFormattedNumberItem *self);
+ICU_AVAILABLE_IN_ALL
+const gchar *icu_formatted_number_item_get_string   (IcuFormattedNumberItem *self);
+
+#define ICU_TYPE_FORMATTED_NUMBER_LIST_MODEL (icu_formatted_number_list_model_get_type())
+
+ICU_AVAILABLE_IN_ALL
+G_DECLARE_FINAL_TYPE (IcuFormattedNumberListModel, icu_formatted_number_list_model, ICU, FORMATTED_NUMBER_LIST_MODEL, GObject)
+
+ICU_AVAILABLE_IN_ALL
+IcuFormattedNumberListModel *icu_formatted_number_list_model_new (IcuNumberFormatter *formatter);
+
+ICU_AVAILABLE_IN_ALL
+IcuNumberFormatter *icu_formatted_number_list_model_get_formatter   (IcuFormattedNumberListModel *self);
+ICU_AVAILABLE_IN_ALL
+void                icu_formatted_number_list_model_set_formatter   (IcuFormattedNumberListModel *self,
+                                                                     IcuNumberFormatter          *formatter);
+ICU_AVAILABLE_IN_ALL
+void                icu_formatted_number_list_model_set_int_data    (IcuFormattedNumberListModel *self,
+                                                                     GBytes                      *data);
+ICU_AVAILABLE_IN_ALL
+void                icu_formatted_number_list_model_set_double_data (IcuFormattedNumberListModel *self,
+                                                                     GBytes                      *data);
+
+G_END_DECLS
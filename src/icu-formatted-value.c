@@ -7,8 +7,12 @@
 #include "icu-formatted-value.h"
 #include "icu-formatted-value-private.h"
 
+#include <string.h>
+#include <unicode/uchar.h>
+#include <unicode/utf8.h>
 #include "icu-error-private.h"
 #include "icu-constrained-field-position-private.h"
+#include "icu-utf8-private.h"
 
 struct _IcuFormattedValue
 {
@@ -16,8 +20,189 @@ struct _IcuFormattedValue
   gchar *string;
 };
 
+// The state of the grapheme cluster being measured.
+typedef struct
+{
+  gint32 last_break;
+  gboolean is_emoji;
+  gboolean is_pictographic;
+  gsize n_regional_indicators;
+  guint width;
+} Cluster;
+
+// A field of a value being rendered, with its indexes as byte
+// offsets into the value.
+typedef struct
+{
+  gint32 field;
+  gsize start;
+  gsize end;
+
+  // The index of the span enclosing this one, or `G_MAXSIZE`.
+  gsize parent;
+} Span;
+
 G_DEFINE_POINTER_TYPE (IcuFormattedValue, icu_formatted_value)
 
+static guint
+get_code_point_width (UChar32 c,
+                      gint32  grapheme_break)
+{
+  gint8 category = u_charType (c);
+  gint32 east_asian_width = 0;
+
+  // Marks, format characters like the bidi ones and the vowels and
+  // final consonants of conjoining Hangul take no column of their own.
+  if (category == U_NON_SPACING_MARK ||
+      category == U_ENCLOSING_MARK ||
+      category == U_FORMAT_CHAR ||
+      category == U_CONTROL_CHAR ||
+      grapheme_break == U_GCB_V ||
+      grapheme_break == U_GCB_T)
+    return 0;
+
+  east_asian_width = u_getIntPropertyValue (c, UCHAR_EAST_ASIAN_WIDTH);
+  if (east_asian_width == U_EA_WIDE ||
+      east_asian_width == U_EA_FULLWIDTH ||
+      u_hasBinaryProperty (c, UCHAR_EMOJI_PRESENTATION))
+    return 2;
+
+  return 1;
+}
+
+// Tells whether a code point with the given grapheme cluster break
+// property continues the current cluster, following the rules of
+// UAX #29 for extended grapheme clusters.
+static gboolean
+continues_cluster (const Cluster *cluster,
+                   UChar32        c,
+                   gint32         grapheme_break)
+{
+  gint32 last = cluster->last_break;
+
+  if (last == U_GCB_CR)
+    return grapheme_break == U_GCB_LF;
+
+  if (last == U_GCB_CONTROL || last == U_GCB_LF ||
+      grapheme_break == U_GCB_CONTROL || grapheme_break == U_GCB_CR || grapheme_break == U_GCB_LF)
+    return FALSE;
+
+  if (last == U_GCB_L)
+    return (grapheme_break == U_GCB_L || grapheme_break == U_GCB_V ||
+            grapheme_break == U_GCB_LV || grapheme_break == U_GCB_LVT);
+
+  if ((last == U_GCB_LV || last == U_GCB_V) && (grapheme_break == U_GCB_V || grapheme_break == U_GCB_T))
+    return TRUE;
+
+  if ((last == U_GCB_LVT || last == U_GCB_T) && grapheme_break == U_GCB_T)
+    return TRUE;
+
+  if (grapheme_break == U_GCB_EXTEND ||
+      grapheme_break == U_GCB_ZWJ ||
+      grapheme_break == U_GCB_SPACING_MARK ||
+      last == U_GCB_PREPEND)
+    return TRUE;
+
+  if (last == U_GCB_ZWJ && cluster->is_pictographic)
+    return u_hasBinaryProperty (c, UCHAR_EXTENDED_PICTOGRAPHIC);
+
+  if (last == U_GCB_REGIONAL_INDICATOR && grapheme_break == U_GCB_REGIONAL_INDICATOR)
+    return cluster->n_regional_indicators % 2 == 1;
+
+  return FALSE;
+}
+
+static void
+measure_code_point (Cluster *cluster,
+                    UChar32  c,
+                    gsize   *width,
+                    gsize   *n_graphemes)
+{
+  gint32 grapheme_break = u_getIntPropertyValue (c, UCHAR_GRAPHEME_CLUSTER_BREAK);
+  guint code_point_width = get_code_point_width (c, grapheme_break);
+
+  if (continues_cluster (cluster, c, grapheme_break))
+    {
+      // A variation selector 16 asks for the emoji presentation of the
+      // character it follows.
+      if (c == 0xFE0F && cluster->is_emoji)
+        code_point_width = 2;
+    }
+  else
+    {
+      (*n_graphemes)++;
+
+      cluster->is_emoji = u_hasBinaryProperty (c, UCHAR_EMOJI);
+      cluster->is_pictographic = FALSE;
+      cluster->n_regional_indicators = 0;
+      cluster->width = 0;
+    }
+
+  // A cluster is as wide as the widest of its code points.
+  if (code_point_width > cluster->width)
+    {
+      *width += code_point_width - cluster->width;
+      cluster->width = code_point_width;
+    }
+
+  if (grapheme_break == U_GCB_REGIONAL_INDICATOR)
+    cluster->n_regional_indicators++;
+
+  if (u_hasBinaryProperty (c, UCHAR_EXTENDED_PICTOGRAPHIC))
+    cluster->is_pictographic = TRUE;
+
+  cluster->last_break = grapheme_break;
+}
+
+static void
+measure (const gchar *string,
+         gsize        length,
+         gsize       *out_width,
+         gsize       *out_graphemes)
+{
+  Cluster cluster = { U_GCB_CONTROL, FALSE, FALSE, 0, 0 };
+  gsize width = 0;
+  gsize n_graphemes = 0;
+  gsize i = 0;
+
+  while (i < length)
+    {
+      UChar32 c = 0;
+      gint32 j = 0;
+
+      // Printable ASCII, which is most of what numbers are made of, is
+      // always one column and starts a cluster of its own, unless it
+      // follows a prepended character like an Arabic number sign.
+      if ((guchar) string[i] >= 0x20 && (guchar) string[i] < 0x7F && cluster.last_break != U_GCB_PREPEND)
+        {
+          width++;
+          n_graphemes++;
+          i++;
+
+          cluster.last_break = U_GCB_OTHER;
+          cluster.is_emoji = FALSE;
+          cluster.is_pictographic = FALSE;
+          cluster.n_regional_indicators = 0;
+          cluster.width = 1;
+          continue;
+        }
+
+      U8_NEXT ((const guint8 *) string + i, j, (gint32) MIN (length - i, U8_MAX_LENGTH), c);
+      i += j;
+
+      if (c < 0)
+        c = 0xFFFD;
+
+      measure_code_point (&cluster, c, &width, &n_graphemes);
+    }
+
+  if (out_width != NULL)
+    *out_width = width;
+
+  if (out_graphemes != NULL)
+    *out_graphemes = n_graphemes;
+}
+
 IcuFormattedValue *
 icu_formatted_value_new (const UFormattedValue *ufmtval)
 {
@@ -80,3 +265,479 @@ icu_formatted_value_next_position (IcuFormattedValue            *self,
 
   return result;
 }
+
+/**
+ * icu_formatted_value_collect_positions:
+ * @self: An [struct@FormattedValue].
+ * @constraint: (nullable): A [class@ConstrainedFieldPosition] with the
+ *   constraint to apply, or `NULL` to collect every position.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Collects every field position of `self` matching the category or
+ * field constraint of `constraint` at once, which saves calling
+ * [method@FormattedValue.next_position] and the getters of
+ * [class@ConstrainedFieldPosition] for each of them.
+ *
+ * Only the constraint of `constraint` is used, so its iteration state,
+ * including its iteration context, is left as it is.
+ *
+ * Returns: (transfer full) (element-type IcuFieldSpan): The positions
+ *   matching the constraint, in iteration order, or `NULL` if `error`
+ *   is set.
+ */
+GArray *
+icu_formatted_value_collect_positions (IcuFormattedValue            *self,
+                                       IcuConstrainedFieldPosition  *constraint,
+                                       GError                      **error)
+{
+  g_autoptr (GArray) spans = NULL;
+  UConstrainedFieldPosition *ucfpos = NULL;
+  UErrorCode ec = U_ZERO_ERROR;
+
+  g_return_val_if_fail (self != NULL, NULL);
+
+  spans = g_array_new (FALSE, FALSE, sizeof (IcuFieldSpan));
+
+  ucfpos = ucfpos_open (&ec);
+
+  if (constraint != NULL && U_SUCCESS (ec))
+    icu_constrained_field_position_apply_constraint (constraint, ucfpos, &ec);
+
+  while (U_SUCCESS (ec) && ufmtval_nextPosition (self->ufmtval, ucfpos, &ec))
+    {
+      IcuFieldSpan span = {0};
+
+      span.category = ucfpos_getCategory (ucfpos, &ec);
+      span.field = ucfpos_getField (ucfpos, &ec);
+      ucfpos_getIndexes (ucfpos, &span.begin_index, &span.end_index, &ec);
+
+      g_array_append_val (spans, span);
+    }
+
+  g_clear_pointer (&ucfpos, ucfpos_close);
+
+  if (icu_has_failed (ec, error))
+    return NULL;
+
+  return g_steal_pointer (&spans);
+}
+
+static void
+append_escaped (GString     *out,
+                const gchar *text,
+                gsize        length)
+{
+  const gchar *end = text + length;
+  const gchar *run = text;
+  const gchar *p = NULL;
+
+  for (p = text; p < end; p++)
+    {
+      const gchar *entity = NULL;
+
+      switch (*p)
+        {
+        case '&':
+          entity = "&amp;";
+          break;
+
+        case '<':
+          entity = "&lt;";
+          break;
+
+        case '>':
+          entity = "&gt;";
+          break;
+
+        case '\'':
+          entity = "&#39;";
+          break;
+
+        case '"':
+          entity = "&quot;";
+          break;
+
+        default:
+          continue;
+        }
+
+      g_string_append_len (out, run, p - run);
+      g_string_append (out, entity);
+      run = p + 1;
+    }
+
+  g_string_append_len (out, run, end - run);
+}
+
+static gint
+compare_spans (gconstpointer a,
+               gconstpointer b)
+{
+  const Span *span_a = a;
+  const Span *span_b = b;
+
+  // Enclosing spans come before the ones they enclose.
+  if (span_a->start != span_b->start)
+    return span_a->start < span_b->start ? -1 : 1;
+
+  if (span_a->end != span_b->end)
+    return span_a->end > span_b->end ? -1 : 1;
+
+  return 0;
+}
+
+// Appends `string` to `out` escaped, wrapping every span that has a
+// tag in its opening and closing tags. Spans are expected to nest, and
+// are otherwise cut at the end of the span they start in.
+static void
+render_spans (const gchar         *string,
+              gsize                length,
+              GArray              *spans,
+              const gchar * const *open_tags,
+              const gchar * const *close_tags,
+              gsize                n_tags,
+              GString             *out)
+{
+  gsize top = G_MAXSIZE;
+  gsize position = 0;
+  gsize i = 0;
+
+  g_array_sort (spans, compare_spans);
+
+  for (i = 0; i < spans->len; i++)
+    {
+      Span *span = &g_array_index (spans, Span, i);
+
+      if (span->field < 0 || (gsize) span->field >= n_tags || open_tags[span->field] == NULL)
+        continue;
+
+      while (top != G_MAXSIZE && g_array_index (spans, Span, top).end <= span->start)
+        {
+          Span *enclosing = &g_array_index (spans, Span, top);
+
+          append_escaped (out, string + position, enclosing->end - position);
+          position = enclosing->end;
+
+          if (close_tags != NULL && close_tags[enclosing->field] != NULL)
+            g_string_append (out, close_tags[enclosing->field]);
+
+          top = enclosing->parent;
+        }
+
+      if (top != G_MAXSIZE)
+        span->end = MIN (span->end, g_array_index (spans, Span, top).end);
+
+      append_escaped (out, string + position, span->start - position);
+      position = span->start;
+
+      g_string_append (out, open_tags[span->field]);
+
+      span->parent = top;
+      top = i;
+    }
+
+  while (top != G_MAXSIZE)
+    {
+      Span *enclosing = &g_array_index (spans, Span, top);
+
+      append_escaped (out, string + position, enclosing->end - position);
+      position = enclosing->end;
+
+      if (close_tags != NULL && close_tags[enclosing->field] != NULL)
+        g_string_append (out, close_tags[enclosing->field]);
+
+      top = enclosing->parent;
+    }
+
+  append_escaped (out, string + position, length - position);
+}
+
+/**
+ * icu_formatted_value_get_display_width:
+ * @self: An [struct@FormattedValue].
+ * @width: (out) (optional): The return location for the number of
+ *   columns the value takes.
+ * @n_graphemes: (out) (optional): The return location for the number
+ *   of grapheme clusters in the value.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Measures the width of `self` as displayed by a terminal or in any
+ * other fixed-width layout.
+ *
+ * Grapheme clusters take as many columns as the widest of their code
+ * points. Wide and fullwidth East Asian characters and emoji take two
+ * columns, marks and format characters like bidi marks take none, and
+ * everything else takes one, including characters of ambiguous width.
+ *
+ * Returns: `TRUE` on success, `FALSE` if `error` is set.
+ */
+gboolean
+icu_formatted_value_get_display_width (IcuFormattedValue  *self,
+                                       gsize              *width,
+                                       gsize              *n_graphemes,
+                                       GError            **error)
+{
+  const gchar *string = NULL;
+
+  g_return_val_if_fail (self != NULL, FALSE);
+
+  string = icu_formatted_value_get_string (self, error);
+  if (string == NULL)
+    return FALSE;
+
+  measure (string, strlen (string), width, n_graphemes);
+
+  return TRUE;
+}
+
+/**
+ * icu_formatted_value_get_display_width_batch: (skip)
+ * @buffer: The buffer holding the formatted values, like the arena of
+ *   [method@NumberFormatter.format_decimal_batch].
+ * @offsets: The `n_values + 1` offsets delimiting each value in
+ *   `buffer`.
+ * @n_values: The number of values to measure.
+ * @out_widths: (nullable): The return location for the `n_values`
+ *   widths of the values, or `NULL`.
+ * @out_graphemes: (nullable): The return location for the `n_values`
+ *   numbers of grapheme clusters in the values, or `NULL`.
+ *
+ * Measures every value delimited by `offsets` in `buffer` as
+ * [method@FormattedValue.get_display_width] does, right after formatting
+ * them in bulk.
+ */
+void
+icu_formatted_value_get_display_width_batch (const gchar *buffer,
+                                             const gsize *offsets,
+                                             gsize        n_values,
+                                             gsize       *out_widths,
+                                             gsize       *out_graphemes)
+{
+  gsize i = 0;
+
+  g_return_if_fail (buffer != NULL || n_values == 0);
+  g_return_if_fail (offsets != NULL);
+
+  for (i = 0; i < n_values; i++)
+    {
+      g_return_if_fail (offsets[i] <= offsets[i + 1]);
+
+      measure (buffer + offsets[i],
+               offsets[i + 1] - offsets[i],
+               out_widths != NULL ? &out_widths[i] : NULL,
+               out_graphemes != NULL ? &out_graphemes[i] : NULL);
+    }
+}
+
+static gint
+compare_indices (gconstpointer a,
+                 gconstpointer b)
+{
+  gsize index_a = **(gsize * const *) a;
+  gsize index_b = **(gsize * const *) b;
+
+  return index_a < index_b ? -1 : index_a > index_b;
+}
+
+// Converts the UTF-16 indices of `spans` into UTF-8 offsets, measuring
+// `ustring` in a single forward walk over them in order.
+static void
+convert_span_indices (const UChar *ustring,
+                      GArray      *spans)
+{
+  g_autoptr (GPtrArray) indices = NULL;
+  gsize utf16_index = 0;
+  gsize utf8_offset = 0;
+  guint i = 0;
+
+  indices = g_ptr_array_sized_new (spans->len * 2);
+
+  for (i = 0; i < spans->len; i++)
+    {
+      Span *span = &g_array_index (spans, Span, i);
+
+      g_ptr_array_add (indices, &span->start);
+      g_ptr_array_add (indices, &span->end);
+    }
+
+  g_ptr_array_sort (indices, compare_indices);
+
+  for (i = 0; i < indices->len; i++)
+    {
+      gsize *index = g_ptr_array_index (indices, i);
+
+      utf8_offset += icu_utf8_length_of_utf16 (ustring + utf16_index, (gint32) (*index - utf16_index));
+      utf16_index = *index;
+
+      *index = utf8_offset;
+    }
+}
+
+/**
+ * icu_formatted_value_render_markup:
+ * @self: An [struct@FormattedValue].
+ * @category: The [enum@FieldCategory] of the fields to render.
+ * @open_tags: (array length=n_tags): The tags to open each field
+ *   with, indexed by field, with `NULL` for fields to leave as they
+ *   are.
+ * @close_tags: (array length=n_tags) (nullable): The tags to close
+ *   each field with, indexed by field, or `NULL`.
+ * @n_tags: The number of tags in `open_tags` and `close_tags`.
+ * @out: The string to append the markup to.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Appends `self` to `out` as markup, like Pango markup or HTML, with
+ * every field of `category` wrapped in its tags, and the text escaped.
+ *
+ * For instance, using the [enum@NumberFormatField] values as indexes
+ * for `<span class="integer">` and `</span>` style tags gives a
+ * formatted number a class for each of its parts. Fields inside other
+ * fields, like grouping separators, are nested in their tags.
+ *
+ * Returns: `TRUE` on success, `FALSE` if `error` is set, in which case
+ *   `out` is left unchanged.
+ */
+gboolean
+icu_formatted_value_render_markup (IcuFormattedValue    *self,
+                                   gint32                category,
+                                   const gchar * const  *open_tags,
+                                   const gchar * const  *close_tags,
+                                   gsize                 n_tags,
+                                   GString              *out,
+                                   GError              **error)
+{
+  g_autoptr (GArray) spans = NULL;
+  UConstrainedFieldPosition *ucfpos = NULL;
+  const UChar *ustring = NULL;
+  const gchar *string = NULL;
+  gint32 length = 0;
+  UErrorCode ec = U_ZERO_ERROR;
+
+  g_return_val_if_fail (self != NULL, FALSE);
+  g_return_val_if_fail (open_tags != NULL || n_tags == 0, FALSE);
+  g_return_val_if_fail (out != NULL, FALSE);
+
+  string = icu_formatted_value_get_string (self, error);
+  if (string == NULL)
+    return FALSE;
+
+  ustring = ufmtval_getString (self->ufmtval, &length, &ec);
+  if (icu_has_failed (ec, error))
+    return FALSE;
+
+  spans = g_array_new (FALSE, FALSE, sizeof (Span));
+
+  ucfpos = ucfpos_open (&ec);
+  ucfpos_constrainCategory (ucfpos, category, &ec);
+
+  while (U_SUCCESS (ec) && ufmtval_nextPosition (self->ufmtval, ucfpos, &ec))
+    {
+      Span span = { 0, 0, 0, G_MAXSIZE };
+      gint32 begin_index = 0;
+      gint32 end_index = 0;
+
+      ucfpos_getIndexes (ucfpos, &begin_index, &end_index, &ec);
+
+      // Converted to UTF-8 offsets once every span is known.
+      span.field = ucfpos_getField (ucfpos, &ec);
+      span.start = (gsize) begin_index;
+      span.end = (gsize) end_index;
+
+      g_array_append_val (spans, span);
+    }
+
+  g_clear_pointer (&ucfpos, ucfpos_close);
+
+  if (icu_has_failed (ec, error))
+    return FALSE;
+
+  convert_span_indices (ustring, spans);
+  render_spans (string, strlen (string), spans, open_tags, close_tags, n_tags, out);
+
+  return TRUE;
+}
+
+/**
+ * icu_formatted_value_render_markup_batch: (skip)
+ * @buffer: The buffer holding the formatted values.
+ * @offsets: The `n_values + 1` offsets delimiting each value in
+ *   `buffer`.
+ * @n_values: The number of values to render.
+ * @fields: The number fields of the values, with their indexes as byte
+ *   offsets into `buffer`, in the order of the values.
+ * @n_fields: The number of fields.
+ * @open_tags: The tags to open each field with, indexed by field, with
+ *   `NULL` for fields to leave as they are.
+ * @close_tags: (nullable): The tags to close each field with, indexed
+ *   by field, or `NULL`.
+ * @n_tags: The number of tags in `open_tags` and `close_tags`.
+ * @arena: The string to append all rendered values to.
+ * @out_offsets: The return location for the `n_values + 1` offsets
+ *   delimiting each rendered value in `arena`.
+ *
+ * Renders every value delimited by `offsets` in `buffer` as
+ * [method@FormattedValue.render_markup] does, appending the results
+ * one after another to `arena`.
+ *
+ * Values and fields appended to the same string and array with
+ * [method@NumberFormatter.append_int] or
+ * [method@NumberFormatter.append_double] can be rendered as they are.
+ */
+void
+icu_formatted_value_render_markup_batch (const gchar            *buffer,
+                                         const gsize            *offsets,
+                                         gsize                   n_values,
+                                         const IcuFieldPosition *fields,
+                                         gsize                   n_fields,
+                                         const gchar * const    *open_tags,
+                                         const gchar * const    *close_tags,
+                                         gsize                   n_tags,
+                                         GString                *arena,
+                                         gsize                  *out_offsets)
+{
+  g_autoptr (GArray) spans = NULL;
+  gsize field = 0;
+  gsize i = 0;
+
+  g_return_if_fail (buffer != NULL || n_values == 0);
+  g_return_if_fail (offsets != NULL);
+  g_return_if_fail (fields != NULL || n_fields == 0);
+  g_return_if_fail (open_tags != NULL || n_tags == 0);
+  g_return_if_fail (arena != NULL);
+  g_return_if_fail (out_offsets != NULL);
+
+  spans = g_array_new (FALSE, FALSE, sizeof (Span));
+
+  out_offsets[0] = arena->len;
+
+  for (i = 0; i < n_values; i++)
+    {
+      gsize start = offsets[i];
+      gsize end = offsets[i + 1];
+
+      g_array_set_size (spans, 0);
+
+      // Fields of earlier values, or out of range, are skipped.
+      while (field < n_fields && (gsize) fields[field].begin_index < start)
+        field++;
+
+      while (field < n_fields && (gsize) fields[field].begin_index < end)
+        {
+          Span span = { 0, 0, 0, G_MAXSIZE };
+
+          span.field = fields[field].field;
+          span.start = (gsize) fields[field].begin_index - start;
+          span.end = MIN ((gsize) fields[field].end_index, end) - start;
+
+          g_array_append_val (spans, span);
+          field++;
+        }
+
+      render_spans (buffer + start, end - start, spans, open_tags, close_tags, n_tags, arena);
+
+      out_offsets[i + 1] = arena->len;
+    }
+}
@@ -13,6 +13,8 @@
 #include <glib-object.h>
 #include "icu-version.h"
 #include "icu-constrained-field-position.h"
+#include "icu-field-position.h"
+#include "icu-field-span.h"
 
 G_BEGIN_DECLS
 
@@ -31,5 +33,41 @@ ICU_AVAILABLE_IN_ALL
 gboolean icu_formatted_value_next_position (IcuFormattedValue            *self,
                                             IcuConstrainedFieldPosition  *position,
                                             GError                      **error);
+ICU_AVAILABLE_IN_ALL
+GArray  *icu_formatted_value_collect_positions (IcuFormattedValue            *self,
+                                                IcuConstrainedFieldPosition  *constraint,
+                                                GError                      **error);
+
+ICU_AVAILABLE_IN_ALL
+gboolean icu_formatted_value_get_display_width       (IcuFormattedValue  *self,
+                                                      gsize              *width,
+                                                      gsize              *n_graphemes,
+                                                      GError            **error);
+ICU_AVAILABLE_IN_ALL
+void     icu_formatted_value_get_display_width_batch (const gchar        *buffer,
+                                                      const gsize        *offsets,
+                                                      gsize               n_values,
+                                                      gsize              *out_widths,
+                                                      gsize              *out_graphemes);
+
+ICU_AVAILABLE_IN_ALL
+gboolean icu_formatted_value_render_markup       (IcuFormattedValue       *self,
+                                                  gint32                   category,
+                                                  const gchar * const     *open_tags,
+                                                  const gchar * const     *close_tags,
+                                                  gsize                    n_tags,
+                                                  GString                 *out,
+                                                  GError                 **error);
+ICU_AVAILABLE_IN_ALL
+void     icu_formatted_value_render_markup_batch (const gchar             *buffer,
+                                                  const gsize             *offsets,
+                                                  gsize                    n_values,
+                                                  const IcuFieldPosition  *fields,
+                                                  gsize                    n_fields,
+                                                  const gchar * const     *open_tags,
+                                                  const gchar * const     *close_tags,
+                                                  gsize                    n_tags,
+                                                  GString                 *arena,
+                                                  gsize                   *out_offsets);
 
 G_END_DECLS
@@ -0,0 +1,523 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "icu-formatter-set.h"
+
+#include <unicode/uloc.h>
+#include "icu-locale.h"
+#include "icu-number-skeleton.h"
+
+// The bit of a published pointer used as a lock. Sets are allocated
+// with at least pointer alignment, so it is never part of the address.
+#define LOCK_BIT 0
+
+/**
+ * IcuFormatterSet:
+ *
+ * A named collection of formatters bound to one locale.
+ *
+ * Applications rendering the same kinds of numbers everywhere, like
+ * prices, quantities or percentages, create one set with a skeleton
+ * for each of them, and look the formatters up by name.
+ *
+ * Sets never change after being created, so when the locale changes,
+ * a new set is built and published in place of the old one, with
+ * [func@FormatterSet.rebuild_for_locale_async]. Readers get the
+ * current set with [func@FormatterSet.acquire] and keep using it
+ * until they drop their reference, so a request that started with one
+ * locale never ends with another, and none of them wait for the new
+ * set to be built.
+ */
+
+struct _IcuFormatterSet
+{
+  guint ref_count;
+
+  gchar *locale;
+  GStrv names;
+  GStrv skeletons;
+
+  // The formatters, keyed by the names they were given.
+  GHashTable *formatters;
+};
+
+typedef struct
+{
+  IcuFormatterSet **location;
+  IcuFormatterSet *current;
+  gchar *locale;
+  guint64 serial;
+} RebuildData;
+
+// The rebuilds started at a location, so that only the latest one
+// publishes what it builds.
+typedef struct
+{
+  guint64 latest_serial;
+  guint n_pending;
+} Rebuilds;
+
+// Keyed by the locations being rebuilt, and only holding those with
+// rebuilds pending.
+G_LOCK_DEFINE_STATIC (rebuilds);
+static GHashTable *rebuilds = NULL;
+
+G_DEFINE_BOXED_TYPE (IcuFormatterSet, icu_formatter_set, icu_formatter_set_ref, icu_formatter_set_unref)
+
+static void
+icu_formatter_set_free (IcuFormatterSet *self)
+{
+  g_assert_nonnull (self);
+  g_assert_cmpuint (self->ref_count, ==, 0);
+
+  g_clear_pointer (&self->formatters, g_hash_table_unref);
+  g_clear_pointer (&self->locale, g_free);
+  g_clear_pointer (&self->names, g_strfreev);
+  g_clear_pointer (&self->skeletons, g_strfreev);
+
+  g_slice_free (IcuFormatterSet, self);
+}
+
+static void
+rebuild_data_free (RebuildData *data)
+{
+  Rebuilds *pending = NULL;
+
+  G_LOCK (rebuilds);
+
+  pending = g_hash_table_lookup (rebuilds, data->location);
+  if (--pending->n_pending == 0)
+    g_hash_table_remove (rebuilds, data->location);
+
+  G_UNLOCK (rebuilds);
+
+  g_clear_pointer (&data->current, icu_formatter_set_unref);
+  g_clear_pointer (&data->locale, g_free);
+
+  g_free (data);
+}
+
+static IcuFormatterSet *
+build_set (const gchar * const  *names,
+           const gchar * const  *skeletons,
+           const gchar          *locale,
+           GCancellable         *cancellable,
+           GError              **error)
+{
+  g_autoptr (IcuFormatterSet) self = NULL;
+  gsize n_names = 0;
+  gsize i = 0;
+
+  n_names = g_strv_length ((GStrv) names);
+
+  self = g_slice_new0 (IcuFormatterSet);
+  self->ref_count = 1;
+  self->names = g_strdupv ((GStrv) names);
+  self->skeletons = g_new0 (gchar *, n_names + 1);
+  self->formatters = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
+                                            (GDestroyNotify) icu_number_formatter_unref);
+
+  self->locale = icu_locale_canonicalize (locale != NULL ? locale : uloc_getDefault (), error);
+  if (self->locale == NULL)
+    return NULL;
+
+  for (i = 0; i < n_names; i++)
+    {
+      g_autoptr (IcuNumberFormatter) formatter = NULL;
+      g_autoptr (IcuFormattedNumber) number = NULL;
+
+      if (g_cancellable_set_error_if_cancelled (cancellable, error))
+        return NULL;
+
+      self->skeletons[i] = icu_number_skeleton_canonicalize (skeletons[i]);
+
+      formatter = icu_number_formatter_get_shared (self->skeletons[i], self->locale, error);
+      if (formatter == NULL)
+        return NULL;
+
+      // Formatting a value once pages in the locale data the formatter
+      // needs, so the first request using the set does not wait for it.
+      number = icu_number_formatter_format_double (formatter, -1234567.891, error);
+      if (number == NULL)
+        return NULL;
+
+      g_hash_table_insert (self->formatters, self->names[i], g_steal_pointer (&formatter));
+    }
+
+  return g_steal_pointer (&self);
+}
+
+static inline IcuFormatterSet *
+untag (gpointer pointer)
+{
+  return (IcuFormatterSet *) ((guintptr) pointer & ~((guintptr) 1 << LOCK_BIT));
+}
+
+// Publishes `set` in place of the set the rebuild started from, unless
+// another set was published or another rebuild started in the meantime,
+// so that rebuilds finishing out of order never leave a stale locale.
+static gboolean
+publish_if_latest (RebuildData     *data,
+                   IcuFormatterSet *set)
+{
+  const Rebuilds *pending = NULL;
+  gboolean published = FALSE;
+
+  G_LOCK (rebuilds);
+
+  pending = g_hash_table_lookup (rebuilds, data->location);
+  if (pending->latest_serial == data->serial)
+    {
+      g_pointer_bit_lock (data->location, LOCK_BIT);
+
+      if (untag (g_atomic_pointer_get (data->location)) == data->current)
+        {
+          // The reference held by `location` is the one dropped below,
+          // outside of the lock as in icu_formatter_set_publish().
+          g_atomic_pointer_set (data->location,
+                                (IcuFormatterSet *) ((guintptr) icu_formatter_set_ref (set) | ((guintptr) 1 << LOCK_BIT)));
+          published = TRUE;
+        }
+
+      g_pointer_bit_unlock (data->location, LOCK_BIT);
+    }
+
+  G_UNLOCK (rebuilds);
+
+  if (published)
+    icu_formatter_set_unref (data->current);
+
+  return published;
+}
+
+static void
+rebuild_thread (GTask        *task,
+                gpointer      source_object,
+                gpointer      task_data,
+                GCancellable *cancellable)
+{
+  RebuildData *data = task_data;
+  g_autoptr (IcuFormatterSet) set = NULL;
+  GError *error = NULL;
+
+  set = build_set ((const gchar * const *) data->current->names,
+                   (const gchar * const *) data->current->skeletons,
+                   data->locale,
+                   cancellable,
+                   &error);
+
+  if (set == NULL)
+    {
+      g_task_return_error (task, error);
+      return;
+    }
+
+  if (g_task_return_error_if_cancelled (task))
+    return;
+
+  if (!publish_if_latest (data, set))
+    {
+      g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_CANCELLED,
+                               "The set was replaced while being rebuilt");
+      return;
+    }
+
+  g_task_return_boolean (task, TRUE);
+}
+
+/**
+ * icu_formatter_set_new:
+ * @names: (array zero-terminated=1): The names of the formatters.
+ * @skeletons: (array zero-terminated=1): The number skeletons of the
+ *   formatters, one for each name.
+ * @locale: (nullable): The locale to format for, or `NULL` to use the
+ *   default locale.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Creates a new [class@FormatterSet] with a formatter for each pair
+ * of `names` and `skeletons`, which come from the same process-wide
+ * cache as [func@NumberFormatter.get_shared].
+ *
+ * Returns: (transfer full): A newly created [class@FormatterSet], or
+ *   `NULL` if `error` is set.
+ */
+IcuFormatterSet *
+icu_formatter_set_new (const gchar * const  *names,
+                       const gchar * const  *skeletons,
+                       const gchar          *locale,
+                       GError              **error)
+{
+  g_autoptr (GHashTable) seen = NULL;
+  gsize i = 0;
+
+  g_return_val_if_fail (names != NULL, NULL);
+  g_return_val_if_fail (skeletons != NULL, NULL);
+  g_return_val_if_fail (g_strv_length ((GStrv) names) == g_strv_length ((GStrv) skeletons), NULL);
+
+  seen = g_hash_table_new (g_str_hash, g_str_equal);
+
+  for (i = 0; names[i] != NULL; i++)
+    {
+      g_return_val_if_fail (!g_hash_table_contains (seen, names[i]), NULL);
+      g_hash_table_add (seen, (gpointer) names[i]);
+    }
+
+  return build_set (names, skeletons, locale, NULL, error);
+}
+
+/**
+ * icu_formatter_set_ref:
+ * @self: A [class@FormatterSet].
+ *
+ * Increases the reference count of `self` by one.
+ *
+ * Returns: (transfer full): The passed in [class@FormatterSet].
+ */
+IcuFormatterSet *
+icu_formatter_set_ref (IcuFormatterSet *self)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+
+  g_atomic_int_inc (&self->ref_count);
+
+  return self;
+}
+
+/**
+ * icu_formatter_set_unref:
+ * @self: A [class@FormatterSet].
+ *
+ * Decreases the reference count of `self` by one.
+ *
+ * If the resulting reference count is zero, frees the memory of
+ * `self`.
+ */
+void
+icu_formatter_set_unref (IcuFormatterSet *self)
+{
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (self->ref_count >= 1);
+
+  if (g_atomic_int_dec_and_test (&self->ref_count))
+    icu_formatter_set_free (self);
+}
+
+/**
+ * icu_formatter_set_get_locale:
+ * @self: A [class@FormatterSet].
+ *
+ * Gets the canonical language tag of the locale `self` formats for.
+ *
+ * Returns: The locale of `self`.
+ */
+const gchar *
+icu_formatter_set_get_locale (IcuFormatterSet *self)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+
+  return self->locale;
+}
+
+/**
+ * icu_formatter_set_get_names:
+ * @self: A [class@FormatterSet].
+ *
+ * Gets the names of the formatters in `self`, in the order they were
+ * given.
+ *
+ * Returns: (array zero-terminated=1): The names of the formatters.
+ */
+const gchar * const *
+icu_formatter_set_get_names (IcuFormatterSet *self)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+
+  return (const gchar * const *) self->names;
+}
+
+/**
+ * icu_formatter_set_get_formatter:
+ * @self: A [class@FormatterSet].
+ * @name: The name of the formatter.
+ *
+ * Gets the formatter of `self` called `name`.
+ *
+ * Returns: (transfer none) (nullable): The formatter called `name`, or
+ *   `NULL` if there is none.
+ */
+IcuNumberFormatter *
+icu_formatter_set_get_formatter (IcuFormatterSet *self,
+                                 const gchar     *name)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (name != NULL, NULL);
+
+  return g_hash_table_lookup (self->formatters, name);
+}
+
+/**
+ * icu_formatter_set_acquire: (skip)
+ * @location: The location a set is published at.
+ *
+ * Gets a reference to the set published at `location`.
+ *
+ * Locations are only meant to be accessed through this function and
+ * [func@FormatterSet.publish], which may use them as a lock while
+ * taking the reference.
+ *
+ * Returns: (transfer full) (nullable): The set published at
+ *   `location`, or `NULL` if there is none.
+ */
+IcuFormatterSet *
+icu_formatter_set_acquire (IcuFormatterSet **location)
+{
+  IcuFormatterSet *set = NULL;
+
+  g_return_val_if_fail (location != NULL, NULL);
+
+  g_pointer_bit_lock (location, LOCK_BIT);
+
+  set = untag (g_atomic_pointer_get (location));
+  if (set != NULL)
+    icu_formatter_set_ref (set);
+
+  g_pointer_bit_unlock (location, LOCK_BIT);
+
+  return set;
+}
+
+/**
+ * icu_formatter_set_publish: (skip)
+ * @location: The location to publish `set` at.
+ * @set: (nullable): The set to publish, or `NULL` to clear
+ *   `location`.
+ *
+ * Replaces the set published at `location` with `set`, in a single
+ * pointer store.
+ *
+ * Readers that acquired the previous set keep it until they drop their
+ * reference, while the following ones get `set`.
+ */
+void
+icu_formatter_set_publish (IcuFormatterSet **location,
+                           IcuFormatterSet  *set)
+{
+  IcuFormatterSet *old = NULL;
+
+  g_return_if_fail (location != NULL);
+
+  if (set != NULL)
+    icu_formatter_set_ref (set);
+
+  g_pointer_bit_lock (location, LOCK_BIT);
+
+  old = untag (g_atomic_pointer_get (location));
+
+  // The lock bit is kept set until the unlock below clears it.
+  g_atomic_pointer_set (location, (IcuFormatterSet *) ((guintptr) set | ((guintptr) 1 << LOCK_BIT)));
+
+  g_pointer_bit_unlock (location, LOCK_BIT);
+
+  // The last reference may be dropped here, which is left outside of
+  // the lock so readers never wait for a set to be freed.
+  if (old != NULL)
+    icu_formatter_set_unref (old);
+}
+
+/**
+ * icu_formatter_set_rebuild_for_locale_async: (skip)
+ * @location: The location the set to rebuild is published at.
+ * @locale: (nullable): The locale to rebuild the set for, or `NULL` to
+ *   use the default locale.
+ * @cancellable: (nullable): A [class@Gio.Cancellable].
+ * @callback: (scope async): The callback to call when done.
+ * @user_data: (closure): The data to pass to `callback`.
+ *
+ * Builds a set with the same names and skeletons as the one published
+ * at `location`, but for `locale`, in a worker thread, and publishes
+ * it at `location` with [func@FormatterSet.publish] once every
+ * formatter is ready.
+ *
+ * `location` must stay valid until `callback` is called. If building
+ * the new set fails or is cancelled, the published set is left as it
+ * is.
+ *
+ * Only the latest rebuild started at `location` publishes its set, and
+ * only if no other set was published there since it started. The
+ * others finish with [error@Gio.IOErrorEnum.CANCELLED], so the set
+ * published last is always the one for the locale asked for last, no
+ * matter the order the rebuilds finish in.
+ */
+void
+icu_formatter_set_rebuild_for_locale_async (IcuFormatterSet     **location,
+                                            const gchar          *locale,
+                                            GCancellable         *cancellable,
+                                            GAsyncReadyCallback   callback,
+                                            gpointer              user_data)
+{
+  g_autoptr (GTask) task = NULL;
+  g_autoptr (IcuFormatterSet) current = NULL;
+  RebuildData *data = NULL;
+  Rebuilds *pending = NULL;
+
+  g_return_if_fail (location != NULL);
+  g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+  current = icu_formatter_set_acquire (location);
+  g_return_if_fail (current != NULL);
+
+  data = g_new0 (RebuildData, 1);
+  data->location = location;
+  data->current = g_steal_pointer (&current);
+  data->locale = g_strdup (locale);
+
+  G_LOCK (rebuilds);
+
+  if (rebuilds == NULL)
+    rebuilds = g_hash_table_new_full (NULL, NULL, NULL, g_free);
+
+  pending = g_hash_table_lookup (rebuilds, location);
+  if (pending == NULL)
+    {
+      pending = g_new0 (Rebuilds, 1);
+      g_hash_table_insert (rebuilds, location, pending);
+    }
+
+  data->serial = ++pending->latest_serial;
+  pending->n_pending++;
+
+  G_UNLOCK (rebuilds);
+
+  task = g_task_new (NULL, cancellable, callback, user_data);
+  g_task_set_source_tag (task, icu_formatter_set_rebuild_for_locale_async);
+  g_task_set_task_data (task, data, (GDestroyNotify) rebuild_data_free);
+  g_task_run_in_thread (task, rebuild_thread);
+}
+
+/**
+ * icu_formatter_set_rebuild_for_locale_finish:
+ * @result: The [iface@Gio.AsyncResult] passed to the callback.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Finishes an operation started with
+ * [func@FormatterSet.rebuild_for_locale_async].
+ *
+ * Returns: `TRUE` if the new set was published, `FALSE` if `error` is
+ *   set, e.g. to [error@Gio.IOErrorEnum.CANCELLED] if the rebuild was
+ *   superseded.
+ */
+gboolean
+icu_formatter_set_rebuild_for_locale_finish (GAsyncResult  *result,
+                                             GError       **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, NULL), FALSE);
+  g_return_val_if_fail (g_task_get_source_tag (G_TASK (result)) == icu_formatter_set_rebuild_for_locale_async, FALSE);
+
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
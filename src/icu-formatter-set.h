@@ -0,0 +1,63 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#pragma once
+
+#if !defined(_ICU_GOBJECT_INSIDE) && !defined(ICU_GOBJECT_COMPILATION)
+#  error "Only <icu-gobject.h> can be included directly"
+#endif
+
+#include <gio/gio.h>
+#include "icu-version.h"
+#include "icu-number-formatter.h"
+
+G_BEGIN_DECLS
+
+#define ICU_TYPE_FORMATTER_SET (icu_formatter_set_get_type())
+
+typedef struct _IcuFormatterSet IcuFormatterSet;
+
+ICU_AVAILABLE_IN_ALL
+GType icu_formatter_set_get_type (void);
+
+ICU_AVAILABLE_IN_ALL
+IcuFormatterSet *icu_formatter_set_new (const gchar * const  *names,
+                                        const gchar * const  *skeletons,
+                                        const gchar          *locale,
+                                        GError              **error);
+
+ICU_AVAILABLE_IN_ALL
+IcuFormatterSet *icu_formatter_set_ref   (IcuFormatterSet *self);
+ICU_AVAILABLE_IN_ALL
+void             icu_formatter_set_unref (IcuFormatterSet *self);
+
+ICU_AVAILABLE_IN_ALL
+const gchar         *icu_formatter_set_get_locale    (IcuFormatterSet *self);
+ICU_AVAILABLE_IN_ALL
+const gchar * const *icu_formatter_set_get_names     (IcuFormatterSet *self);
+ICU_AVAILABLE_IN_ALL
+IcuNumberFormatter  *icu_formatter_set_get_formatter (IcuFormatterSet *self,
+                                                      const gchar     *name);
+
+ICU_AVAILABLE_IN_ALL
+IcuFormatterSet *icu_formatter_set_acquire (IcuFormatterSet **location);
+ICU_AVAILABLE_IN_ALL
+void             icu_formatter_set_publish (IcuFormatterSet **location,
+                                            IcuFormatterSet  *set);
+
+ICU_AVAILABLE_IN_ALL
+void     icu_formatter_set_rebuild_for_locale_async  (IcuFormatterSet     **location,
+                                                      const gchar          *locale,
+                                                      GCancellable         *cancellable,
+                                                      GAsyncReadyCallback   callback,
+                                                      gpointer              user_data);
+ICU_AVAILABLE_IN_ALL
+gboolean icu_formatter_set_rebuild_for_locale_finish (GAsyncResult         *result,
+                                                      GError              **error);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (IcuFormatterSet, icu_formatter_set_unref)
+
+G_END_DECLS
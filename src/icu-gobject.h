@@ -15,15 +15,30 @@
 G_BEGIN_DECLS
 
 #define _ICU_GOBJECT_INSIDE
+#  include "icu-break-iterator.h"
+#  include "icu-case-map.h"
+#  include "icu-charset-converter.h"
 #  include "icu-constrained-field-position.h"
+#  include "icu-data.h"
 #  include "icu-enum-types.h"
 #  include "icu-error.h"
 #  include "icu-field-position-iterator.h"
 #  include "icu-field-position.h"
+#  include "icu-field-span.h"
+#  include "icu-formatter-set.h"
+#  include "icu-formatted-number-list-model.h"
 #  include "icu-formatted-number.h"
 #  include "icu-formatted-value.h"
+#  include "icu-locale-matcher.h"
+#  include "icu-locale.h"
+#  include "icu-message-format.h"
 #  include "icu-number-format-field.h"
+#  include "icu-number-formatter-family.h"
 #  include "icu-number-formatter.h"
+#  include "icu-number-skeleton-builder.h"
+#  include "icu-number-skeleton.h"
+#  include "icu-number-specialization.h"
+#  include "icu-number-symbols.h"
 #  include "icu-version.h"
 #undef _ICU_GOBJECT_INSIDE
 
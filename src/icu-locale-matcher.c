@@ -0,0 +1,461 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "icu-locale-matcher.h"
+
+#include <string.h>
+#include <unicode/uloc.h>
+#include "icu-error-private.h"
+#include "icu-locale.h"
+
+// The cache is keyed by whole headers, of which a server sees only a
+// handful of distinct ones in practice. Once it grows past this many
+// entries it is simply cleared, which keeps hostile clients from
+// making it grow without bounds.
+#define MAX_CACHED_MATCHES 256
+
+// Browsers send a handful of languages, so only this many of the most
+// preferred ones are matched, which bounds the work hostile headers
+// can cause.
+#define MAX_ACCEPTED_LANGUAGES 32
+
+/**
+ * IcuLocaleMatcher:
+ *
+ * Negotiates the best locale out of a fixed set of supported ones.
+ *
+ * The supported locales are canonicalized once, at construction
+ * time, with [func@locale_canonicalize], so the negotiated locales
+ * are always canonical language tags and can be used as cache keys
+ * for locale-dependent objects.
+ *
+ * The languages in an `Accept-Language` header are tried in order of
+ * quality, and each one matches the supported locales with the same
+ * language and script once their likely subtags are filled in, e.g.
+ * `en-GB` matches `en-US`, as both are written in Latin, while `zh-TW`
+ * does not match `zh-CN`, as one is written in Traditional Chinese and
+ * the other in Simplified Chinese. Among those, an exact match is
+ * preferred, then one with the same region, and then the supported
+ * locale given first. Unlike the locale matcher of ICU4C, the
+ * distances between regions are not taken into account, so `es-MX`
+ * matches the first supported Spanish, rather than `es-419` over
+ * `es-ES`.
+ *
+ * Negotiations are cached by the exact `Accept-Language` header they
+ * were made for, as the same few headers tend to be seen over and
+ * over again.
+ *
+ * A [class@LocaleMatcher] can be shared between threads.
+ */
+
+// A locale ID along with its language, script and region, where the
+// missing ones are filled in with their likely values, e.g. "en" has
+// the script "Latn" and the region "US".
+typedef struct
+{
+  gchar id[ULOC_FULLNAME_CAPACITY];
+  gchar language[ULOC_LANG_CAPACITY];
+  gchar script[ULOC_SCRIPT_CAPACITY];
+  gchar region[ULOC_COUNTRY_CAPACITY];
+} LikelySubtags;
+
+// A language range of an Accept-Language header.
+typedef struct
+{
+  gchar *tag;
+  gdouble quality;
+  guint position;
+} AcceptedLanguage;
+
+struct _IcuLocaleMatcher
+{
+  guint ref_count;
+
+  // The canonical language tags, without duplicates and in the order
+  // they were given, and their likely subtags.
+  GStrv supported;
+  LikelySubtags *supported_subtags;
+  gint32 n_supported;
+
+  GMutex cache_lock;
+  GHashTable *cache;
+};
+
+G_DEFINE_BOXED_TYPE (IcuLocaleMatcher, icu_locale_matcher, icu_locale_matcher_ref, icu_locale_matcher_unref)
+
+static void
+icu_locale_matcher_free (IcuLocaleMatcher *self)
+{
+  g_assert_nonnull (self);
+  g_assert_cmpuint (self->ref_count, ==, 0);
+
+  g_clear_pointer (&self->supported, g_strfreev);
+  g_clear_pointer (&self->supported_subtags, g_free);
+  g_clear_pointer (&self->cache, g_hash_table_unref);
+  g_mutex_clear (&self->cache_lock);
+
+  g_slice_free (IcuLocaleMatcher, self);
+}
+
+static gboolean
+get_likely_subtags (const gchar   *id,
+                    LikelySubtags *subtags)
+{
+  gchar maximized[ULOC_FULLNAME_CAPACITY] = {0};
+  UErrorCode ec = U_ZERO_ERROR;
+
+  if (g_strlcpy (subtags->id, id, sizeof subtags->id) >= sizeof subtags->id)
+    return FALSE;
+
+  uloc_addLikelySubtags (id, maximized, sizeof maximized, &ec);
+  if (U_FAILURE (ec) || ec == U_STRING_NOT_TERMINATED_WARNING)
+    return FALSE;
+
+  uloc_getLanguage (maximized, subtags->language, sizeof subtags->language, &ec);
+  if (U_FAILURE (ec) || ec == U_STRING_NOT_TERMINATED_WARNING)
+    return FALSE;
+
+  uloc_getScript (maximized, subtags->script, sizeof subtags->script, &ec);
+  if (U_FAILURE (ec) || ec == U_STRING_NOT_TERMINATED_WARNING)
+    return FALSE;
+
+  uloc_getCountry (maximized, subtags->region, sizeof subtags->region, &ec);
+
+  return U_SUCCESS (ec) && ec != U_STRING_NOT_TERMINATED_WARNING;
+}
+
+// Scores how well `supported` fits `requested`, from 0 for locales
+// with another language or script to 3 for the same locale.
+static guint
+get_match_score (const LikelySubtags *requested,
+                 const LikelySubtags *supported)
+{
+  if (!g_str_equal (requested->language, supported->language) ||
+      !g_str_equal (requested->script, supported->script))
+    return 0;
+
+  if (g_str_equal (requested->id, supported->id))
+    return 3;
+
+  if (g_str_equal (requested->region, supported->region))
+    return 2;
+
+  return 1;
+}
+
+static void
+accepted_language_clear (AcceptedLanguage *language)
+{
+  g_clear_pointer (&language->tag, g_free);
+}
+
+static gint
+compare_accepted_languages (gconstpointer a,
+                            gconstpointer b)
+{
+  const AcceptedLanguage *language_a = a;
+  const AcceptedLanguage *language_b = b;
+
+  if (language_a->quality != language_b->quality)
+    return language_a->quality > language_b->quality ? -1 : 1;
+
+  return (gint) language_a->position - (gint) language_b->position;
+}
+
+// Splits an Accept-Language header into its language ranges, from the
+// most preferred to the least, skipping the malformed ones and those
+// with a quality of 0.
+static GArray *
+parse_accept_language (const gchar *accept_language)
+{
+  g_autoptr (GArray) languages = NULL;
+  g_auto (GStrv) ranges = NULL;
+  guint i = 0;
+
+  languages = g_array_new (FALSE, FALSE, sizeof (AcceptedLanguage));
+  g_array_set_clear_func (languages, (GDestroyNotify) accepted_language_clear);
+
+  ranges = g_strsplit (accept_language, ",", -1);
+
+  for (i = 0; ranges[i] != NULL; i++)
+    {
+      g_auto (GStrv) params = g_strsplit (ranges[i], ";", -1);
+      AcceptedLanguage language = { .quality = 1.0, .position = i };
+      guint j = 0;
+
+      for (j = 1; params[j] != NULL; j++)
+        {
+          const gchar *param = g_strstrip (params[j]);
+          gchar *end = NULL;
+
+          if (!g_str_has_prefix (param, "q=") && !g_str_has_prefix (param, "Q="))
+            continue;
+
+          language.quality = g_ascii_strtod (param + 2, &end);
+          if (end == param + 2 || *end != '\0' || !(language.quality >= 0.0 && language.quality <= 1.0))
+            language.quality = 0.0;
+        }
+
+      if (*g_strstrip (params[0]) == '\0' || language.quality <= 0.0)
+        continue;
+
+      language.tag = g_strdup (params[0]);
+      g_array_append_val (languages, language);
+    }
+
+  g_array_sort (languages, compare_accepted_languages);
+
+  return g_steal_pointer (&languages);
+}
+
+static const gchar *
+negotiate (IcuLocaleMatcher *self,
+           const gchar      *accept_language)
+{
+  g_autoptr (GArray) languages = NULL;
+  guint i = 0;
+
+  languages = parse_accept_language (accept_language);
+
+  for (i = 0; i < languages->len && i < MAX_ACCEPTED_LANGUAGES; i++)
+    {
+      const AcceptedLanguage *language = &g_array_index (languages, AcceptedLanguage, i);
+      LikelySubtags requested = {0};
+      gchar id[ULOC_FULLNAME_CAPACITY] = {0};
+      gint32 parsed_length = 0;
+      gint32 best = -1;
+      guint best_score = 0;
+      gint32 j = 0;
+      UErrorCode ec = U_ZERO_ERROR;
+
+      // Anything else is as good as the default locale.
+      if (g_str_equal (language->tag, "*"))
+        break;
+
+      uloc_forLanguageTag (language->tag, id, sizeof id, &parsed_length, &ec);
+      if (U_FAILURE (ec) || ec == U_STRING_NOT_TERMINATED_WARNING || (gsize) parsed_length != strlen (language->tag))
+        continue;
+
+      if (!get_likely_subtags (id, &requested))
+        continue;
+
+      for (j = 0; j < self->n_supported; j++)
+        {
+          guint score = get_match_score (&requested, &self->supported_subtags[j]);
+
+          if (score > best_score)
+            {
+              best = j;
+              best_score = score;
+            }
+        }
+
+      if (best >= 0)
+        return self->supported[best];
+    }
+
+  return self->supported[0];
+}
+
+/**
+ * icu_locale_matcher_new:
+ * @supported: (array zero-terminated=1): The locales to negotiate
+ *   between, as ICU locale IDs or BCP 47 language tags, in order of
+ *   preference. The first one is used when nothing else matches.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Creates a new [class@LocaleMatcher].
+ *
+ * Returns: (transfer full): A newly created [class@LocaleMatcher].
+ */
+IcuLocaleMatcher *
+icu_locale_matcher_new (const gchar * const  *supported,
+                        GError              **error)
+{
+  g_autoptr (IcuLocaleMatcher) self = NULL;
+  g_autoptr (GPtrArray) tags = NULL;
+  g_autoptr (GArray) subtags = NULL;
+  gsize i = 0;
+
+  g_return_val_if_fail (supported != NULL, NULL);
+
+  if (supported[0] == NULL)
+    {
+      icu_has_failed (U_ILLEGAL_ARGUMENT_ERROR, error);
+      return NULL;
+    }
+
+  self = g_slice_new0 (IcuLocaleMatcher);
+  self->ref_count = 1;
+  g_mutex_init (&self->cache_lock);
+
+  tags = g_ptr_array_new_with_free_func (g_free);
+  subtags = g_array_new (FALSE, TRUE, sizeof (LikelySubtags));
+
+  for (i = 0; supported[i] != NULL; i++)
+    {
+      g_autofree gchar *tag = NULL;
+      gchar id[ULOC_FULLNAME_CAPACITY] = {0};
+      LikelySubtags likely = {0};
+      UErrorCode ec = U_ZERO_ERROR;
+
+      tag = icu_locale_canonicalize (supported[i], error);
+      if (tag == NULL)
+        return NULL;
+
+      if (g_ptr_array_find_with_equal_func (tags, tag, g_str_equal, NULL))
+        continue;
+
+      uloc_forLanguageTag (tag, id, sizeof id, NULL, &ec);
+      if (ec == U_STRING_NOT_TERMINATED_WARNING)
+        ec = U_BUFFER_OVERFLOW_ERROR;
+
+      if (icu_has_failed (ec, error))
+        return NULL;
+
+      if (!get_likely_subtags (id, &likely))
+        {
+          icu_has_failed (U_ILLEGAL_ARGUMENT_ERROR, error);
+          return NULL;
+        }
+
+      g_ptr_array_add (tags, g_steal_pointer (&tag));
+      g_array_append_val (subtags, likely);
+    }
+
+  self->n_supported = subtags->len;
+  g_ptr_array_add (tags, NULL);
+
+  self->supported = (GStrv) g_ptr_array_free (g_steal_pointer (&tags), FALSE);
+  self->supported_subtags = (LikelySubtags *) (gpointer) g_array_free (g_steal_pointer (&subtags), FALSE);
+  self->cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+  return g_steal_pointer (&self);
+}
+
+/**
+ * icu_locale_matcher_ref:
+ * @self: A [class@LocaleMatcher].
+ *
+ * Increases the reference count of `self` by one.
+ *
+ * Returns: (transfer full): The passed in [class@LocaleMatcher].
+ */
+IcuLocaleMatcher *
+icu_locale_matcher_ref (IcuLocaleMatcher *self)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+
+  g_atomic_int_inc (&self->ref_count);
+
+  return self;
+}
+
+/**
+ * icu_locale_matcher_unref:
+ * @self: A [class@LocaleMatcher].
+ *
+ * Decreases the reference count of `self` by one.
+ *
+ * If the resulting reference count is zero, frees the memory of
+ * `self`.
+ */
+void
+icu_locale_matcher_unref (IcuLocaleMatcher *self)
+{
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (self->ref_count >= 1);
+
+  if (g_atomic_int_dec_and_test (&self->ref_count))
+    icu_locale_matcher_free (self);
+}
+
+/**
+ * icu_locale_matcher_get_supported:
+ * @self: A [class@LocaleMatcher].
+ *
+ * Gets the canonical language tags of the supported locales, in
+ * order of preference and without duplicates.
+ *
+ * Returns: (transfer none) (array zero-terminated=1): The supported
+ *   locales.
+ */
+const gchar * const *
+icu_locale_matcher_get_supported (IcuLocaleMatcher *self)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+
+  return (const gchar * const *) self->supported;
+}
+
+/**
+ * icu_locale_matcher_get_default:
+ * @self: A [class@LocaleMatcher].
+ *
+ * Gets the locale negotiated when nothing else matches, which is the
+ * first supported one.
+ *
+ * Returns: (transfer none): The canonical language tag of the default
+ *   locale.
+ */
+const gchar *
+icu_locale_matcher_get_default (IcuLocaleMatcher *self)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+
+  return self->supported[0];
+}
+
+/**
+ * icu_locale_matcher_match:
+ * @self: A [class@LocaleMatcher].
+ * @accept_language: (nullable): The value of an `Accept-Language`
+ *   HTTP header, or a single language tag.
+ *
+ * Negotiates the supported locale that best fits `accept_language`.
+ *
+ * If no supported locale is acceptable, or if `accept_language` is
+ * `NULL` or malformed, the default locale is returned.
+ *
+ * Returns: (transfer none): The canonical language tag of the
+ *   negotiated locale, which stays valid for as long as `self` does.
+ */
+const gchar *
+icu_locale_matcher_match (IcuLocaleMatcher *self,
+                          const gchar      *accept_language)
+{
+  const gchar *match = NULL;
+
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+
+  if (accept_language == NULL || *accept_language == '\0')
+    return self->supported[0];
+
+  g_mutex_lock (&self->cache_lock);
+  match = g_hash_table_lookup (self->cache, accept_language);
+  g_mutex_unlock (&self->cache_lock);
+
+  if (match != NULL)
+    return match;
+
+  match = negotiate (self, accept_language);
+
+  g_mutex_lock (&self->cache_lock);
+
+  if (g_hash_table_size (self->cache) >= MAX_CACHED_MATCHES)
+    g_hash_table_remove_all (self->cache);
+
+  g_hash_table_replace (self->cache, g_strdup (accept_language), (gpointer) match);
+
+  g_mutex_unlock (&self->cache_lock);
+
+  return match;
+}
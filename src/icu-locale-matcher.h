@@ -0,0 +1,45 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#pragma once
+
+#if !defined(_ICU_GOBJECT_INSIDE) && !defined(ICU_GOBJECT_COMPILATION)
+#  error "Only <icu-gobject.h> can be included directly"
+#endif
+
+#include <glib-object.h>
+#include "icu-version.h"
+
+G_BEGIN_DECLS
+
+#define ICU_TYPE_LOCALE_MATCHER (icu_locale_matcher_get_type())
+
+typedef struct _IcuLocaleMatcher IcuLocaleMatcher;
+
+ICU_AVAILABLE_IN_ALL
+GType icu_locale_matcher_get_type (void);
+
+ICU_AVAILABLE_IN_ALL
+IcuLocaleMatcher *icu_locale_matcher_new (const gchar * const  *supported,
+                                          GError              **error);
+
+ICU_AVAILABLE_IN_ALL
+IcuLocaleMatcher *icu_locale_matcher_ref   (IcuLocaleMatcher *self);
+ICU_AVAILABLE_IN_ALL
+void              icu_locale_matcher_unref (IcuLocaleMatcher *self);
+
+ICU_AVAILABLE_IN_ALL
+const gchar * const *icu_locale_matcher_get_supported (IcuLocaleMatcher *self);
+ICU_AVAILABLE_IN_ALL
+const gchar         *icu_locale_matcher_get_default   (IcuLocaleMatcher *self);
+
+ICU_AVAILABLE_IN_ALL
+const gchar *icu_locale_matcher_match (IcuLocaleMatcher *self,
+                                       const gchar      *accept_language);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (IcuLocaleMatcher, icu_locale_matcher_unref)
+
+G_END_DECLS
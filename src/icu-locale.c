@@ -0,0 +1,57 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "icu-locale.h"
+
+#include <unicode/uloc.h>
+#include "icu-error-private.h"
+
+/**
+ * icu_locale_canonicalize:
+ * @locale: An ICU locale ID or a BCP 47 language tag.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Canonicalizes `locale` into a BCP 47 language tag.
+ *
+ * Equivalent spellings of the same locale, such as `en_US`, `en-US`
+ * and `en-us`, as well as deprecated codes like `iw`, all map to the
+ * same tag (`en-US` and `he` respectively), which makes the result
+ * suitable as a key for caching locale-dependent objects.
+ *
+ * Returns: (transfer full): The canonical language tag, or `NULL`
+ *   if `error` is set.
+ */
+gchar *
+icu_locale_canonicalize (const gchar  *locale,
+                         GError      **error)
+{
+  gchar id[ULOC_FULLNAME_CAPACITY] = {0};
+  gchar tag[ULOC_FULLNAME_CAPACITY] = {0};
+  gint32 length = 0;
+  UErrorCode ec = U_ZERO_ERROR;
+
+  g_return_val_if_fail (locale != NULL, NULL);
+
+  // uloc_canonicalize() accepts both separators and normalizes the
+  // case of every subtag, but only uloc_toLanguageTag() applies the
+  // CLDR alias mappings and turns keywords into extensions.
+  uloc_canonicalize (locale, id, sizeof id, &ec);
+  if (ec == U_STRING_NOT_TERMINATED_WARNING)
+    ec = U_BUFFER_OVERFLOW_ERROR;
+
+  if (icu_has_failed (ec, error))
+    return NULL;
+
+  length = uloc_toLanguageTag (id, tag, sizeof tag, FALSE, &ec);
+  if (ec == U_STRING_NOT_TERMINATED_WARNING)
+    ec = U_BUFFER_OVERFLOW_ERROR;
+
+  if (icu_has_failed (ec, error))
+    return NULL;
+
+  return g_strndup (tag, length);
+}
@@ -0,0 +1,22 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#pragma once
+
+#if !defined(_ICU_GOBJECT_INSIDE) && !defined(ICU_GOBJECT_COMPILATION)
+#  error "Only <icu-gobject.h> can be included directly"
+#endif
+
+#include <glib.h>
+#include "icu-version.h"
+
+G_BEGIN_DECLS
+
+ICU_AVAILABLE_IN_ALL
+gchar *icu_locale_canonicalize (const gchar  *locale,
+                                GError      **error);
+
+G_END_DECLS
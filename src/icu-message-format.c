@@ -0,0 +1,1424 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "icu-message-format.h"
+
+#include <string.h>
+#include <unicode/ucurr.h>
+#include <unicode/uloc.h>
+#include <unicode/upluralrules.h>
+#include <unicode/ustring.h>
+#include "icu-error-private.h"
+#include "icu-locale.h"
+#include "icu-number-formatter.h"
+#include "icu-number-formatter-private.h"
+#include "icu-shared-cache-private.h"
+#include "icu-utf8-private.h"
+
+// Far more templates than any application has.
+#define MAX_SHARED_MESSAGES 1024
+
+// Deeper than any real template, while keeping the recursion of the
+// parser and formatter bounded.
+#define MAX_NESTING 32
+
+// ICU plural keywords are at most "other", "three" and the like.
+#define MAX_KEYWORD_LENGTH 32
+
+// The skeletons of plain numbers and of the percent style. They must
+// give the same output as the formats of NumberFormat::createInstance()
+// and NumberFormat::createPercentInstance(), which ICU's MessageFormat
+// uses, so numbers show up to 3 fraction digits and percentages none.
+#define NUMBER_SKELETON ".###"
+#define PERCENT_SKELETON "percent scale/100 precision-integer"
+
+/**
+ * IcuMessageFormat:
+ *
+ * Formats messages out of compiled MessageFormat patterns.
+ *
+ * Patterns are compiled once, when the message format is created,
+ * and can then be formatted from any number of threads at once. The
+ * number formatters the pattern needs come from the cache of
+ * [func@NumberFormatter.get_shared], so they are shared with the rest
+ * of the process.
+ *
+ * Patterns follow the ICU MessageFormat syntax, including its
+ * apostrophe quoting, with these kinds of arguments:
+ *
+ * - `{name}`, which formats numbers like `{name, number}` does and
+ *   inserts anything else as is.
+ * - `{name, number}`, optionally followed by the `integer`, `percent`
+ *   or `currency` styles, or by a number skeleton after `::`, e.g.
+ *   `{size, number, :: unit/megabyte}`.
+ * - `{name, plural, ...}` and `{name, selectordinal, ...}`, with an
+ *   optional `offset:` and `=N` or keyword variants, in which `#`
+ *   stands for the formatted number.
+ * - `{name, select, ...}`, picking a variant by string.
+ *
+ * Other argument types, like dates or choices, are rejected with
+ * [error@StandardError.UNSUPPORTED_ERROR]. Arguments missing when
+ * formatting are written as `{name}`, like ICU does.
+ */
+
+typedef enum {
+  PART_TEXT,
+  PART_ARGUMENT,
+  PART_NUMBER,
+  PART_PLURAL,
+  PART_SELECT,
+  PART_POUND,
+} PartType;
+
+// A variant of a plural or select argument. Exact matches of plural
+// arguments have no keyword.
+typedef struct
+{
+  gchar *keyword;
+  gdouble exact;
+  GPtrArray *parts;
+} Variant;
+
+typedef struct
+{
+  PartType type;
+
+  // The literal text of text parts, already unquoted.
+  gchar *text;
+  gsize length;
+
+  // The argument of every other part but the pound ones.
+  guint slot;
+  IcuNumberFormatter *formatter;
+  const UPluralRules *rules;
+  gdouble offset;
+  GPtrArray *variants;
+} Part;
+
+typedef enum {
+  ARG_MISSING,
+  ARG_INT,
+  ARG_DOUBLE,
+  ARG_STRING,
+} ArgType;
+
+typedef struct
+{
+  ArgType type;
+  gint64 i;
+  gdouble d;
+  const gchar *s;
+} Arg;
+
+// The number `#` stands for in the variants of a plural argument.
+typedef struct
+{
+  IcuNumberFormatter *formatter;
+  Arg number;
+} PluralContext;
+
+typedef struct
+{
+  IcuMessageFormat *self;
+  const gchar *pattern;
+  const gchar *p;
+  guint depth;
+} Parser;
+
+struct _IcuMessageFormat
+{
+  guint ref_count;
+
+  gchar *pattern;
+  gchar *locale;
+  gchar *locale_id;
+
+  GPtrArray *parts;
+
+  // The names of the arguments, indexed by slot, and their position
+  // when they are numbers.
+  GPtrArray *arg_names;
+  GArray *arg_positions;
+
+  UPluralRules *cardinal_rules;
+  UPluralRules *ordinal_rules;
+};
+
+// Message formats shared by everyone asking for the same pattern and
+// locale, keyed by the canonical language tag and the pattern.
+static IcuSharedCache shared_messages = ICU_SHARED_CACHE_INIT (icu_message_format_ref, icu_message_format_unref,
+                                                              MAX_SHARED_MESSAGES);
+
+// A result reused by every call on the same thread.
+static GPrivate scratch_result = G_PRIVATE_INIT ((GDestroyNotify) unumf_closeResult);
+
+static gboolean parse_message (Parser     *parser,
+                               gboolean    in_plural,
+                               GPtrArray  *parts,
+                               GError    **error);
+
+static gboolean format_parts (IcuMessageFormat    *self,
+                              GPtrArray           *parts,
+                              const Arg           *args,
+                              const PluralContext *context,
+                              UFormattedNumber    *uresult,
+                              GString             *out,
+                              UErrorCode          *ec);
+
+G_DEFINE_BOXED_TYPE (IcuMessageFormat, icu_message_format, icu_message_format_ref, icu_message_format_unref)
+
+static void
+variant_free (Variant *variant)
+{
+  g_clear_pointer (&variant->keyword, g_free);
+  g_clear_pointer (&variant->parts, g_ptr_array_unref);
+
+  g_free (variant);
+}
+
+static void
+part_free (Part *part)
+{
+  g_clear_pointer (&part->text, g_free);
+  g_clear_pointer (&part->formatter, icu_number_formatter_unref);
+  g_clear_pointer (&part->variants, g_ptr_array_unref);
+
+  g_free (part);
+}
+
+static void
+icu_message_format_free (IcuMessageFormat *self)
+{
+  g_assert_nonnull (self);
+  g_assert_cmpuint (self->ref_count, ==, 0);
+
+  g_clear_pointer (&self->pattern, g_free);
+  g_clear_pointer (&self->locale, g_free);
+  g_clear_pointer (&self->locale_id, g_free);
+  g_clear_pointer (&self->parts, g_ptr_array_unref);
+  g_clear_pointer (&self->arg_names, g_ptr_array_unref);
+  g_clear_pointer (&self->arg_positions, g_array_unref);
+  g_clear_pointer (&self->cardinal_rules, uplrules_close);
+  g_clear_pointer (&self->ordinal_rules, uplrules_close);
+
+  g_slice_free (IcuMessageFormat, self);
+}
+
+static Part *
+add_part (GPtrArray *parts,
+          PartType   type)
+{
+  Part *part = g_new0 (Part, 1);
+
+  part->type = type;
+  g_ptr_array_add (parts, part);
+
+  return part;
+}
+
+static void
+flush_text (GPtrArray *parts,
+            GString   *text)
+{
+  Part *part = NULL;
+
+  if (text->len == 0)
+    return;
+
+  part = add_part (parts, PART_TEXT);
+  part->length = text->len;
+  part->text = g_strndup (text->str, text->len);
+
+  g_string_truncate (text, 0);
+}
+
+// Reports a syntax error at the current position of `parser`, with
+// the context ICU itself would give.
+static gboolean
+set_syntax_error (Parser      *parser,
+                  UErrorCode   ec,
+                  GError     **error)
+{
+  UParseError parse_error = {0};
+  g_autofree gunichar2 *before = NULL;
+  g_autofree gunichar2 *after = NULL;
+  const gchar *start = parser->p;
+  const gchar *end = parser->p;
+  glong offset = 0;
+  glong length = 0;
+  gsize i = 0;
+
+  g_free (g_utf8_to_utf16 (parser->pattern, parser->p - parser->pattern, NULL, &offset, NULL));
+  parse_error.offset = offset;
+
+  for (i = 0; i < U_PARSE_CONTEXT_LEN / 2 - 1 && start > parser->pattern; i++)
+    start = g_utf8_prev_char (start);
+
+  for (i = 0; i < U_PARSE_CONTEXT_LEN / 2 - 1 && *end != '\0'; i++)
+    end = g_utf8_next_char (end);
+
+  before = g_utf8_to_utf16 (start, parser->p - start, NULL, &length, NULL);
+  if (before != NULL)
+    memcpy (parse_error.preContext, before, MIN (length, U_PARSE_CONTEXT_LEN - 1) * sizeof (UChar));
+
+  after = g_utf8_to_utf16 (parser->p, end - parser->p, NULL, &length, NULL);
+  if (after != NULL)
+    memcpy (parse_error.postContext, after, MIN (length, U_PARSE_CONTEXT_LEN - 1) * sizeof (UChar));
+
+  return !icu_has_failed_with_parse_error (ec, &parse_error, error);
+}
+
+static void
+skip_whitespace (Parser *parser)
+{
+  while (g_ascii_isspace (*parser->p))
+    parser->p++;
+}
+
+// Reads an argument name or keyword, which runs until whitespace or
+// a syntax character.
+static gchar *
+read_identifier (Parser *parser)
+{
+  const gchar *start = parser->p;
+
+  while (*parser->p != '\0' && !g_ascii_isspace (*parser->p) && strchr ("{},=#':", *parser->p) == NULL)
+    parser->p++;
+
+  if (parser->p == start)
+    return NULL;
+
+  return g_strndup (start, parser->p - start);
+}
+
+static gboolean
+read_number (Parser  *parser,
+             gdouble *number)
+{
+  gchar *end = NULL;
+
+  // Only plain decimal numbers, not the hexadecimal or infinite ones
+  // g_ascii_strtod() also understands.
+  if (!g_ascii_isdigit (*parser->p) && *parser->p != '-' && *parser->p != '+')
+    return FALSE;
+
+  *number = g_ascii_strtod (parser->p, &end);
+  if (end == parser->p)
+    return FALSE;
+
+  parser->p = end;
+
+  return TRUE;
+}
+
+static gboolean
+expect (Parser  *parser,
+        gchar    c,
+        GError **error)
+{
+  skip_whitespace (parser);
+
+  if (*parser->p == '\0')
+    return set_syntax_error (parser, U_UNMATCHED_BRACES, error);
+
+  if (*parser->p != c)
+    return set_syntax_error (parser, U_PATTERN_SYNTAX_ERROR, error);
+
+  parser->p++;
+
+  return TRUE;
+}
+
+static guint
+get_slot (IcuMessageFormat *self,
+          gchar            *name)
+{
+  guint64 position = 0;
+  gint stored = -1;
+  guint i = 0;
+
+  for (i = 0; i < self->arg_names->len; i++)
+    {
+      if (g_str_equal (g_ptr_array_index (self->arg_names, i), name))
+        {
+          g_free (name);
+          return i;
+        }
+    }
+
+  if (g_ascii_string_to_unsigned (name, 10, 0, G_MAXINT, &position, NULL))
+    stored = (gint) position;
+
+  g_ptr_array_add (self->arg_names, name);
+  g_array_append_val (self->arg_positions, stored);
+
+  return self->arg_names->len - 1;
+}
+
+static gboolean
+parse_number_style (Parser  *parser,
+                    Part    *part,
+                    GError **error)
+{
+  IcuMessageFormat *self = parser->self;
+  g_autofree gchar *style = NULL;
+  g_autofree gchar *skeleton = NULL;
+  const gchar *start = NULL;
+  guint nesting = 0;
+
+  skip_whitespace (parser);
+  start = parser->p;
+
+  while (*parser->p != '\0' && (*parser->p != '}' || nesting > 0))
+    {
+      if (*parser->p == '{')
+        nesting++;
+      else if (*parser->p == '}')
+        nesting--;
+
+      parser->p++;
+    }
+
+  style = g_strstrip (g_strndup (start, parser->p - start));
+
+  if (g_str_has_prefix (style, "::"))
+    skeleton = g_strdup (style + 2);
+  else if (g_str_equal (style, "integer"))
+    skeleton = g_strdup ("precision-integer");
+  else if (g_str_equal (style, "percent"))
+    skeleton = g_strdup (PERCENT_SKELETON);
+  else if (g_str_equal (style, "currency"))
+    {
+      UChar ucurrency[4] = {0};
+      gchar currency[4] = {0};
+      UErrorCode ec = U_ZERO_ERROR;
+
+      ucurr_forLocale (self->locale_id, ucurrency, G_N_ELEMENTS (ucurrency), &ec);
+      if (icu_has_failed (ec, error))
+        return FALSE;
+
+      u_UCharsToChars (ucurrency, currency, 3);
+      skeleton = g_strconcat ("currency/", currency, NULL);
+    }
+  else
+    {
+      // Decimal format patterns have no equivalent number skeleton.
+      icu_has_failed (U_UNSUPPORTED_ERROR, error);
+      return FALSE;
+    }
+
+  part->formatter = icu_number_formatter_get_shared (skeleton, self->locale, error);
+
+  return part->formatter != NULL;
+}
+
+static gboolean
+parse_variants (Parser    *parser,
+                Part      *part,
+                gboolean   in_plural,
+                GError   **error)
+{
+  gboolean has_other = FALSE;
+
+  part->variants = g_ptr_array_new_with_free_func ((GDestroyNotify) variant_free);
+
+  if (in_plural)
+    {
+      skip_whitespace (parser);
+
+      if (g_str_has_prefix (parser->p, "offset:"))
+        {
+          parser->p += strlen ("offset:");
+          skip_whitespace (parser);
+
+          if (!read_number (parser, &part->offset))
+            return set_syntax_error (parser, U_PATTERN_SYNTAX_ERROR, error);
+        }
+    }
+
+  while (TRUE)
+    {
+      Variant *variant = NULL;
+
+      skip_whitespace (parser);
+
+      if (*parser->p == '}')
+        break;
+
+      if (*parser->p == '\0')
+        return set_syntax_error (parser, U_UNMATCHED_BRACES, error);
+
+      variant = g_new0 (Variant, 1);
+      variant->parts = g_ptr_array_new_with_free_func ((GDestroyNotify) part_free);
+      g_ptr_array_add (part->variants, variant);
+
+      if (in_plural && *parser->p == '=')
+        {
+          parser->p++;
+
+          if (!read_number (parser, &variant->exact))
+            return set_syntax_error (parser, U_PATTERN_SYNTAX_ERROR, error);
+        }
+      else
+        {
+          variant->keyword = read_identifier (parser);
+          if (variant->keyword == NULL)
+            return set_syntax_error (parser, U_PATTERN_SYNTAX_ERROR, error);
+
+          has_other |= g_str_equal (variant->keyword, "other");
+        }
+
+      if (!expect (parser, '{', error))
+        return FALSE;
+
+      if (!parse_message (parser, in_plural, variant->parts, error))
+        return FALSE;
+
+      if (!expect (parser, '}', error))
+        return FALSE;
+    }
+
+  if (!has_other)
+    return set_syntax_error (parser, U_DEFAULT_KEYWORD_MISSING, error);
+
+  return TRUE;
+}
+
+static const UPluralRules *
+get_rules (IcuMessageFormat  *self,
+           UPluralType        type,
+           GError           **error)
+{
+  UPluralRules **rules = type == UPLURAL_TYPE_ORDINAL ? &self->ordinal_rules : &self->cardinal_rules;
+  UErrorCode ec = U_ZERO_ERROR;
+
+  if (*rules == NULL)
+    {
+      *rules = uplrules_openForType (self->locale_id, type, &ec);
+      if (icu_has_failed (ec, error))
+        return NULL;
+    }
+
+  return *rules;
+}
+
+static gboolean
+parse_argument (Parser     *parser,
+                GPtrArray  *parts,
+                GError    **error)
+{
+  IcuMessageFormat *self = parser->self;
+  g_autofree gchar *type = NULL;
+  gchar *name = NULL;
+  Part *part = NULL;
+  guint slot = 0;
+
+  // Skips the opening brace.
+  parser->p++;
+  skip_whitespace (parser);
+
+  name = read_identifier (parser);
+  if (name == NULL)
+    return set_syntax_error (parser, U_PATTERN_SYNTAX_ERROR, error);
+
+  slot = get_slot (self, name);
+  skip_whitespace (parser);
+
+  if (*parser->p == '}')
+    {
+      parser->p++;
+
+      part = add_part (parts, PART_ARGUMENT);
+      part->slot = slot;
+      part->formatter = icu_number_formatter_get_shared (NUMBER_SKELETON, self->locale, error);
+
+      return part->formatter != NULL;
+    }
+
+  if (!expect (parser, ',', error))
+    return FALSE;
+
+  skip_whitespace (parser);
+
+  type = read_identifier (parser);
+  if (type == NULL)
+    return set_syntax_error (parser, U_PATTERN_SYNTAX_ERROR, error);
+
+  skip_whitespace (parser);
+
+  if (g_str_equal (type, "number"))
+    {
+      part = add_part (parts, PART_NUMBER);
+      part->slot = slot;
+
+      if (*parser->p == ',')
+        {
+          parser->p++;
+
+          if (!parse_number_style (parser, part, error))
+            return FALSE;
+        }
+      else
+        {
+          part->formatter = icu_number_formatter_get_shared (NUMBER_SKELETON, self->locale, error);
+          if (part->formatter == NULL)
+            return FALSE;
+        }
+    }
+  else if (g_str_equal (type, "plural") || g_str_equal (type, "selectordinal"))
+    {
+      part = add_part (parts, PART_PLURAL);
+      part->slot = slot;
+
+      part->rules = get_rules (self, g_str_equal (type, "plural") ? UPLURAL_TYPE_CARDINAL : UPLURAL_TYPE_ORDINAL, error);
+      if (part->rules == NULL)
+        return FALSE;
+
+      part->formatter = icu_number_formatter_get_shared (NUMBER_SKELETON, self->locale, error);
+      if (part->formatter == NULL)
+        return FALSE;
+
+      if (!expect (parser, ',', error) || !parse_variants (parser, part, TRUE, error))
+        return FALSE;
+    }
+  else if (g_str_equal (type, "select"))
+    {
+      part = add_part (parts, PART_SELECT);
+      part->slot = slot;
+
+      if (!expect (parser, ',', error) || !parse_variants (parser, part, FALSE, error))
+        return FALSE;
+    }
+  else if (g_str_equal (type, "choice") || g_str_equal (type, "date") || g_str_equal (type, "time") ||
+           g_str_equal (type, "spellout") || g_str_equal (type, "ordinal") || g_str_equal (type, "duration"))
+    {
+      icu_has_failed (U_UNSUPPORTED_ERROR, error);
+      return FALSE;
+    }
+  else
+    return set_syntax_error (parser, U_PATTERN_SYNTAX_ERROR, error);
+
+  return expect (parser, '}', error);
+}
+
+// Parses a message up to the end of the pattern, or up to the brace
+// closing it when nested, which is left for the caller to skip.
+static gboolean
+parse_message (Parser     *parser,
+               gboolean    in_plural,
+               GPtrArray  *parts,
+               GError    **error)
+{
+  g_autoptr (GString) text = NULL;
+  gboolean nested = parser->depth > 0;
+
+  if (parser->depth >= MAX_NESTING)
+    return set_syntax_error (parser, U_PATTERN_SYNTAX_ERROR, error);
+
+  parser->depth++;
+  text = g_string_new (NULL);
+
+  while (TRUE)
+    {
+      gchar c = *parser->p;
+
+      if (c == '\0')
+        {
+          if (nested)
+            return set_syntax_error (parser, U_UNMATCHED_BRACES, error);
+
+          break;
+        }
+
+      if (c == '}')
+        {
+          if (!nested)
+            return set_syntax_error (parser, U_UNMATCHED_BRACES, error);
+
+          break;
+        }
+
+      if (c == '{')
+        {
+          flush_text (parts, text);
+
+          if (!parse_argument (parser, parts, error))
+            return FALSE;
+
+          continue;
+        }
+
+      if (c == '#' && in_plural)
+        {
+          flush_text (parts, text);
+          add_part (parts, PART_POUND);
+          parser->p++;
+          continue;
+        }
+
+      if (c == '\'' && parser->p[1] == '\'')
+        {
+          g_string_append_c (text, '\'');
+          parser->p += 2;
+          continue;
+        }
+
+      // Apostrophes only quote when followed by a syntax character,
+      // up to the next lone apostrophe.
+      if (c == '\'' && (parser->p[1] == '{' || parser->p[1] == '}' || (in_plural && parser->p[1] == '#')))
+        {
+          parser->p++;
+
+          while (*parser->p != '\0')
+            {
+              if (*parser->p == '\'' && parser->p[1] == '\'')
+                {
+                  g_string_append_c (text, '\'');
+                  parser->p += 2;
+                }
+              else if (*parser->p == '\'')
+                {
+                  parser->p++;
+                  break;
+                }
+              else
+                g_string_append_c (text, *parser->p++);
+            }
+
+          continue;
+        }
+
+      g_string_append_c (text, c);
+      parser->p++;
+    }
+
+  flush_text (parts, text);
+  parser->depth--;
+
+  return TRUE;
+}
+
+static void
+append_number (IcuNumberFormatter *formatter,
+               const Arg          *number,
+               UFormattedNumber   *uresult,
+               GString            *out,
+               UErrorCode         *ec)
+{
+  const UNumberFormatter *uformatter = icu_number_formatter_get_uformatter (formatter);
+  const UFormattedValue *ufmtval = NULL;
+  const UChar *ustring = NULL;
+  gint32 length = 0;
+
+  if (number->type == ARG_INT)
+    unumf_formatInt (uformatter, number->i, uresult, ec);
+  else
+    unumf_formatDouble (uformatter, number->d, uresult, ec);
+
+  ufmtval = unumf_resultAsValue (uresult, ec);
+  if (U_FAILURE (*ec))
+    return;
+
+  ustring = ufmtval_getString (ufmtval, &length, ec);
+  icu_utf8_append_utf16 (out, ustring, length, ec);
+}
+
+static void
+append_missing (IcuMessageFormat *self,
+                guint             slot,
+                GString          *out)
+{
+  g_string_append_c (out, '{');
+  g_string_append (out, g_ptr_array_index (self->arg_names, slot));
+  g_string_append_c (out, '}');
+}
+
+static Variant *
+select_plural (Part             *part,
+               const Arg        *number,
+               UFormattedNumber *uresult,
+               UErrorCode       *ec)
+{
+  UChar ukeyword[MAX_KEYWORD_LENGTH] = {0};
+  gchar keyword[MAX_KEYWORD_LENGTH] = {0};
+  gdouble value = number->type == ARG_INT ? (gdouble) number->i : number->d;
+  Variant *other = NULL;
+  gint32 length = 0;
+  guint i = 0;
+
+  // Exact matches take precedence and ignore the offset.
+  for (i = 0; i < part->variants->len; i++)
+    {
+      Variant *variant = g_ptr_array_index (part->variants, i);
+
+      if (variant->keyword == NULL && variant->exact == value)
+        return variant;
+    }
+
+  unumf_formatDouble (icu_number_formatter_get_uformatter (part->formatter), value - part->offset, uresult, ec);
+
+  // Selecting on the formatted number takes the visible fraction
+  // digits into account, so 1.0 is not "one" in English.
+  length = uplrules_selectFormatted (part->rules, uresult, ukeyword, G_N_ELEMENTS (ukeyword), ec);
+  if (U_FAILURE (*ec))
+    return NULL;
+
+  u_UCharsToChars (ukeyword, keyword, MIN (length, MAX_KEYWORD_LENGTH - 1));
+
+  for (i = 0; i < part->variants->len; i++)
+    {
+      Variant *variant = g_ptr_array_index (part->variants, i);
+
+      if (variant->keyword == NULL)
+        continue;
+
+      if (g_str_equal (variant->keyword, keyword))
+        return variant;
+
+      if (g_str_equal (variant->keyword, "other"))
+        other = variant;
+    }
+
+  return other;
+}
+
+static Variant *
+select_string (Part        *part,
+               const gchar *string)
+{
+  Variant *other = NULL;
+  guint i = 0;
+
+  for (i = 0; i < part->variants->len; i++)
+    {
+      Variant *variant = g_ptr_array_index (part->variants, i);
+
+      if (g_str_equal (variant->keyword, string))
+        return variant;
+
+      if (g_str_equal (variant->keyword, "other"))
+        other = variant;
+    }
+
+  return other;
+}
+
+static gboolean
+format_parts (IcuMessageFormat    *self,
+              GPtrArray           *parts,
+              const Arg           *args,
+              const PluralContext *context,
+              UFormattedNumber    *uresult,
+              GString             *out,
+              UErrorCode          *ec)
+{
+  guint i = 0;
+
+  for (i = 0; i < parts->len && U_SUCCESS (*ec); i++)
+    {
+      Part *part = g_ptr_array_index (parts, i);
+      const Arg *arg = NULL;
+      PluralContext nested = {0};
+      Variant *variant = NULL;
+
+      if (part->type == PART_TEXT)
+        {
+          g_string_append_len (out, part->text, part->length);
+          continue;
+        }
+
+      if (part->type == PART_POUND)
+        {
+          append_number (context->formatter, &context->number, uresult, out, ec);
+          continue;
+        }
+
+      arg = &args[part->slot];
+
+      if (arg->type == ARG_MISSING)
+        {
+          append_missing (self, part->slot, out);
+          continue;
+        }
+
+      switch (part->type)
+        {
+        case PART_ARGUMENT:
+        case PART_NUMBER:
+          if (arg->type == ARG_STRING)
+            g_string_append (out, arg->s);
+          else
+            append_number (part->formatter, arg, uresult, out, ec);
+          break;
+
+        case PART_PLURAL:
+          if (arg->type == ARG_STRING)
+            {
+              *ec = U_ARGUMENT_TYPE_MISMATCH;
+              break;
+            }
+
+          variant = select_plural (part, arg, uresult, ec);
+          if (variant == NULL)
+            break;
+
+          nested.formatter = part->formatter;
+          nested.number = *arg;
+
+          if (part->offset != 0 && arg->type == ARG_INT && part->offset == (gint64) part->offset)
+            nested.number.i -= (gint64) part->offset;
+          else if (part->offset != 0)
+            {
+              nested.number.type = ARG_DOUBLE;
+              nested.number.d = (arg->type == ARG_INT ? (gdouble) arg->i : arg->d) - part->offset;
+            }
+
+          format_parts (self, variant->parts, args, &nested, uresult, out, ec);
+          break;
+
+        case PART_SELECT:
+          if (arg->type != ARG_STRING)
+            {
+              *ec = U_ARGUMENT_TYPE_MISMATCH;
+              break;
+            }
+
+          variant = select_string (part, arg->s);
+          format_parts (self, variant->parts, args, context, uresult, out, ec);
+          break;
+
+        case PART_TEXT:
+        case PART_POUND:
+        default:
+          g_assert_not_reached ();
+        }
+    }
+
+  return U_SUCCESS (*ec);
+}
+
+static gboolean
+format_args (IcuMessageFormat  *self,
+             const Arg         *args,
+             GString           *out,
+             GError           **error)
+{
+  UFormattedNumber *uresult = NULL;
+  gsize start = out->len;
+  UErrorCode ec = U_ZERO_ERROR;
+
+  uresult = g_private_get (&scratch_result);
+  if (uresult == NULL)
+    {
+      uresult = unumf_openResult (&ec);
+      if (icu_has_failed (ec, error))
+        return FALSE;
+
+      g_private_set (&scratch_result, uresult);
+    }
+
+  format_parts (self, self->parts, args, NULL, uresult, out, &ec);
+
+  if (icu_has_failed (ec, error))
+    {
+      g_string_truncate (out, start);
+      return FALSE;
+    }
+
+  return TRUE;
+}
+
+static gboolean
+variant_to_arg (GVariant *value,
+                Arg      *arg)
+{
+  if (g_variant_is_of_type (value, G_VARIANT_TYPE_VARIANT))
+    {
+      g_autoptr (GVariant) inner = g_variant_get_variant (value);
+
+      // The inner value lives as long as the outer one does.
+      return variant_to_arg (inner, arg);
+    }
+
+  arg->type = ARG_INT;
+
+  switch (g_variant_classify (value))
+    {
+    case G_VARIANT_CLASS_BYTE:
+      arg->i = g_variant_get_byte (value);
+      return TRUE;
+
+    case G_VARIANT_CLASS_INT16:
+      arg->i = g_variant_get_int16 (value);
+      return TRUE;
+
+    case G_VARIANT_CLASS_UINT16:
+      arg->i = g_variant_get_uint16 (value);
+      return TRUE;
+
+    case G_VARIANT_CLASS_INT32:
+      arg->i = g_variant_get_int32 (value);
+      return TRUE;
+
+    case G_VARIANT_CLASS_UINT32:
+      arg->i = g_variant_get_uint32 (value);
+      return TRUE;
+
+    case G_VARIANT_CLASS_INT64:
+      arg->i = g_variant_get_int64 (value);
+      return TRUE;
+
+    case G_VARIANT_CLASS_UINT64:
+      if (g_variant_get_uint64 (value) <= G_MAXINT64)
+        {
+          arg->i = (gint64) g_variant_get_uint64 (value);
+          return TRUE;
+        }
+
+      arg->type = ARG_DOUBLE;
+      arg->d = (gdouble) g_variant_get_uint64 (value);
+      return TRUE;
+
+    case G_VARIANT_CLASS_DOUBLE:
+      arg->type = ARG_DOUBLE;
+      arg->d = g_variant_get_double (value);
+      return TRUE;
+
+    case G_VARIANT_CLASS_STRING:
+    case G_VARIANT_CLASS_OBJECT_PATH:
+    case G_VARIANT_CLASS_SIGNATURE:
+      arg->type = ARG_STRING;
+      arg->s = g_variant_get_string (value, NULL);
+      return TRUE;
+
+    case G_VARIANT_CLASS_BOOLEAN:
+    case G_VARIANT_CLASS_HANDLE:
+    case G_VARIANT_CLASS_VARIANT:
+    case G_VARIANT_CLASS_MAYBE:
+    case G_VARIANT_CLASS_ARRAY:
+    case G_VARIANT_CLASS_TUPLE:
+    case G_VARIANT_CLASS_DICT_ENTRY:
+    default:
+      arg->type = ARG_MISSING;
+      return FALSE;
+    }
+}
+
+static gboolean
+value_to_arg (const GValue *value,
+              Arg          *arg)
+{
+  arg->type = ARG_INT;
+
+  switch (G_TYPE_FUNDAMENTAL (G_VALUE_TYPE (value)))
+    {
+    case G_TYPE_INT:
+      arg->i = g_value_get_int (value);
+      return TRUE;
+
+    case G_TYPE_UINT:
+      arg->i = g_value_get_uint (value);
+      return TRUE;
+
+    case G_TYPE_LONG:
+      arg->i = g_value_get_long (value);
+      return TRUE;
+
+    case G_TYPE_ULONG:
+      if (g_value_get_ulong (value) <= G_MAXINT64)
+        {
+          arg->i = (gint64) g_value_get_ulong (value);
+          return TRUE;
+        }
+
+      arg->type = ARG_DOUBLE;
+      arg->d = (gdouble) g_value_get_ulong (value);
+      return TRUE;
+
+    case G_TYPE_INT64:
+      arg->i = g_value_get_int64 (value);
+      return TRUE;
+
+    case G_TYPE_UINT64:
+      if (g_value_get_uint64 (value) <= G_MAXINT64)
+        {
+          arg->i = (gint64) g_value_get_uint64 (value);
+          return TRUE;
+        }
+
+      arg->type = ARG_DOUBLE;
+      arg->d = (gdouble) g_value_get_uint64 (value);
+      return TRUE;
+
+    case G_TYPE_FLOAT:
+      arg->type = ARG_DOUBLE;
+      arg->d = g_value_get_float (value);
+      return TRUE;
+
+    case G_TYPE_DOUBLE:
+      arg->type = ARG_DOUBLE;
+      arg->d = g_value_get_double (value);
+      return TRUE;
+
+    case G_TYPE_STRING:
+      arg->type = ARG_STRING;
+      arg->s = g_value_get_string (value);
+
+      // A NULL string is as good as a missing argument.
+      if (arg->s == NULL)
+        arg->type = ARG_MISSING;
+
+      return TRUE;
+
+    default:
+      arg->type = ARG_MISSING;
+      return FALSE;
+    }
+}
+
+static gchar *
+get_shared_key (const gchar  *pattern,
+                const gchar  *locale,
+                GError      **error)
+{
+  g_autofree gchar *tag = NULL;
+
+  // Language tags never contain spaces, so the key is unambiguous
+  // whatever the pattern looks like.
+  tag = icu_locale_canonicalize (locale != NULL ? locale : uloc_getDefault (), error);
+  if (tag == NULL)
+    return NULL;
+
+  return g_strconcat (tag, " ", pattern, NULL);
+}
+
+/**
+ * icu_message_format_new:
+ * @pattern: The MessageFormat pattern to compile.
+ * @locale: (nullable): The locale to format for, or `NULL` to use the
+ *   default locale.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Compiles `pattern` into a new [class@MessageFormat].
+ *
+ * Syntax errors tell where in `pattern` parsing failed.
+ *
+ * Returns: (transfer full): A newly created [class@MessageFormat], or
+ *   `NULL` if `error` is set.
+ */
+IcuMessageFormat *
+icu_message_format_new (const gchar  *pattern,
+                        const gchar  *locale,
+                        GError      **error)
+{
+  g_autoptr (IcuMessageFormat) self = NULL;
+  gchar id[ULOC_FULLNAME_CAPACITY] = {0};
+  Parser parser = {0};
+  UErrorCode ec = U_ZERO_ERROR;
+
+  g_return_val_if_fail (pattern != NULL, NULL);
+
+  if (!g_utf8_validate (pattern, -1, NULL))
+    {
+      icu_has_failed (U_INVALID_CHAR_FOUND, error);
+      return NULL;
+    }
+
+  self = g_slice_new0 (IcuMessageFormat);
+  self->ref_count = 1;
+  self->pattern = g_strdup (pattern);
+  self->parts = g_ptr_array_new_with_free_func ((GDestroyNotify) part_free);
+  self->arg_names = g_ptr_array_new_with_free_func (g_free);
+  self->arg_positions = g_array_new (FALSE, FALSE, sizeof (gint));
+
+  self->locale = icu_locale_canonicalize (locale != NULL ? locale : uloc_getDefault (), error);
+  if (self->locale == NULL)
+    return NULL;
+
+  uloc_forLanguageTag (self->locale, id, sizeof id, NULL, &ec);
+  if (ec == U_STRING_NOT_TERMINATED_WARNING)
+    ec = U_BUFFER_OVERFLOW_ERROR;
+
+  if (icu_has_failed (ec, error))
+    return NULL;
+
+  self->locale_id = g_strdup (id);
+
+  parser.self = self;
+  parser.pattern = self->pattern;
+  parser.p = self->pattern;
+
+  if (!parse_message (&parser, FALSE, self->parts, error))
+    return NULL;
+
+  return g_steal_pointer (&self);
+}
+
+static gpointer
+build_shared_message (const gchar  *key,
+                      gpointer      user_data,
+                      GError      **error)
+{
+  const gchar **args = user_data;
+
+  return icu_message_format_new (args[0], args[1], error);
+}
+
+/**
+ * icu_message_format_get_shared:
+ * @pattern: The MessageFormat pattern to compile.
+ * @locale: (nullable): The locale to format for, or `NULL` to use the
+ *   default locale.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Gets a message format for `pattern` and `locale` out of a cache
+ * shared by the whole process, compiling it on first use.
+ *
+ * Equivalent spellings of `locale` share the same message format,
+ * see [func@locale_canonicalize].
+ *
+ * Returns: (transfer full): The shared [class@MessageFormat], or
+ *   `NULL` if `error` is set.
+ */
+IcuMessageFormat *
+icu_message_format_get_shared (const gchar  *pattern,
+                               const gchar  *locale,
+                               GError      **error)
+{
+  g_autofree gchar *key = NULL;
+  const gchar *args[] = { pattern, locale };
+
+  g_return_val_if_fail (pattern != NULL, NULL);
+
+  key = get_shared_key (pattern, locale, error);
+  if (key == NULL)
+    return NULL;
+
+  return icu_shared_cache_get (&shared_messages, key, build_shared_message, args, error);
+}
+
+/**
+ * icu_message_format_ref:
+ * @self: An [class@MessageFormat].
+ *
+ * Increases the reference count of `self` by one.
+ *
+ * Returns: (transfer full): The passed in [class@MessageFormat].
+ */
+IcuMessageFormat *
+icu_message_format_ref (IcuMessageFormat *self)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+
+  g_atomic_int_inc (&self->ref_count);
+
+  return self;
+}
+
+/**
+ * icu_message_format_unref:
+ * @self: An [class@MessageFormat].
+ *
+ * Decreases the reference count of `self` by one.
+ *
+ * If the resulting reference count is zero, frees the memory of
+ * `self`.
+ */
+void
+icu_message_format_unref (IcuMessageFormat *self)
+{
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (self->ref_count >= 1);
+
+  if (g_atomic_int_dec_and_test (&self->ref_count))
+    icu_message_format_free (self);
+}
+
+/**
+ * icu_message_format_get_pattern:
+ * @self: An [class@MessageFormat].
+ *
+ * Gets the pattern `self` was compiled from.
+ *
+ * Returns: The pattern of the message format.
+ */
+const gchar *
+icu_message_format_get_pattern (IcuMessageFormat *self)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+
+  return self->pattern;
+}
+
+/**
+ * icu_message_format_get_locale:
+ * @self: An [class@MessageFormat].
+ *
+ * Gets the canonical language tag of the locale of `self`.
+ *
+ * Returns: The locale of the message format.
+ */
+const gchar *
+icu_message_format_get_locale (IcuMessageFormat *self)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+
+  return self->locale;
+}
+
+/**
+ * icu_message_format_append_variant:
+ * @self: An [class@MessageFormat].
+ * @args: (nullable): The arguments, as a `a{sv}` dictionary or as a
+ *   tuple or array of positional ones.
+ * @out: The string to append the formatted message to.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Formats the message with `args`, appending it to `out`.
+ *
+ * Dictionaries give arguments by name, while tuples and arrays give
+ * them by position, so that the first element is argument `{0}`.
+ * Integers, doubles and strings, optionally boxed in variants, are
+ * supported. Passing a string to a plural argument, or a number to a
+ * select one, fails with [error@FmtParseError.ARGUMENT_TYPE_MISMATCH].
+ *
+ * Returns: `TRUE` on success, `FALSE` if `error` is set, in which case
+ *   `out` is left unchanged.
+ */
+gboolean
+icu_message_format_append_variant (IcuMessageFormat  *self,
+                                   GVariant          *args,
+                                   GString           *out,
+                                   GError           **error)
+{
+  g_autoptr (GPtrArray) values = NULL;
+  g_autofree Arg *arg_values = NULL;
+  gboolean is_dict = FALSE;
+  guint i = 0;
+
+  g_return_val_if_fail (self != NULL, FALSE);
+  g_return_val_if_fail (self->ref_count >= 1, FALSE);
+  g_return_val_if_fail (args == NULL || g_variant_is_container (args), FALSE);
+  g_return_val_if_fail (out != NULL, FALSE);
+
+  // Keeps the argument values, and so their strings, alive until
+  // the message is formatted.
+  values = g_ptr_array_new_with_free_func ((GDestroyNotify) g_variant_unref);
+  arg_values = g_new0 (Arg, self->arg_names->len);
+
+  is_dict = args != NULL && g_variant_is_of_type (args, G_VARIANT_TYPE_VARDICT);
+
+  for (i = 0; i < self->arg_names->len && args != NULL; i++)
+    {
+      gint position = g_array_index (self->arg_positions, gint, i);
+      GVariant *value = NULL;
+
+      if (is_dict)
+        value = g_variant_lookup_value (args, g_ptr_array_index (self->arg_names, i), NULL);
+      else if (position >= 0 && (gsize) position < g_variant_n_children (args))
+        value = g_variant_get_child_value (args, position);
+
+      if (value == NULL)
+        continue;
+
+      g_ptr_array_add (values, value);
+
+      if (!variant_to_arg (value, &arg_values[i]))
+        {
+          icu_has_failed (U_ARGUMENT_TYPE_MISMATCH, error);
+          return FALSE;
+        }
+    }
+
+  return format_args (self, arg_values, out, error);
+}
+
+/**
+ * icu_message_format_append_values:
+ * @self: An [class@MessageFormat].
+ * @values: (array length=n_values): The positional arguments.
+ * @n_values: The number of arguments.
+ * @out: The string to append the formatted message to.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Formats the message with `values`, appending it to `out`.
+ *
+ * The first value is argument `{0}`, and so on. Values holding any
+ * integer or floating point type, or strings, are supported.
+ *
+ * Returns: `TRUE` on success, `FALSE` if `error` is set, in which case
+ *   `out` is left unchanged.
+ */
+gboolean
+icu_message_format_append_values (IcuMessageFormat  *self,
+                                  const GValue      *values,
+                                  gsize              n_values,
+                                  GString           *out,
+                                  GError           **error)
+{
+  g_autofree Arg *arg_values = NULL;
+  guint i = 0;
+
+  g_return_val_if_fail (self != NULL, FALSE);
+  g_return_val_if_fail (self->ref_count >= 1, FALSE);
+  g_return_val_if_fail (values != NULL || n_values == 0, FALSE);
+  g_return_val_if_fail (out != NULL, FALSE);
+
+  arg_values = g_new0 (Arg, self->arg_names->len);
+
+  for (i = 0; i < self->arg_names->len; i++)
+    {
+      gint position = g_array_index (self->arg_positions, gint, i);
+
+      if (position < 0 || (gsize) position >= n_values)
+        continue;
+
+      if (!value_to_arg (&values[position], &arg_values[i]))
+        {
+          icu_has_failed (U_ARGUMENT_TYPE_MISMATCH, error);
+          return FALSE;
+        }
+    }
+
+  return format_args (self, arg_values, out, error);
+}
+
+/**
+ * icu_message_format_format_variant:
+ * @self: An [class@MessageFormat].
+ * @args: (nullable): The arguments, as a `a{sv}` dictionary or as a
+ *   tuple or array of positional ones.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Formats the message with `args`, like
+ * [method@MessageFormat.append_variant] does.
+ *
+ * Returns: (transfer full): The formatted message, or `NULL` if
+ *   `error` is set.
+ */
+gchar *
+icu_message_format_format_variant (IcuMessageFormat  *self,
+                                   GVariant          *args,
+                                   GError           **error)
+{
+  g_autoptr (GString) out = NULL;
+
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+
+  out = g_string_new (NULL);
+
+  if (!icu_message_format_append_variant (self, args, out, error))
+    return NULL;
+
+  return g_string_free (g_steal_pointer (&out), FALSE);
+}
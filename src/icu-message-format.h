@@ -0,0 +1,62 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#pragma once
+
+#if !defined(_ICU_GOBJECT_INSIDE) && !defined(ICU_GOBJECT_COMPILATION)
+#  error "Only <icu-gobject.h> can be included directly"
+#endif
+
+#include <glib-object.h>
+#include "icu-version.h"
+
+G_BEGIN_DECLS
+
+#define ICU_TYPE_MESSAGE_FORMAT (icu_message_format_get_type())
+
+typedef struct _IcuMessageFormat IcuMessageFormat;
+
+ICU_AVAILABLE_IN_ALL
+GType icu_message_format_get_type (void);
+
+ICU_AVAILABLE_IN_ALL
+IcuMessageFormat *icu_message_format_new        (const gchar  *pattern,
+                                                 const gchar  *locale,
+                                                 GError      **error);
+ICU_AVAILABLE_IN_ALL
+IcuMessageFormat *icu_message_format_get_shared (const gchar  *pattern,
+                                                 const gchar  *locale,
+                                                 GError      **error);
+
+ICU_AVAILABLE_IN_ALL
+IcuMessageFormat *icu_message_format_ref   (IcuMessageFormat *self);
+ICU_AVAILABLE_IN_ALL
+void              icu_message_format_unref (IcuMessageFormat *self);
+
+ICU_AVAILABLE_IN_ALL
+const gchar *icu_message_format_get_pattern (IcuMessageFormat *self);
+ICU_AVAILABLE_IN_ALL
+const gchar *icu_message_format_get_locale  (IcuMessageFormat *self);
+
+ICU_AVAILABLE_IN_ALL
+gboolean  icu_message_format_append_variant (IcuMessageFormat  *self,
+                                             GVariant          *args,
+                                             GString           *out,
+                                             GError           **error);
+ICU_AVAILABLE_IN_ALL
+gboolean  icu_message_format_append_values  (IcuMessageFormat  *self,
+                                             const GValue      *values,
+                                             gsize              n_values,
+                                             GString           *out,
+                                             GError           **error);
+ICU_AVAILABLE_IN_ALL
+gchar    *icu_message_format_format_variant (IcuMessageFormat  *self,
+                                             GVariant          *args,
+                                             GError           **error);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (IcuMessageFormat, icu_message_format_unref)
+
+G_END_DECLS
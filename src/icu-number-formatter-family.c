@@ -0,0 +1,322 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "icu-number-formatter-family.h"
+
+#include <unicode/uloc.h>
+#include "icu-locale.h"
+#include "icu-number-skeleton.h"
+#include "icu-number-skeleton-private.h"
+#include "icu-shared-cache-private.h"
+
+// More than all currencies and units CLDR knows about.
+#define MAX_VARIANTS 1024
+
+// ICU does not accept more digits than this in precision settings.
+#define MAX_DIGITS 999
+
+/**
+ * IcuNumberFormatterFamily:
+ *
+ * Derives formatters from a base skeleton and locale.
+ *
+ * Tables formatting each row with another currency, unit or precision
+ * need one [class@NumberFormatter] per variant. A family resolves the
+ * locale once, and derives each variant by replacing the currency,
+ * unit or precision of the base skeleton, keeping the rest of the
+ * settings as they are.
+ *
+ * Variants are created on first use and cached by the family, and
+ * come from the same process-wide cache as
+ * [func@NumberFormatter.get_shared], so families with the same base
+ * share their formatters too. Families can be used from several
+ * threads at once.
+ */
+
+struct _IcuNumberFormatterFamily
+{
+  guint ref_count;
+
+  gchar *skeleton;
+  gchar *locale;
+  IcuNumberFormatter *base;
+
+  // The variants created so far, keyed by the token they replace in
+  // the base skeleton.
+  IcuSharedCache variants;
+};
+
+G_DEFINE_BOXED_TYPE (IcuNumberFormatterFamily, icu_number_formatter_family,
+                     icu_number_formatter_family_ref, icu_number_formatter_family_unref)
+
+static void
+icu_number_formatter_family_free (IcuNumberFormatterFamily *self)
+{
+  g_assert_nonnull (self);
+  g_assert_cmpuint (self->ref_count, ==, 0);
+
+  g_clear_pointer (&self->skeleton, g_free);
+  g_clear_pointer (&self->locale, g_free);
+  g_clear_pointer (&self->base, icu_number_formatter_unref);
+  icu_shared_cache_clear (&self->variants);
+
+  g_slice_free (IcuNumberFormatterFamily, self);
+}
+
+static gpointer
+build_variant (const gchar  *token,
+               gpointer      user_data,
+               GError      **error)
+{
+  IcuNumberFormatterFamily *self = user_data;
+  g_autofree gchar *skeleton = NULL;
+
+  skeleton = icu_number_skeleton_replace_setting (self->skeleton, token);
+
+  return icu_number_formatter_get_shared (skeleton, self->locale, error);
+}
+
+static IcuNumberFormatter *
+get_variant (IcuNumberFormatterFamily  *self,
+             gchar                     *token,
+             GError                   **error)
+{
+  g_autofree gchar *owned_token = token;
+
+  return icu_shared_cache_get (&self->variants, owned_token, build_variant, self, error);
+}
+
+/**
+ * icu_number_formatter_family_new:
+ * @skeleton: The number skeleton the variants are derived from.
+ * @locale: (nullable): The locale to format for, or `NULL` to use the
+ *   default locale.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Creates a new [class@NumberFormatterFamily] deriving its variants
+ * from `skeleton` and `locale`.
+ *
+ * The formatter for `skeleton` itself is created right away, which
+ * validates both and loads the locale data the variants then share.
+ *
+ * Returns: (transfer full): A newly created
+ *   [class@NumberFormatterFamily], or `NULL` if `error` is set.
+ */
+IcuNumberFormatterFamily *
+icu_number_formatter_family_new (const gchar  *skeleton,
+                                 const gchar  *locale,
+                                 GError      **error)
+{
+  g_autoptr (IcuNumberFormatterFamily) self = NULL;
+
+  g_return_val_if_fail (skeleton != NULL, NULL);
+
+  self = g_slice_new0 (IcuNumberFormatterFamily);
+  self->ref_count = 1;
+  self->skeleton = icu_number_skeleton_canonicalize (skeleton);
+  icu_shared_cache_init (&self->variants, (GBoxedCopyFunc) icu_number_formatter_ref,
+                         (GDestroyNotify) icu_number_formatter_unref, MAX_VARIANTS);
+
+  self->locale = icu_locale_canonicalize (locale != NULL ? locale : uloc_getDefault (), error);
+  if (self->locale == NULL)
+    return NULL;
+
+  self->base = icu_number_formatter_get_shared (self->skeleton, self->locale, error);
+  if (self->base == NULL)
+    return NULL;
+
+  return g_steal_pointer (&self);
+}
+
+/**
+ * icu_number_formatter_family_ref:
+ * @self: A [class@NumberFormatterFamily].
+ *
+ * Increases the reference count of `self` by one.
+ *
+ * Returns: (transfer full): The passed in
+ *   [class@NumberFormatterFamily].
+ */
+IcuNumberFormatterFamily *
+icu_number_formatter_family_ref (IcuNumberFormatterFamily *self)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+
+  g_atomic_int_inc (&self->ref_count);
+
+  return self;
+}
+
+/**
+ * icu_number_formatter_family_unref:
+ * @self: A [class@NumberFormatterFamily].
+ *
+ * Decreases the reference count of `self` by one.
+ *
+ * If the resulting reference count is zero, frees the memory of
+ * `self`.
+ */
+void
+icu_number_formatter_family_unref (IcuNumberFormatterFamily *self)
+{
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (self->ref_count >= 1);
+
+  if (g_atomic_int_dec_and_test (&self->ref_count))
+    icu_number_formatter_family_free (self);
+}
+
+/**
+ * icu_number_formatter_family_get_skeleton:
+ * @self: A [class@NumberFormatterFamily].
+ *
+ * Gets the canonical form of the skeleton the variants of `self` are
+ * derived from.
+ *
+ * Returns: The base skeleton.
+ */
+const gchar *
+icu_number_formatter_family_get_skeleton (IcuNumberFormatterFamily *self)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+
+  return self->skeleton;
+}
+
+/**
+ * icu_number_formatter_family_get_locale:
+ * @self: A [class@NumberFormatterFamily].
+ *
+ * Gets the canonical language tag of the locale of `self`.
+ *
+ * Returns: The locale of the family.
+ */
+const gchar *
+icu_number_formatter_family_get_locale (IcuNumberFormatterFamily *self)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+
+  return self->locale;
+}
+
+/**
+ * icu_number_formatter_family_get_base:
+ * @self: A [class@NumberFormatterFamily].
+ *
+ * Gets the formatter for the base skeleton of `self`.
+ *
+ * Returns: (transfer none): The base [class@NumberFormatter].
+ */
+IcuNumberFormatter *
+icu_number_formatter_family_get_base (IcuNumberFormatterFamily *self)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+
+  return self->base;
+}
+
+/**
+ * icu_number_formatter_family_get_for_currency:
+ * @self: A [class@NumberFormatterFamily].
+ * @iso_code: The ISO 4217 code of the currency, e.g. `"EUR"`.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Gets the variant of `self` formatting amounts of `iso_code`, which
+ * replaces any currency, unit, percent or permille setting of the
+ * base skeleton. The scale of bases using `%x100` goes along with their
+ * percent, so that amounts are not multiplied by 100.
+ *
+ * Returns: (transfer full): The [class@NumberFormatter] for
+ *   `iso_code`, or `NULL` if `error` is set.
+ */
+IcuNumberFormatter *
+icu_number_formatter_family_get_for_currency (IcuNumberFormatterFamily  *self,
+                                              const gchar               *iso_code,
+                                              GError                   **error)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+  g_return_val_if_fail (iso_code != NULL, NULL);
+
+  return get_variant (self, g_strconcat ("currency/", iso_code, NULL), error);
+}
+
+/**
+ * icu_number_formatter_family_get_for_unit:
+ * @self: A [class@NumberFormatterFamily].
+ * @unit: The type and subtype of the unit, e.g. `"length-meter"`.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Gets the variant of `self` formatting measures of `unit`, which
+ * replaces any currency, unit, percent or permille setting of the
+ * base skeleton. The scale of bases using `%x100` goes along with their
+ * percent, so that amounts are not multiplied by 100.
+ *
+ * Returns: (transfer full): The [class@NumberFormatter] for `unit`,
+ *   or `NULL` if `error` is set.
+ */
+IcuNumberFormatter *
+icu_number_formatter_family_get_for_unit (IcuNumberFormatterFamily  *self,
+                                          const gchar               *unit,
+                                          GError                   **error)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+  g_return_val_if_fail (unit != NULL, NULL);
+
+  return get_variant (self, g_strconcat ("measure-unit/", unit, NULL), error);
+}
+
+/**
+ * icu_number_formatter_family_get_for_precision:
+ * @self: A [class@NumberFormatterFamily].
+ * @min_digits: The minimum number of fraction digits.
+ * @max_digits: The maximum number of fraction digits, or -1 for no
+ *   maximum.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Gets the variant of `self` rounding numbers to a number of fraction
+ * digits, which replaces the precision setting of the base skeleton.
+ *
+ * Returns: (transfer full): The [class@NumberFormatter] for the
+ *   precision, or `NULL` if `error` is set.
+ */
+IcuNumberFormatter *
+icu_number_formatter_family_get_for_precision (IcuNumberFormatterFamily  *self,
+                                               gint                       min_digits,
+                                               gint                       max_digits,
+                                               GError                   **error)
+{
+  GString *token = NULL;
+
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+  g_return_val_if_fail (min_digits >= 0 && min_digits <= MAX_DIGITS, NULL);
+  g_return_val_if_fail (max_digits < 0 || (max_digits >= min_digits && max_digits <= MAX_DIGITS), NULL);
+
+  if (max_digits == 0)
+    return get_variant (self, g_strdup ("precision-integer"), error);
+
+  // The same stem IcuNumberSkeletonBuilder writes, e.g. ".00##".
+  token = g_string_new (".");
+  while (token->len <= (gsize) min_digits)
+    g_string_append_c (token, '0');
+
+  if (max_digits < 0)
+    g_string_append_c (token, '*');
+  else
+    {
+      while (token->len <= (gsize) max_digits)
+        g_string_append_c (token, '#');
+    }
+
+  return get_variant (self, g_string_free (token, FALSE), error);
+}
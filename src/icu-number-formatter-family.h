@@ -0,0 +1,59 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#pragma once
+
+#if !defined(_ICU_GOBJECT_INSIDE) && !defined(ICU_GOBJECT_COMPILATION)
+#  error "Only <icu-gobject.h> can be included directly"
+#endif
+
+#include <glib-object.h>
+#include "icu-version.h"
+#include "icu-number-formatter.h"
+
+G_BEGIN_DECLS
+
+#define ICU_TYPE_NUMBER_FORMATTER_FAMILY (icu_number_formatter_family_get_type())
+
+typedef struct _IcuNumberFormatterFamily IcuNumberFormatterFamily;
+
+ICU_AVAILABLE_IN_ALL
+GType icu_number_formatter_family_get_type (void);
+
+ICU_AVAILABLE_IN_ALL
+IcuNumberFormatterFamily *icu_number_formatter_family_new (const gchar  *skeleton,
+                                                           const gchar  *locale,
+                                                           GError      **error);
+
+ICU_AVAILABLE_IN_ALL
+IcuNumberFormatterFamily *icu_number_formatter_family_ref   (IcuNumberFormatterFamily *self);
+ICU_AVAILABLE_IN_ALL
+void                      icu_number_formatter_family_unref (IcuNumberFormatterFamily *self);
+
+ICU_AVAILABLE_IN_ALL
+const gchar        *icu_number_formatter_family_get_skeleton (IcuNumberFormatterFamily *self);
+ICU_AVAILABLE_IN_ALL
+const gchar        *icu_number_formatter_family_get_locale   (IcuNumberFormatterFamily *self);
+ICU_AVAILABLE_IN_ALL
+IcuNumberFormatter *icu_number_formatter_family_get_base     (IcuNumberFormatterFamily *self);
+
+ICU_AVAILABLE_IN_ALL
+IcuNumberFormatter *icu_number_formatter_family_get_for_currency  (IcuNumberFormatterFamily  *self,
+                                                                   const gchar               *iso_code,
+                                                                   GError                   **error);
+ICU_AVAILABLE_IN_ALL
+IcuNumberFormatter *icu_number_formatter_family_get_for_unit      (IcuNumberFormatterFamily  *self,
+                                                                   const gchar               *unit,
+                                                                   GError                   **error);
+ICU_AVAILABLE_IN_ALL
+IcuNumberFormatter *icu_number_formatter_family_get_for_precision (IcuNumberFormatterFamily  *self,
+                                                                   gint                       min_digits,
+                                                                   gint                       max_digits,
+                                                                   GError                   **error);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (IcuNumberFormatterFamily, icu_number_formatter_family_unref)
+
+G_END_DECLS
@@ -0,0 +1,17 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include "icu-number-formatter.h"
+#include <unicode/unumberformatter.h>
+
+G_BEGIN_DECLS
+
+G_GNUC_INTERNAL
+const UNumberFormatter *icu_number_formatter_get_uformatter (IcuNumberFormatter *self);
+
+G_END_DECLS
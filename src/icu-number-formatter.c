@@ -5,22 +5,190 @@
  */
 
 #include "icu-number-formatter.h"
+#include "icu-number-formatter-private.h"
 
+#include <string.h>
+#include <unicode/uloc.h>
 #include <unicode/unumberformatter.h>
+#include <unicode/uversion.h>
 #include "icu-error-private.h"
 #include "icu-formatted-number-private.h"
+#include "icu-locale.h"
+#include "icu-number-skeleton.h"
+#include "icu-number-skeleton-private.h"
+#include "icu-number-symbols.h"
+#include "icu-shared-cache-private.h"
+#include "icu-utf8-private.h"
+
+// Enough for every percentage, age or page number, while keeping
+// tables within a few megabytes.
+#define MAX_PRECOMPUTED_INTS (1 << 16)
+
+// Enough for the 39 digits and sign of a 128-bit integer, or for a
+// 64-bit mantissa and a 32-bit exponent.
+#define DECIMAL_BUFFER_SIZE 48
+
+// Specialized formatters lay out the digits of fixed-point numbers
+// themselves up to this scale, either way, and leave the rest to ICU.
+#define MAX_SPECIALIZED_SCALE 40
+
+// Enough for a carry, the 20 digits of a 64-bit mantissa shifted by
+// MAX_SPECIALIZED_SCALE, and the fraction digits padded after them.
+#define SPECIALIZED_BUFFER_SIZE (1 + 20 + MAX_SPECIALIZED_SCALE + ICU_NUMBER_SPECIALIZATION_MAX_FRACTION_DIGITS)
+
+#define CACHE_FILE_MAGIC "ICUGNFC"
+#define CACHE_FILE_VERSION 1
+
+// The layout of cache files, which are only meant to be read by the
+// machine that wrote them. The header is followed by the key of the
+// formatter, the offsets of the integer table, the memo records and
+// their fields, each section aligned to 8 bytes, and then by every
+// output, nul-terminated.
+typedef struct
+{
+  gchar magic[8];
+  guint32 version;
+  guint8 icu_version[U_MAX_VERSION_LENGTH];
+  guint64 checksum;
+  gint64 int_min;
+  guint32 n_ints;
+  guint32 n_records;
+  guint32 n_fields;
+  guint32 key_length;
+  guint64 strings_size;
+} CacheFileHeader;
+
+// Sorted by is_double and bits, so they can be binary searched.
+typedef struct
+{
+  guint64 bits;
+  guint32 is_double;
+  guint32 first_field;
+  guint32 n_fields;
+  guint32 length;
+  guint64 string_offset;
+} CacheFileRecord;
+
+// The outputs of a range of integers, one after another and
+// nul-terminated, along with the offsets delimiting them. They are
+// either allocated in one block with the table, or in a cache file.
+typedef struct
+{
+  gint64 min;
+  gint64 max;
+  gsize size;
+  const guint32 *offsets;
+  const gchar *blob;
+  GMappedFile *file;
+} IntTable;
+
+// The memo records of a cache file.
+typedef struct
+{
+  GMappedFile *file;
+  const CacheFileRecord *records;
+  guint32 n_records;
+  const IcuFieldPosition *fields;
+  const gchar *strings;
+} MappedMemo;
 
 struct _IcuNumberFormatter
 {
   guint ref_count;
+
+  // Opened on first use for specialized formatters, which only need
+  // it for what their specialization does not cover.
   UNumberFormatter *uformatter;
+  const IcuNumberSpecialization *specialization;
+
+  // What the formatter was created with, to tell its cache files apart.
+  gchar *skeleton;
+  gchar *locale;
+
+  GMutex memo_lock;
+  GHashTable *memo;
+  guint memo_capacity;
+  guint64 memo_hits;
+  guint64 memo_misses;
+  MappedMemo *mapped_memo;
+
+  // Replaced tables are kept until the formatter is freed, as their
+  // strings may still be borrowed.
+  IntTable *int_table;
+  GSList *retired_int_tables;
 };
 
+// A memoized output, allocated in one block together with its field
+// positions and string, in that order. The entry is its own key.
+typedef struct
+{
+  guint64 bits;
+  gboolean is_double;
+
+  guint n_fields;
+  gsize length;
+  IcuFieldPosition fields[];
+} MemoEntry;
+
+typedef struct
+{
+  GStrv skeletons;
+  GStrv locales;
+} PrewarmData;
+
+// Gets decimal number `i` of a batch, writing it to the end of the
+// DECIMAL_BUFFER_SIZE bytes of `buffer` unless it already is in
+// memory as one.
+typedef const gchar *(*BatchGetter) (gconstpointer  data,
+                                     gsize          i,
+                                     gchar         *buffer,
+                                     gsize         *length);
+
+typedef struct
+{
+  const gchar *buffer;
+  const gsize *spans;
+} DecimalBatch;
+
+typedef struct
+{
+  const gint64 *mantissas;
+  gint32 scale;
+} FixedBatch;
+
+typedef struct
+{
+  const gint64 *his;
+  const guint64 *los;
+} Int128Batch;
+
+// Formatters shared by everyone asking for the same skeleton and
+// locale, keyed by get_shared_key().
+static IcuSharedCache shared_formatters = ICU_SHARED_CACHE_INIT (icu_number_formatter_ref, icu_number_formatter_unref, 0);
+
+// A result reused by every call on the same thread, so that values
+// that fail to format do not allocate anything.
+static GPrivate scratch_result = G_PRIVATE_INIT ((GDestroyNotify) unumf_closeResult);
+
 G_DEFINE_BOXED_TYPE (IcuNumberFormatter, icu_number_formatter, icu_number_formatter_ref, icu_number_formatter_unref)
 
 // Enable automatic pointers for UFormattedNumber
 G_DEFINE_AUTOPTR_CLEANUP_FUNC (UFormattedNumber, unumf_closeResult)
 
+static void
+int_table_free (IntTable *table)
+{
+  g_clear_pointer (&table->file, g_mapped_file_unref);
+  g_free (table);
+}
+
+static void
+mapped_memo_free (MappedMemo *memo)
+{
+  g_clear_pointer (&memo->file, g_mapped_file_unref);
+  g_free (memo);
+}
+
 static void
 icu_number_formatter_free (IcuNumberFormatter *self)
 {
@@ -28,120 +196,2492 @@ icu_number_formatter_free (IcuNumberFormatter *self)
   g_assert_cmpuint (self->ref_count, ==, 0);
 
   g_clear_pointer (&self->uformatter, unumf_close);
+  g_clear_pointer (&self->skeleton, g_free);
+  g_clear_pointer (&self->locale, g_free);
+  g_clear_pointer (&self->memo, g_hash_table_unref);
+  g_clear_pointer (&self->mapped_memo, mapped_memo_free);
+  g_mutex_clear (&self->memo_lock);
+  g_clear_pointer (&self->int_table, int_table_free);
+  g_slist_free_full (g_steal_pointer (&self->retired_int_tables), (GDestroyNotify) int_table_free);
 
   g_slice_free (IcuNumberFormatter, self);
 }
 
-/**
- * icu_number_formatter_new:
- * @skeleton: (nullable):
- * @locale: (nullable):
- */
-IcuNumberFormatter *
-icu_number_formatter_new (const gchar  *skeleton,
-                          const gchar  *locale,
-                          GError      **error)
+static const UNumberFormatter *
+get_uformatter (IcuNumberFormatter *self,
+                UErrorCode         *ec)
 {
-  g_autoptr (IcuNumberFormatter) self = NULL;
+  UNumberFormatter *uformatter = g_atomic_pointer_get (&self->uformatter);
   g_autofree UChar *uskeleton = NULL;
-  UErrorCode ec = U_ZERO_ERROR;
 
-  self = g_slice_new0 (IcuNumberFormatter);
-  self->ref_count = 1;
+  if (uformatter != NULL || U_FAILURE (*ec))
+    return uformatter;
 
-  uskeleton = g_utf8_to_utf16 (skeleton, -1, NULL, NULL, error);
+  uskeleton = g_utf8_to_utf16 (self->skeleton, -1, NULL, NULL, NULL);
+  if (uskeleton == NULL)
+    {
+      *ec = U_INVALID_CHAR_FOUND;
+      return NULL;
+    }
 
-  self->uformatter = unumf_openForSkeletonAndLocale (uskeleton, -1, locale, &ec);
-  if (icu_has_failed (ec, error))
-    return NULL;
+  // Whoever opens it first wins, and the rest close theirs.
+  uformatter = unumf_openForSkeletonAndLocale (uskeleton, -1, self->locale, ec);
+  if (U_FAILURE (*ec))
+    {
+      g_clear_pointer (&uformatter, unumf_close);
+      return NULL;
+    }
 
-  return g_steal_pointer (&self);
+  if (!g_atomic_pointer_compare_and_exchange (&self->uformatter, NULL, uformatter))
+    {
+      unumf_close (uformatter);
+      uformatter = g_atomic_pointer_get (&self->uformatter);
+    }
+
+  return uformatter;
 }
 
-IcuNumberFormatter *
-icu_number_formatter_ref (IcuNumberFormatter *self)
+static guint
+memo_entry_hash (gconstpointer key)
 {
-  g_return_val_if_fail (self != NULL, NULL);
-  g_return_val_if_fail (self->ref_count >= 1, NULL);
+  const MemoEntry *entry = key;
 
-  g_atomic_int_inc (&self->ref_count);
+  return (guint) (entry->bits ^ (entry->bits >> 32)) ^ (guint) entry->is_double;
+}
 
-  return self;
+static gboolean
+memo_entry_equal (gconstpointer a,
+                  gconstpointer b)
+{
+  const MemoEntry *entry_a = a;
+  const MemoEntry *entry_b = b;
+
+  return entry_a->bits == entry_b->bits && entry_a->is_double == entry_b->is_double;
 }
 
-void
-icu_number_formatter_unref (IcuNumberFormatter *self)
+static inline gchar *
+memo_entry_get_string (MemoEntry *entry)
 {
-  g_return_if_fail (self != NULL);
-  g_return_if_fail (self->ref_count >= 1);
+  return (gchar *) &entry->fields[entry->n_fields];
+}
 
-  if (g_atomic_int_dec_and_test (&self->ref_count))
-    icu_number_formatter_free (self);
+static gint
+compare_record (const CacheFileRecord *record,
+                guint64                bits,
+                gboolean               is_double)
+{
+  if (record->is_double != (guint32) is_double)
+    return record->is_double < (guint32) is_double ? -1 : 1;
+
+  if (record->bits != bits)
+    return record->bits < bits ? -1 : 1;
+
+  return 0;
 }
 
-IcuFormattedNumber *
-icu_number_formatter_format_int (IcuNumberFormatter  *self,
-                                 gint64               value,
-                                 GError             **error)
+static const CacheFileRecord *
+mapped_memo_lookup (MappedMemo *memo,
+                    guint64     bits,
+                    gboolean    is_double)
 {
-  g_autoptr (UFormattedNumber) uresult = NULL;
-  UErrorCode ec = U_ZERO_ERROR;
+  guint32 low = 0;
+  guint32 high = memo->n_records;
 
-  g_return_val_if_fail (self != NULL, NULL);
-  g_return_val_if_fail (self->ref_count >= 1, NULL);
+  while (low < high)
+    {
+      guint32 middle = low + (high - low) / 2;
+      gint cmp = compare_record (&memo->records[middle], bits, is_double);
 
-  uresult = unumf_openResult (&ec);
-  if (icu_has_failed (ec, error))
-    return NULL;
+      if (cmp == 0)
+        return &memo->records[middle];
 
-  unumf_formatInt (self->uformatter, value, uresult, &ec);
-  if (icu_has_failed (ec, error))
-    return NULL;
+      if (cmp < 0)
+        low = middle + 1;
+      else
+        high = middle;
+    }
 
-  return icu_formatted_number_new (g_steal_pointer (&uresult));
+  return NULL;
 }
 
-IcuFormattedNumber *
-icu_number_formatter_format_double (IcuNumberFormatter  *self,
-                                    gdouble              value,
-                                    GError             **error)
+static UFormattedNumber *
+take_scratch_result (UErrorCode *ec)
 {
-  g_autoptr (UFormattedNumber) uresult = NULL;
-  UErrorCode ec = U_ZERO_ERROR;
+  UFormattedNumber *uresult = NULL;
 
-  g_return_val_if_fail (self != NULL, NULL);
-  g_return_val_if_fail (self->ref_count >= 1, NULL);
+  uresult = g_private_get (&scratch_result);
+  if (uresult == NULL)
+    return unumf_openResult (ec);
+
+  g_private_set (&scratch_result, NULL);
+
+  return uresult;
+}
+
+static void
+give_back_scratch_result (UFormattedNumber *uresult)
+{
+  if (uresult != NULL)
+    g_private_set (&scratch_result, uresult);
+}
+
+static IcuStatus
+finish_try_format (UFormattedNumber    *uresult,
+                   UErrorCode           ec,
+                   IcuFormattedNumber **result)
+{
+  if (U_SUCCESS (ec) && result != NULL)
+    {
+      *result = icu_formatted_number_new (uresult);
+      return ICU_STATUS_OK;
+    }
+
+  give_back_scratch_result (uresult);
+
+  return U_SUCCESS (ec) ? ICU_STATUS_OK : (IcuStatus) ec;
+}
+
+static void
+format_decimal (IcuNumberFormatter *self,
+                const gchar        *value,
+                gssize              length,
+                UFormattedNumber   *uresult,
+                UErrorCode         *ec)
+{
+  if (length > G_MAXINT32)
+    {
+      *ec = U_INPUT_TOO_LONG_ERROR;
+      return;
+    }
+
+  // ICU writes out every digit of numbers like 1e999999999 in most
+  // notations, which takes minutes.
+  if (icu_number_has_huge_exponent (value, length < 0 ? strlen (value) : (gsize) length))
+    {
+      *ec = U_NUMBER_ARG_OUTOFBOUNDS_ERROR;
+      return;
+    }
+
+  unumf_formatDecimal (get_uformatter (self, ec), value, length < 0 ? -1 : (gint32) length, uresult, ec);
+}
+
+// Writes the digits of `value` right before `end`, returning where
+// they start.
+static gchar *
+write_digits (guint64  value,
+              gchar   *end)
+{
+  do
+    {
+      *--end = '0' + value % 10;
+      value /= 10;
+    }
+  while (value > 0);
+
+  return end;
+}
+
+// Writes the 128-bit two's complement integer `hi`:`lo` in decimal
+// right before `end`, returning where it starts.
+static gchar *
+write_int128 (gint64   hi,
+              guint64  lo,
+              gchar   *end)
+{
+  gboolean negative = hi < 0;
+  guint64 high = (guint64) hi;
+  guint32 limbs[4] = {0};
+  gchar *start = end;
+  gsize i = 0;
+
+  if (negative)
+    {
+      lo = ~lo + 1;
+      high = ~high + (lo == 0 ? 1 : 0);
+    }
+
+  limbs[0] = high >> 32;
+  limbs[1] = high & G_MAXUINT32;
+  limbs[2] = lo >> 32;
+  limbs[3] = lo & G_MAXUINT32;
+
+  // Long division by 10^9, which yields nine digits at a time.
+  while (TRUE)
+    {
+      guint64 remainder = 0;
+      gboolean is_zero = TRUE;
+
+      for (i = 0; i < G_N_ELEMENTS (limbs); i++)
+        {
+          guint64 current = (remainder << 32) | limbs[i];
+
+          limbs[i] = (guint32) (current / 1000000000);
+          remainder = current % 1000000000;
+          is_zero &= limbs[i] == 0;
+        }
+
+      start = write_digits (remainder, start);
+
+      if (is_zero)
+        break;
+
+      while (start > end - 9 * ((end - start + 8) / 9))
+        *--start = '0';
+    }
+
+  if (negative)
+    *--start = '-';
+
+  return start;
+}
 
-  uresult = unumf_openResult (&ec);
+// Writes `mantissa` × 10^-`scale` in decimal, like "12345e-2", right
+// before `end`, returning where it starts.
+static gchar *
+write_fixed (gint64   mantissa,
+             gint32   scale,
+             gchar   *end)
+{
+  gchar *start = end;
+
+  if (scale != 0)
+    {
+      start = write_digits (scale < 0 ? -(guint64) scale : (guint64) scale, start);
+
+      if (scale > 0)
+        *--start = '-';
+
+      *--start = 'e';
+    }
+
+  start = write_int128 (mantissa < 0 ? -1 : 0, (guint64) mantissa, start);
+
+  return start;
+}
+
+static gboolean
+is_specialized_scale (gint32 scale)
+{
+  return scale >= -MAX_SPECIALIZED_SCALE && scale <= MAX_SPECIALIZED_SCALE;
+}
+
+static gboolean
+has_separator_before (const IcuNumberSpecialization *specialization,
+                      gsize                          n_remaining)
+{
+  if (n_remaining < specialization->primary_grouping)
+    return FALSE;
+
+  if (n_remaining == specialization->primary_grouping)
+    return TRUE;
+
+  return (n_remaining - specialization->primary_grouping) % specialization->secondary_grouping == 0;
+}
+
+// Formats `mantissa` × 10^-`scale` with the symbols and layout of
+// `specialization`, rounding half to even like ICU does by default.
+// The scale must be one is_specialized_scale() accepts.
+static void
+append_specialized (const IcuNumberSpecialization *specialization,
+                    gint64                         mantissa,
+                    gint32                         scale,
+                    GString                       *out)
+{
+  gchar buffer[DECIMAL_BUFFER_SIZE];
+  gchar digits[SPECIALIZED_BUFFER_SIZE];
+  gboolean negative = mantissa < 0;
+  const gchar *magnitude = NULL;
+  gchar *start = digits + 1;
+  gsize n_magnitude = 0;
+  gsize n_integer = 0;
+  gsize n_fraction = 0;
+  gsize i = 0;
+
+  magnitude = write_digits (negative ? -(guint64) mantissa : (guint64) mantissa, buffer + sizeof buffer);
+  n_magnitude = buffer + sizeof buffer - magnitude;
+
+  // Lay out the integer digits followed by the fraction digits, with
+  // at least one integer digit. The first byte is kept for a carry.
+  if (scale <= 0)
+    {
+      memcpy (start, magnitude, n_magnitude);
+      memset (start + n_magnitude, '0', -scale);
+      n_integer = n_magnitude - scale;
+    }
+  else if ((gsize) scale < n_magnitude)
+    {
+      memcpy (start, magnitude, n_magnitude);
+      n_integer = n_magnitude - scale;
+      n_fraction = scale;
+    }
+  else
+    {
+      start[0] = '0';
+      memset (start + 1, '0', scale - n_magnitude);
+      memcpy (start + 1 + scale - n_magnitude, magnitude, n_magnitude);
+      n_integer = 1;
+      n_fraction = scale;
+    }
+
+  if (n_fraction > specialization->max_fraction_digits)
+    {
+      gchar *dropped = start + n_integer + specialization->max_fraction_digits;
+      gboolean round_up = FALSE;
+
+      if (*dropped != '5')
+        round_up = *dropped > '5';
+      else
+        {
+          round_up = (dropped[-1] - '0') % 2 == 1;
+
+          for (i = 1; dropped + i < start + n_integer + n_fraction; i++)
+            round_up |= dropped[i] != '0';
+        }
+
+      n_fraction = specialization->max_fraction_digits;
+
+      if (round_up)
+        {
+          gchar *digit = dropped - 1;
+
+          while (digit >= start && *digit == '9')
+            *digit-- = '0';
+
+          if (digit >= start)
+            (*digit)++;
+          else
+            {
+              *--start = '1';
+              n_integer++;
+            }
+        }
+    }
+
+  while (n_fraction > specialization->min_fraction_digits && start[n_integer + n_fraction - 1] == '0')
+    n_fraction--;
+
+  while (n_fraction < specialization->min_fraction_digits)
+    start[n_integer + n_fraction++] = '0';
+
+  while (n_integer > 1 && start[0] == '0')
+    {
+      start++;
+      n_integer--;
+    }
+
+  g_string_append (out, negative ? specialization->negative_prefix : specialization->positive_prefix);
+
+  for (i = 0; i < n_integer; i++)
+    {
+      if (i > 0 &&
+          specialization->primary_grouping > 0 &&
+          n_integer >= (gsize) specialization->primary_grouping + specialization->min_grouping_digits &&
+          has_separator_before (specialization, n_integer - i))
+        g_string_append (out, specialization->grouping_separator);
+
+      g_string_append (out, specialization->digits[start[i] - '0']);
+    }
+
+  if (n_fraction > 0)
+    {
+      g_string_append (out, specialization->decimal_separator);
+
+      for (i = n_integer; i < n_integer + n_fraction; i++)
+        g_string_append (out, specialization->digits[start[i] - '0']);
+    }
+
+  g_string_append (out, negative ? specialization->negative_suffix : specialization->positive_suffix);
+}
+
+static const gchar *
+get_decimal (gconstpointer  data,
+             gsize          i,
+             gchar         *buffer,
+             gsize         *length)
+{
+  const DecimalBatch *batch = data;
+
+  *length = batch->spans[2 * i + 1];
+
+  return batch->buffer + batch->spans[2 * i];
+}
+
+static const gchar *
+get_fixed (gconstpointer  data,
+           gsize          i,
+           gchar         *buffer,
+           gsize         *length)
+{
+  const FixedBatch *batch = data;
+  gchar *start = NULL;
+
+  start = write_fixed (batch->mantissas[i], batch->scale, buffer + DECIMAL_BUFFER_SIZE);
+  *length = buffer + DECIMAL_BUFFER_SIZE - start;
+
+  return start;
+}
+
+static const gchar *
+get_int128 (gconstpointer  data,
+            gsize          i,
+            gchar         *buffer,
+            gsize         *length)
+{
+  const Int128Batch *batch = data;
+  gchar *start = NULL;
+
+  start = write_int128 (batch->his[i], batch->los[i], buffer + DECIMAL_BUFFER_SIZE);
+  *length = buffer + DECIMAL_BUFFER_SIZE - start;
+
+  return start;
+}
+
+static void
+append_result (UFormattedNumber *uresult,
+               GString          *out,
+               UErrorCode       *ec)
+{
+  const UFormattedValue *ufmtval = NULL;
+  const UChar *ustring = NULL;
+  gint32 length = 0;
+
+  ufmtval = unumf_resultAsValue (uresult, ec);
+  if (U_FAILURE (*ec))
+    return;
+
+  ustring = ufmtval_getString (ufmtval, &length, ec);
+  if (U_FAILURE (*ec))
+    return;
+
+  icu_utf8_append_utf16 (out, ustring, length, ec);
+}
+
+static gboolean
+format_batch (IcuNumberFormatter  *self,
+              BatchGetter          get,
+              gconstpointer        data,
+              gsize                n_values,
+              GString             *arena,
+              gsize               *out_offsets,
+              IcuStatus           *statuses,
+              GError             **error)
+{
+  UFormattedNumber *uresult = NULL;
+  gchar buffer[DECIMAL_BUFFER_SIZE];
+  gsize start = 0;
+  gsize i = 0;
+  UErrorCode ec = U_ZERO_ERROR;
+
+  uresult = take_scratch_result (&ec);
   if (icu_has_failed (ec, error))
-    return NULL;
+    return FALSE;
+
+  start = arena->len;
+  out_offsets[0] = start;
+
+  for (i = 0; i < n_values; i++)
+    {
+      UErrorCode value_ec = U_ZERO_ERROR;
+      const gchar *decimal = NULL;
+      gsize length = 0;
+
+      decimal = get (data, i, buffer, &length);
+
+      format_decimal (self, decimal, length, uresult, &value_ec);
+      append_result (uresult, arena, &value_ec);
+
+      if (statuses != NULL)
+        statuses[i] = U_SUCCESS (value_ec) ? ICU_STATUS_OK : (IcuStatus) value_ec;
+      else if (U_FAILURE (value_ec))
+        {
+          ec = value_ec;
+          break;
+        }
+
+      out_offsets[i + 1] = arena->len;
+    }
+
+  give_back_scratch_result (uresult);
 
-  unumf_formatDouble (self->uformatter, value, uresult, &ec);
   if (icu_has_failed (ec, error))
-    return NULL;
+    {
+      g_string_truncate (arena, start);
+      return FALSE;
+    }
 
-  return icu_formatted_number_new (g_steal_pointer (&uresult));
+  return TRUE;
 }
 
-IcuFormattedNumber *
-icu_number_formatter_format_decimal (IcuNumberFormatter  *self,
-                                     const gchar         *value,
-                                     GError             **error)
+// Like append_result(), but also appends the number fields of the
+// result to `fields`, with their indexes as byte offsets into `out`.
+static void
+append_result_with_fields (UFormattedNumber *uresult,
+                           GString          *out,
+                           GArray           *fields,
+                           UErrorCode       *ec)
+{
+  const UFormattedValue *ufmtval = NULL;
+  UConstrainedFieldPosition *ucfpos = NULL;
+  const UChar *ustring = NULL;
+  gsize start = 0;
+  guint n_fields = 0;
+  gint32 length = 0;
+
+  ufmtval = unumf_resultAsValue (uresult, ec);
+  ustring = ufmtval_getString (ufmtval, &length, ec);
+  if (U_FAILURE (*ec))
+    return;
+
+  start = out->len;
+  n_fields = fields->len;
+
+  ucfpos = ucfpos_open (ec);
+  ucfpos_constrainCategory (ucfpos, UFIELD_CATEGORY_NUMBER, ec);
+
+  while (U_SUCCESS (*ec) && ufmtval_nextPosition (ufmtval, ucfpos, ec))
+    {
+      IcuFieldPosition position = {0};
+      gint32 begin_index = 0;
+      gint32 end_index = 0;
+
+      ucfpos_getIndexes (ucfpos, &begin_index, &end_index, ec);
+
+      position.field = ucfpos_getField (ucfpos, ec);
+      position.begin_index = (gint32) (start + icu_utf8_length_of_utf16 (ustring, begin_index));
+      position.end_index = (gint32) (start + icu_utf8_length_of_utf16 (ustring, end_index));
+
+      g_array_append_val (fields, position);
+    }
+
+  g_clear_pointer (&ucfpos, ucfpos_close);
+
+  icu_utf8_append_utf16 (out, ustring, length, ec);
+  if (U_FAILURE (*ec))
+    g_array_set_size (fields, n_fields);
+}
+
+static void
+append_output (GString                *out,
+               GArray                 *fields,
+               const gchar            *string,
+               gsize                   length,
+               const IcuFieldPosition *positions,
+               guint                   n_positions)
+{
+  guint i = 0;
+
+  if (fields != NULL)
+    {
+      for (i = 0; i < n_positions; i++)
+        {
+          IcuFieldPosition position = positions[i];
+
+          position.begin_index += (gint32) out->len;
+          position.end_index += (gint32) out->len;
+
+          g_array_append_val (fields, position);
+        }
+    }
+
+  g_string_append_len (out, string, length);
+}
+
+// Appends the memoized output of the value identified by `bits` and
+// `is_double` to `out` and `fields`, if there is one.
+static gboolean
+memo_lookup (IcuNumberFormatter *self,
+             guint64             bits,
+             gboolean            is_double,
+             GString            *out,
+             GArray             *fields)
+{
+  MemoEntry key = { .bits = bits, .is_double = is_double };
+  MemoEntry *entry = NULL;
+  const CacheFileRecord *record = NULL;
+
+  // The memo is opt-in, so formatters without one, like shared ones
+  // used from several threads, must not wait on its lock.
+  if (g_atomic_int_get (&self->memo_capacity) == 0 && g_atomic_pointer_get (&self->mapped_memo) == NULL)
+    return FALSE;
+
+  g_mutex_lock (&self->memo_lock);
+
+  if (self->memo != NULL)
+    entry = g_hash_table_lookup (self->memo, &key);
+
+  if (entry == NULL && self->mapped_memo != NULL)
+    record = mapped_memo_lookup (self->mapped_memo, bits, is_double);
+
+  if (entry != NULL)
+    {
+      append_output (out, fields, memo_entry_get_string (entry), entry->length,
+                     entry->fields, entry->n_fields);
+    }
+  else if (record != NULL)
+    {
+      append_output (out, fields, self->mapped_memo->strings + record->string_offset, record->length,
+                     self->mapped_memo->fields + record->first_field, record->n_fields);
+    }
+  else
+    {
+      if (self->memo_capacity > 0 || self->mapped_memo != NULL)
+        self->memo_misses++;
+
+      g_mutex_unlock (&self->memo_lock);
+      return FALSE;
+    }
+
+  self->memo_hits++;
+
+  g_mutex_unlock (&self->memo_lock);
+
+  return TRUE;
+}
+
+// Memoizes the output appended to `out` and `fields` from `start`
+// and `n_fields` on.
+static void
+memo_insert (IcuNumberFormatter *self,
+             guint64             bits,
+             gboolean            is_double,
+             GString            *out,
+             gsize               start,
+             GArray             *fields,
+             guint               n_fields)
+{
+  MemoEntry *entry = NULL;
+  guint i = 0;
+
+  g_mutex_lock (&self->memo_lock);
+
+  if (self->memo_capacity == 0)
+    {
+      g_mutex_unlock (&self->memo_lock);
+      return;
+    }
+
+  if (g_hash_table_size (self->memo) >= self->memo_capacity)
+    g_hash_table_remove_all (self->memo);
+
+  entry = g_malloc (sizeof (MemoEntry)
+                    + (fields->len - n_fields) * sizeof (IcuFieldPosition)
+                    + (out->len - start));
+  entry->bits = bits;
+  entry->is_double = is_double;
+  entry->n_fields = fields->len - n_fields;
+  entry->length = out->len - start;
+
+  for (i = 0; i < entry->n_fields; i++)
+    {
+      entry->fields[i] = g_array_index (fields, IcuFieldPosition, n_fields + i);
+      entry->fields[i].begin_index -= (gint32) start;
+      entry->fields[i].end_index -= (gint32) start;
+    }
+
+  memcpy (memo_entry_get_string (entry), out->str + start, entry->length);
+
+  g_hash_table_replace (self->memo, entry, entry);
+
+  g_mutex_unlock (&self->memo_lock);
+}
+
+static gboolean
+append_value (IcuNumberFormatter  *self,
+              guint64              bits,
+              gboolean             is_double,
+              GString             *out,
+              GArray              *fields,
+              GError             **error)
 {
-  g_autoptr (UFormattedNumber) uresult = NULL;
+  g_autoptr (GArray) own_fields = NULL;
+  UFormattedNumber *uresult = NULL;
+  gboolean memoize = FALSE;
+  gsize start = 0;
+  guint n_fields = 0;
   UErrorCode ec = U_ZERO_ERROR;
 
-  g_return_val_if_fail (self != NULL, NULL);
-  g_return_val_if_fail (self->ref_count >= 1, NULL);
-  g_return_val_if_fail (value != NULL, NULL);
+  if (!is_double && fields == NULL && self->specialization != NULL)
+    {
+      append_specialized (self->specialization, (gint64) bits, 0, out);
+      return TRUE;
+    }
 
-  uresult = unumf_openResult (&ec);
-  if (icu_has_failed (ec, error))
-    return NULL;
+  if (!is_double && fields == NULL)
+    {
+      const gchar *string = NULL;
+      gsize length = 0;
 
-  unumf_formatDecimal (self->uformatter, value, -1, uresult, &ec);
-  if (icu_has_failed (ec, error))
-    return NULL;
+      string = icu_number_formatter_lookup_int (self, (gint64) bits, &length);
+      if (string != NULL)
+        {
+          g_string_append_len (out, string, length);
+          return TRUE;
+        }
+    }
+
+  if (memo_lookup (self, bits, is_double, out, fields))
+    return TRUE;
+
+  memoize = g_atomic_int_get (&self->memo_capacity) > 0;
+
+  // Field positions are only worked out when someone needs them.
+  if (memoize && fields == NULL)
+    fields = own_fields = g_array_new (FALSE, FALSE, sizeof (IcuFieldPosition));
+
+  start = out->len;
+  n_fields = fields != NULL ? fields->len : 0;
+
+  uresult = take_scratch_result (&ec);
+
+  if (is_double)
+    {
+      gdouble value = 0;
+
+      memcpy (&value, &bits, sizeof value);
+      unumf_formatDouble (get_uformatter (self, &ec), value, uresult, &ec);
+    }
+  else
+    unumf_formatInt (get_uformatter (self, &ec), (gint64) bits, uresult, &ec);
+
+  if (fields != NULL)
+    append_result_with_fields (uresult, out, fields, &ec);
+  else
+    append_result (uresult, out, &ec);
+
+  give_back_scratch_result (uresult);
+
+  if (icu_has_failed (ec, error))
+    return FALSE;
+
+  if (memoize)
+    memo_insert (self, bits, is_double, out, start, fields, n_fields);
+
+  return TRUE;
+}
+
+// FNV-1a, which is enough to catch truncated or damaged files.
+static guint64
+checksum_bytes (const guint8 *bytes,
+                gsize         length)
+{
+  guint64 hash = G_GUINT64_CONSTANT (0xcbf29ce484222325);
+  gsize i = 0;
+
+  for (i = 0; i < length; i++)
+    {
+      hash ^= bytes[i];
+      hash *= G_GUINT64_CONSTANT (0x100000001b3);
+    }
+
+  return hash;
+}
+
+static void
+append_section (GByteArray    *bytes,
+                gconstpointer  data,
+                gsize          length)
+{
+  static const guint8 padding[8] = {0};
+
+  g_byte_array_append (bytes, data, length);
+
+  if (bytes->len % 8 != 0)
+    g_byte_array_append (bytes, padding, 8 - bytes->len % 8);
+}
+
+static gint
+sort_records (gconstpointer a,
+              gconstpointer b)
+{
+  const CacheFileRecord *record_b = b;
+
+  return compare_record (a, record_b->bits, record_b->is_double);
+}
+
+// Gets the size of a section of `n_items` items of `item_size` bytes,
+// padded like append_section() does.
+static inline guint64
+get_section_size (guint64 n_items,
+                  gsize   item_size)
+{
+  return (n_items * item_size + 7) / 8 * 8;
+}
+
+// Checks the offsets, records and fields of a cache file against the
+// sizes in its header, so that nothing out of bounds is ever read.
+static gboolean
+check_cache_file (const CacheFileHeader   *header,
+                  const guint32           *offsets,
+                  const CacheFileRecord   *records,
+                  const IcuFieldPosition  *fields,
+                  const gchar             *strings)
+{
+  guint32 i = 0;
+  guint32 j = 0;
+
+  for (i = 0; i < header->n_ints; i++)
+    {
+      if (offsets[i] >= offsets[i + 1] || offsets[i + 1] > header->strings_size)
+        return FALSE;
+
+      if (strings[offsets[i + 1] - 1] != '\0')
+        return FALSE;
+    }
+
+  if (header->n_ints > 0 && offsets[0] != 0)
+    return FALSE;
+
+  if (header->n_ints > 0 && header->int_min > G_MAXINT64 - (gint64) (header->n_ints - 1))
+    return FALSE;
+
+  for (i = 0; i < header->n_records; i++)
+    {
+      const CacheFileRecord *record = &records[i];
+
+      if (record->first_field > header->n_fields || header->n_fields - record->first_field < record->n_fields)
+        return FALSE;
+
+      if (record->string_offset > header->strings_size || header->strings_size - record->string_offset < record->length)
+        return FALSE;
+
+      for (j = record->first_field; j < record->first_field + record->n_fields; j++)
+        {
+          if (fields[j].begin_index < 0 || fields[j].begin_index > fields[j].end_index
+              || (guint32) fields[j].end_index > record->length)
+            return FALSE;
+        }
+
+      if (i > 0 && compare_record (&records[i - 1], record->bits, record->is_double) >= 0)
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+// Formats `n_values` values one after another into `arena`, filling
+// the `n_values + 1` offsets delimiting them.
+static gboolean
+append_values (IcuNumberFormatter  *self,
+               gconstpointer        values,
+               gboolean             are_doubles,
+               gsize                n_values,
+               GString             *arena,
+               gsize               *offsets,
+               GError             **error)
+{
+  gsize i = 0;
+
+  offsets[0] = arena->len;
+
+  for (i = 0; i < n_values; i++)
+    {
+      guint64 bits = 0;
+
+      if (are_doubles)
+        memcpy (&bits, (const gdouble *) values + i, sizeof bits);
+      else
+        bits = (guint64) ((const gint64 *) values)[i];
+
+      if (!append_value (self, bits, are_doubles, arena, NULL, error))
+        return FALSE;
+
+      offsets[i + 1] = arena->len;
+    }
+
+  return TRUE;
+}
+
+static GStrv
+format_strv (IcuNumberFormatter  *self,
+             gconstpointer        values,
+             gboolean             are_doubles,
+             gsize                n_values,
+             GError             **error)
+{
+  g_autoptr (GString) arena = NULL;
+  g_autofree gsize *offsets = NULL;
+  GStrv strv = NULL;
+  gsize i = 0;
+
+  arena = g_string_sized_new (n_values * 16);
+  offsets = g_new (gsize, n_values + 1);
+
+  if (!append_values (self, values, are_doubles, n_values, arena, offsets, error))
+    return NULL;
+
+  strv = g_new (gchar *, n_values + 1);
+
+  for (i = 0; i < n_values; i++)
+    strv[i] = g_strndup (arena->str + offsets[i], offsets[i + 1] - offsets[i]);
+
+  strv[n_values] = NULL;
+
+  return strv;
+}
+
+static GBytes *
+format_packed (IcuNumberFormatter  *self,
+               gconstpointer        values,
+               gboolean             are_doubles,
+               gsize                n_values,
+               gsize              **offsets,
+               gsize               *n_offsets,
+               GError             **error)
+{
+  g_autoptr (GString) arena = NULL;
+  g_autofree gsize *own_offsets = NULL;
+
+  arena = g_string_sized_new (n_values * 16);
+  own_offsets = g_new (gsize, n_values + 1);
+
+  if (!append_values (self, values, are_doubles, n_values, arena, own_offsets, error))
+    return NULL;
+
+  *offsets = g_steal_pointer (&own_offsets);
+  *n_offsets = n_values + 1;
+
+  return g_string_free_to_bytes (g_steal_pointer (&arena));
+}
+
+static void
+prewarm_data_free (PrewarmData *data)
+{
+  g_clear_pointer (&data->skeletons, g_strfreev);
+  g_clear_pointer (&data->locales, g_strfreev);
+
+  g_free (data);
+}
+
+static gchar *
+get_shared_key (const gchar  *skeleton,
+                const gchar  *locale,
+                GError      **error)
+{
+  g_autofree gchar *tag = NULL;
+  g_autofree gchar *canonical = NULL;
+
+  // Language tags never contain spaces, so the key is unambiguous
+  // whatever the skeleton looks like.
+  tag = icu_locale_canonicalize (locale != NULL ? locale : uloc_getDefault (), error);
+  if (tag == NULL)
+    return NULL;
+
+  canonical = icu_number_skeleton_canonicalize (skeleton);
+
+  return g_strconcat (tag, " ", canonical, NULL);
+}
+
+static void
+prewarm_thread (GTask        *task,
+                gpointer      source_object,
+                gpointer      task_data,
+                GCancellable *cancellable)
+{
+  PrewarmData *data = task_data;
+  g_autoptr (GError) error = NULL;
+  gsize i = 0;
+  gsize j = 0;
+
+  for (i = 0; data->locales[i] != NULL; i++)
+    {
+      for (j = 0; data->skeletons[j] != NULL; j++)
+        {
+          g_autoptr (IcuNumberFormatter) formatter = NULL;
+          g_autoptr (IcuFormattedNumber) number = NULL;
+          g_autofree gchar *string = NULL;
+          g_autoptr (GError) local_error = NULL;
+
+          if (g_task_return_error_if_cancelled (task))
+            return;
+
+          formatter = icu_number_formatter_get_shared (data->skeletons[j], data->locales[i], &local_error);
+
+          // Formatting a value with a fraction and enough digits to be
+          // grouped pages in the symbols, patterns and any plural or
+          // currency data the skeleton needs.
+          if (formatter != NULL)
+            number = icu_number_formatter_format_double (formatter, -1234567.891, &local_error);
+
+          if (number != NULL)
+            string = icu_formatted_number_to_string (number, &local_error);
+
+          if (local_error != NULL && error == NULL)
+            error = g_steal_pointer (&local_error);
+        }
+    }
+
+  if (error != NULL)
+    g_task_return_error (task, g_steal_pointer (&error));
+  else
+    g_task_return_boolean (task, TRUE);
+}
+
+/**
+ * icu_number_formatter_new:
+ * @skeleton: (nullable):
+ * @locale: (nullable):
+ */
+IcuNumberFormatter *
+icu_number_formatter_new (const gchar  *skeleton,
+                          const gchar  *locale,
+                          GError      **error)
+{
+  g_autoptr (IcuNumberFormatter) self = NULL;
+  g_autofree UChar *uskeleton = NULL;
+  UParseError parse_error = {0};
+  UErrorCode ec = U_ZERO_ERROR;
+
+  self = g_slice_new0 (IcuNumberFormatter);
+  self->ref_count = 1;
+  self->skeleton = g_strdup (skeleton != NULL ? skeleton : "");
+  self->locale = g_strdup (locale != NULL ? locale : uloc_getDefault ());
+  g_mutex_init (&self->memo_lock);
+
+  uskeleton = g_utf8_to_utf16 (skeleton != NULL ? skeleton : "", -1, NULL, NULL, error);
+  if (uskeleton == NULL)
+    return NULL;
+
+  if (icu_number_skeleton_has_huge_scale (self->skeleton))
+    {
+      icu_has_failed (U_NUMBER_ARG_OUTOFBOUNDS_ERROR, error);
+      return NULL;
+    }
+
+  self->uformatter = unumf_openForSkeletonAndLocaleWithError (uskeleton, -1, locale, &parse_error, &ec);
+  if (icu_has_failed_with_parse_error (ec, &parse_error, error))
+    return NULL;
+
+  return g_steal_pointer (&self);
+}
+
+static gpointer
+build_shared_formatter (const gchar  *key,
+                        gpointer      user_data,
+                        GError      **error)
+{
+  const gchar **args = user_data;
+
+  return icu_number_formatter_new (args[0], args[1], error);
+}
+
+/**
+ * icu_number_formatter_get_shared:
+ * @skeleton: The number skeleton to format with.
+ * @locale: (nullable): The locale to format for, or `NULL` to use the
+ *   default locale.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Gets a formatter for `skeleton` and `locale` out of a cache shared
+ * by the whole process, creating it on first use.
+ *
+ * Equivalent spellings of `skeleton` and `locale` share the same
+ * formatter, see [func@number_skeleton_canonicalize] and
+ * [func@locale_canonicalize]. Cached formatters live until the
+ * process exits, so this is meant for the fixed set of skeletons and
+ * locales an application uses, which [func@NumberFormatter.prewarm]
+ * can create ahead of time.
+ *
+ * Returns: (transfer full): The shared [class@NumberFormatter].
+ */
+IcuNumberFormatter *
+icu_number_formatter_get_shared (const gchar  *skeleton,
+                                 const gchar  *locale,
+                                 GError      **error)
+{
+  g_autofree gchar *key = NULL;
+  const gchar *args[] = { skeleton, locale };
+
+  g_return_val_if_fail (skeleton != NULL, NULL);
+
+  key = get_shared_key (skeleton, locale, error);
+  if (key == NULL)
+    return NULL;
+
+  return icu_shared_cache_get (&shared_formatters, key, build_shared_formatter, args, error);
+}
+
+/**
+ * IcuNumberSpecialization:
+ * @skeleton: The number skeleton the specialization was made for.
+ * @locale: The locale the specialization was made for.
+ * @digits: The digits from zero to nine.
+ * @decimal_separator: The decimal separator.
+ * @grouping_separator: The grouping separator.
+ * @primary_grouping: The size of the group next to the decimal
+ *   separator, or 0 if digits are not grouped.
+ * @secondary_grouping: The size of the rest of the groups.
+ * @min_grouping_digits: How many digits have to be left before the
+ *   first grouping separator for digits to be grouped at all.
+ * @min_fraction_digits: The fewest fraction digits to show.
+ * @max_fraction_digits: The most fraction digits to show, up to
+ *   [const@NUMBER_SPECIALIZATION_MAX_FRACTION_DIGITS].
+ * @positive_prefix: The text before positive numbers.
+ * @positive_suffix: The text after positive numbers.
+ * @negative_prefix: The text before negative numbers.
+ * @negative_suffix: The text after negative numbers.
+ *
+ * What formatting with a skeleton and locale comes down to, for the
+ * skeletons that only round and group the digits and add affixes to
+ * them, like most currency and integer formats.
+ *
+ * Specializations are generated ahead of time by the
+ * `icu-number-specializer` tool, which checks them against ICU, and
+ * are not meant to be written by hand.
+ */
+
+/**
+ * icu_number_formatter_new_specialized: (skip)
+ * @specialization: The specialization to format with, which must
+ *   outlive the formatter.
+ *
+ * Creates a new [class@NumberFormatter] for the skeleton and locale of
+ * `specialization`, which formats integers and fixed-point numbers
+ * into UTF-8 by itself, without going through ICU.
+ *
+ * That is the case of [method@NumberFormatter.append_int] when no
+ * fields are asked for, and of the functions built on top of it, and
+ * of [method@NumberFormatter.format_fixed_batch]. Everything else is
+ * formatted by ICU as usual, with a formatter that is only created the
+ * first time it is needed, so skeletons are not even parsed when
+ * sticking to the specialized functions.
+ *
+ * Returns: (transfer full): A newly created [class@NumberFormatter].
+ */
+IcuNumberFormatter *
+icu_number_formatter_new_specialized (const IcuNumberSpecialization *specialization)
+{
+  IcuNumberFormatter *self = NULL;
+
+  g_return_val_if_fail (specialization != NULL, NULL);
+  g_return_val_if_fail (specialization->skeleton != NULL, NULL);
+  g_return_val_if_fail (specialization->locale != NULL, NULL);
+  g_return_val_if_fail (specialization->primary_grouping == 0 || specialization->secondary_grouping > 0, NULL);
+  g_return_val_if_fail (specialization->min_fraction_digits <= specialization->max_fraction_digits, NULL);
+  g_return_val_if_fail (specialization->max_fraction_digits <= ICU_NUMBER_SPECIALIZATION_MAX_FRACTION_DIGITS, NULL);
+
+  self = g_slice_new0 (IcuNumberFormatter);
+  self->ref_count = 1;
+  self->skeleton = g_strdup (specialization->skeleton);
+  self->locale = g_strdup (specialization->locale);
+  self->specialization = specialization;
+  g_mutex_init (&self->memo_lock);
+
+  return self;
+}
+
+/**
+ * icu_number_formatter_prewarm:
+ * @skeletons: (array zero-terminated=1): The number skeletons to
+ *   create formatters for.
+ * @locales: (array zero-terminated=1): The locales to create
+ *   formatters for.
+ * @cancellable: (nullable): A [class@Gio.Cancellable].
+ * @callback: (scope async): The callback to call when done.
+ * @user_data: (closure): The data to pass to `callback`.
+ *
+ * Creates the shared formatters for every combination of
+ * `skeletons` and `locales` in a low-priority worker thread, as
+ * [func@NumberFormatter.get_shared] would, and formats a value with
+ * each of them so that the ICU data they use is already loaded by
+ * the time they are first needed.
+ *
+ * Combinations that fail do not stop the rest from being created.
+ */
+void
+icu_number_formatter_prewarm (const gchar * const  *skeletons,
+                              const gchar * const  *locales,
+                              GCancellable         *cancellable,
+                              GAsyncReadyCallback   callback,
+                              gpointer              user_data)
+{
+  g_autoptr (GTask) task = NULL;
+  PrewarmData *data = NULL;
+
+  g_return_if_fail (skeletons != NULL);
+  g_return_if_fail (locales != NULL);
+  g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+  data = g_new0 (PrewarmData, 1);
+  data->skeletons = g_strdupv ((GStrv) skeletons);
+  data->locales = g_strdupv ((GStrv) locales);
+
+  task = g_task_new (NULL, cancellable, callback, user_data);
+  g_task_set_source_tag (task, icu_number_formatter_prewarm);
+  g_task_set_priority (task, G_PRIORITY_LOW);
+  g_task_set_task_data (task, data, (GDestroyNotify) prewarm_data_free);
+  g_task_run_in_thread (task, prewarm_thread);
+}
+
+/**
+ * icu_number_formatter_prewarm_finish:
+ * @result: The [iface@Gio.AsyncResult] passed to the callback.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Finishes an operation started with
+ * [func@NumberFormatter.prewarm].
+ *
+ * Returns: `TRUE` if every formatter was created, `FALSE` if `error`
+ *   is set to the first failure.
+ */
+gboolean
+icu_number_formatter_prewarm_finish (GAsyncResult  *result,
+                                     GError       **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, NULL), FALSE);
+  g_return_val_if_fail (g_task_get_source_tag (G_TASK (result)) == icu_number_formatter_prewarm, FALSE);
+
+  return g_task_propagate_boolean (G_TASK (result), error);
+}
+
+IcuNumberFormatter *
+icu_number_formatter_ref (IcuNumberFormatter *self)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+
+  g_atomic_int_inc (&self->ref_count);
+
+  return self;
+}
+
+void
+icu_number_formatter_unref (IcuNumberFormatter *self)
+{
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (self->ref_count >= 1);
+
+  if (g_atomic_int_dec_and_test (&self->ref_count))
+    icu_number_formatter_free (self);
+}
+
+const UNumberFormatter *
+icu_number_formatter_get_uformatter (IcuNumberFormatter *self)
+{
+  UErrorCode ec = U_ZERO_ERROR;
+
+  g_return_val_if_fail (self != NULL, NULL);
+
+  return get_uformatter (self, &ec);
+}
+
+/**
+ * icu_number_formatter_get_symbols:
+ * @self: An [class@NumberFormatter].
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Gets the symbols `self` formats numbers with, as
+ * [func@NumberSymbols.get_for_locale] would for its locale.
+ *
+ * The currency and numbering system of the skeleton are taken into
+ * account, so the currency symbol and digits are those `self`
+ * actually writes.
+ *
+ * Returns: (transfer full): The [class@NumberSymbols] of `self`, or
+ *   `NULL` if `error` is set.
+ */
+IcuNumberSymbols *
+icu_number_formatter_get_symbols (IcuNumberFormatter  *self,
+                                  GError             **error)
+{
+  gchar id[ULOC_FULLNAME_CAPACITY] = {0};
+  g_autofree gchar *skeleton = NULL;
+  g_auto (GStrv) tokens = NULL;
+  gsize i = 0;
+  UErrorCode ec = U_ZERO_ERROR;
+
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+
+  uloc_canonicalize (self->locale, id, sizeof id, &ec);
+  if (ec == U_STRING_NOT_TERMINATED_WARNING)
+    ec = U_BUFFER_OVERFLOW_ERROR;
+
+  // The canonical form separates tokens by a single space.
+  skeleton = icu_number_skeleton_canonicalize (self->skeleton);
+  tokens = g_strsplit (skeleton, " ", -1);
+
+  for (i = 0; tokens[i] != NULL && U_SUCCESS (ec); i++)
+    {
+      if (g_str_has_prefix (tokens[i], "currency/"))
+        uloc_setKeywordValue ("currency", tokens[i] + strlen ("currency/"), id, sizeof id, &ec);
+      else if (g_str_has_prefix (tokens[i], "numbering-system/"))
+        uloc_setKeywordValue ("numbers", tokens[i] + strlen ("numbering-system/"), id, sizeof id, &ec);
+      else if (g_str_equal (tokens[i], "latin"))
+        uloc_setKeywordValue ("numbers", "latn", id, sizeof id, &ec);
+    }
+
+  if (icu_has_failed (ec, error))
+    return NULL;
+
+  return icu_number_symbols_get_for_locale (id, error);
+}
+
+/**
+ * icu_number_formatter_try_format_int:
+ * @self: An [class@NumberFormatter].
+ * @value: The value to format.
+ * @result: (out) (optional) (nullable) (transfer full): The return
+ *   location for the formatted number.
+ *
+ * Formats `value`, reporting failures through the returned status
+ * instead of a [struct@GLib.Error].
+ *
+ * Nothing is allocated when formatting fails, or when `result` is
+ * `NULL` and the value is only being validated.
+ *
+ * Returns: [enum@Status.OK] on success, or the reason of the failure.
+ */
+IcuStatus
+icu_number_formatter_try_format_int (IcuNumberFormatter  *self,
+                                     gint64               value,
+                                     IcuFormattedNumber **result)
+{
+  UFormattedNumber *uresult = NULL;
+  UErrorCode ec = U_ZERO_ERROR;
+
+  g_return_val_if_fail (self != NULL, ICU_STATUS_ILLEGAL_ARGUMENT_ERROR);
+  g_return_val_if_fail (self->ref_count >= 1, ICU_STATUS_ILLEGAL_ARGUMENT_ERROR);
+
+  if (result != NULL)
+    *result = NULL;
+
+  uresult = take_scratch_result (&ec);
+  if (U_SUCCESS (ec))
+    unumf_formatInt (get_uformatter (self, &ec), value, uresult, &ec);
+
+  return finish_try_format (uresult, ec, result);
+}
+
+/**
+ * icu_number_formatter_try_format_double:
+ * @self: An [class@NumberFormatter].
+ * @value: The value to format.
+ * @result: (out) (optional) (nullable) (transfer full): The return
+ *   location for the formatted number.
+ *
+ * Formats `value` like [method@NumberFormatter.try_format_int] does.
+ *
+ * Returns: [enum@Status.OK] on success, or the reason of the failure.
+ */
+IcuStatus
+icu_number_formatter_try_format_double (IcuNumberFormatter  *self,
+                                        gdouble              value,
+                                        IcuFormattedNumber **result)
+{
+  UFormattedNumber *uresult = NULL;
+  UErrorCode ec = U_ZERO_ERROR;
+
+  g_return_val_if_fail (self != NULL, ICU_STATUS_ILLEGAL_ARGUMENT_ERROR);
+  g_return_val_if_fail (self->ref_count >= 1, ICU_STATUS_ILLEGAL_ARGUMENT_ERROR);
+
+  if (result != NULL)
+    *result = NULL;
+
+  uresult = take_scratch_result (&ec);
+  if (U_SUCCESS (ec))
+    unumf_formatDouble (get_uformatter (self, &ec), value, uresult, &ec);
+
+  return finish_try_format (uresult, ec, result);
+}
+
+/**
+ * icu_number_formatter_try_format_decimal:
+ * @self: An [class@NumberFormatter].
+ * @value: The decimal number to format, e.g. `"-1234.5e3"`.
+ * @result: (out) (optional) (nullable) (transfer full): The return
+ *   location for the formatted number.
+ *
+ * Formats `value` like [method@NumberFormatter.try_format_int] does,
+ * which makes it a cheap way of validating untrusted decimal
+ * numbers.
+ *
+ * Numbers with an exponent beyond ±10000, which could take minutes to
+ * format, are rejected with [enum@Status.NUMBER_ARG_OUTOFBOUNDS_ERROR].
+ *
+ * Returns: [enum@Status.OK] on success, or the reason of the failure,
+ *   e.g. [enum@Status.DECIMAL_NUMBER_SYNTAX_ERROR] for malformed
+ *   numbers.
+ */
+IcuStatus
+icu_number_formatter_try_format_decimal (IcuNumberFormatter  *self,
+                                         const gchar         *value,
+                                         IcuFormattedNumber **result)
+{
+  return icu_number_formatter_try_format_decimal_len (self, value, -1, result);
+}
+
+/**
+ * icu_number_formatter_try_format_decimal_len:
+ * @self: An [class@NumberFormatter].
+ * @value: (array length=length): The decimal number to format.
+ * @length: The length of `value` in bytes, or -1 if it is
+ *   nul-terminated.
+ * @result: (out) (optional) (nullable) (transfer full): The return
+ *   location for the formatted number.
+ *
+ * Formats the first `length` bytes of `value` like
+ * [method@NumberFormatter.try_format_decimal] does, so that numbers
+ * can be formatted straight out of a larger buffer.
+ *
+ * Returns: [enum@Status.OK] on success, or the reason of the failure.
+ */
+IcuStatus
+icu_number_formatter_try_format_decimal_len (IcuNumberFormatter  *self,
+                                             const gchar         *value,
+                                             gssize               length,
+                                             IcuFormattedNumber **result)
+{
+  UFormattedNumber *uresult = NULL;
+  UErrorCode ec = U_ZERO_ERROR;
+
+  g_return_val_if_fail (self != NULL, ICU_STATUS_ILLEGAL_ARGUMENT_ERROR);
+  g_return_val_if_fail (self->ref_count >= 1, ICU_STATUS_ILLEGAL_ARGUMENT_ERROR);
+  g_return_val_if_fail (value != NULL || length == 0, ICU_STATUS_ILLEGAL_ARGUMENT_ERROR);
+
+  if (result != NULL)
+    *result = NULL;
+
+  uresult = take_scratch_result (&ec);
+  if (U_SUCCESS (ec))
+    format_decimal (self, value, length, uresult, &ec);
+
+  return finish_try_format (uresult, ec, result);
+}
+
+IcuFormattedNumber *
+icu_number_formatter_format_int (IcuNumberFormatter  *self,
+                                 gint64               value,
+                                 GError             **error)
+{
+  IcuFormattedNumber *result = NULL;
+  IcuStatus status = ICU_STATUS_OK;
+
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+
+  status = icu_number_formatter_try_format_int (self, value, &result);
+  if (icu_has_failed ((UErrorCode) status, error))
+    return NULL;
+
+  return result;
+}
+
+IcuFormattedNumber *
+icu_number_formatter_format_double (IcuNumberFormatter  *self,
+                                    gdouble              value,
+                                    GError             **error)
+{
+  IcuFormattedNumber *result = NULL;
+  IcuStatus status = ICU_STATUS_OK;
+
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+
+  status = icu_number_formatter_try_format_double (self, value, &result);
+  if (icu_has_failed ((UErrorCode) status, error))
+    return NULL;
+
+  return result;
+}
+
+/**
+ * icu_number_formatter_format_decimal:
+ * @self: An [class@NumberFormatter].
+ * @value: The decimal number to format, e.g. `"-1234.5e3"`.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Formats `value`, a decimal number of any precision.
+ *
+ * Numbers with an exponent beyond ±10000, which could take minutes to
+ * format, fail with [error@StandardError.NUMBER_ARG_OUTOFBOUNDS_ERROR]
+ * rather than being formatted.
+ *
+ * Returns: (transfer full): The formatted number, or `NULL` if `error`
+ *   is set.
+ */
+IcuFormattedNumber *
+icu_number_formatter_format_decimal (IcuNumberFormatter  *self,
+                                     const gchar         *value,
+                                     GError             **error)
+{
+  g_return_val_if_fail (value != NULL, NULL);
+
+  return icu_number_formatter_format_decimal_len (self, value, -1, error);
+}
+
+/**
+ * icu_number_formatter_format_decimal_len:
+ * @self: An [class@NumberFormatter].
+ * @value: (array length=length): The decimal number to format.
+ * @length: The length of `value` in bytes, or -1 if it is
+ *   nul-terminated.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Formats the first `length` bytes of `value`, which does not need
+ * to be nul-terminated, so that numbers can be formatted straight out
+ * of a larger buffer without copying them first.
+ *
+ * Returns: (transfer full): The formatted number, or `NULL` if `error`
+ *   is set.
+ */
+IcuFormattedNumber *
+icu_number_formatter_format_decimal_len (IcuNumberFormatter  *self,
+                                         const gchar         *value,
+                                         gssize               length,
+                                         GError             **error)
+{
+  IcuFormattedNumber *result = NULL;
+  IcuStatus status = ICU_STATUS_OK;
+
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+  g_return_val_if_fail (value != NULL || length == 0, NULL);
+
+  status = icu_number_formatter_try_format_decimal_len (self, value, length, &result);
+  if (icu_has_failed ((UErrorCode) status, error))
+    return NULL;
+
+  return result;
+}
+
+/**
+ * icu_number_formatter_format_decimal_batch: (skip)
+ * @self: An [class@NumberFormatter].
+ * @buffer: The buffer holding the decimal numbers to format.
+ * @spans: The `2 * n_values` offsets and lengths delimiting the
+ *   numbers: number `i` spans `spans[2 * i + 1]` bytes from
+ *   `spans[2 * i]` in `buffer`.
+ * @n_values: The number of decimal numbers to format.
+ * @arena: The string to append all formatted numbers to.
+ * @out_offsets: The return location for the `n_values + 1` offsets
+ *   delimiting each formatted number in `arena`.
+ * @statuses: (nullable): The return location for the `n_values`
+ *   statuses of each number, or `NULL` to stop at the first failure.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Formats every decimal number delimited by `spans` in `buffer`,
+ * appending the results one after another to `arena`, which is
+ * useful for formatting the numbers of a memory-mapped file in
+ * place.
+ *
+ * The results are not nul-terminated. When `statuses` is given,
+ * numbers that fail to format leave an empty result and their
+ * status behind, and the rest are still formatted.
+ *
+ * Returns: `TRUE` on success, `FALSE` if `error` is set, in which case
+ *   `arena` is left unchanged.
+ */
+gboolean
+icu_number_formatter_format_decimal_batch (IcuNumberFormatter  *self,
+                                           const gchar         *buffer,
+                                           const gsize         *spans,
+                                           gsize                n_values,
+                                           GString             *arena,
+                                           gsize               *out_offsets,
+                                           IcuStatus           *statuses,
+                                           GError             **error)
+{
+  DecimalBatch batch = { buffer, spans };
+
+  g_return_val_if_fail (self != NULL, FALSE);
+  g_return_val_if_fail (self->ref_count >= 1, FALSE);
+  g_return_val_if_fail (buffer != NULL || n_values == 0, FALSE);
+  g_return_val_if_fail (spans != NULL || n_values == 0, FALSE);
+  g_return_val_if_fail (arena != NULL, FALSE);
+  g_return_val_if_fail (out_offsets != NULL, FALSE);
+
+  return format_batch (self, get_decimal, &batch, n_values, arena, out_offsets, statuses, error);
+}
+
+/**
+ * icu_number_formatter_format_fixed:
+ * @self: An [class@NumberFormatter].
+ * @mantissa: The unscaled value, e.g. an amount in cents.
+ * @scale: The number of decimal places of `mantissa`.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Formats the fixed-point number `mantissa` × 10^-`scale`, e.g.
+ * `12345` with a scale of `2` formats as `123.45`, without the
+ * rounding errors of going through a double nor the cost of
+ * converting it to a decimal number first.
+ *
+ * Returns: (transfer full): The formatted number, or `NULL` if `error`
+ *   is set.
+ */
+IcuFormattedNumber *
+icu_number_formatter_format_fixed (IcuNumberFormatter  *self,
+                                   gint64               mantissa,
+                                   gint32               scale,
+                                   GError             **error)
+{
+  IcuFormattedNumber *result = NULL;
+  gchar buffer[DECIMAL_BUFFER_SIZE];
+  gchar *start = NULL;
+  IcuStatus status = ICU_STATUS_OK;
+
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+
+  start = write_fixed (mantissa, scale, buffer + sizeof buffer);
+
+  status = icu_number_formatter_try_format_decimal_len (self, start, buffer + sizeof buffer - start, &result);
+  if (icu_has_failed ((UErrorCode) status, error))
+    return NULL;
+
+  return result;
+}
+
+/**
+ * icu_number_formatter_format_int128:
+ * @self: An [class@NumberFormatter].
+ * @hi: The upper 64 bits of the value.
+ * @lo: The lower 64 bits of the value.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Formats the 128-bit two's complement integer made of `hi` and `lo`,
+ * as used for amounts that do not fit in 64 bits, without converting
+ * it to a decimal number first.
+ *
+ * Returns: (transfer full): The formatted number, or `NULL` if `error`
+ *   is set.
+ */
+IcuFormattedNumber *
+icu_number_formatter_format_int128 (IcuNumberFormatter  *self,
+                                    gint64               hi,
+                                    guint64              lo,
+                                    GError             **error)
+{
+  IcuFormattedNumber *result = NULL;
+  gchar buffer[DECIMAL_BUFFER_SIZE];
+  gchar *start = NULL;
+  IcuStatus status = ICU_STATUS_OK;
+
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+
+  start = write_int128 (hi, lo, buffer + sizeof buffer);
+
+  status = icu_number_formatter_try_format_decimal_len (self, start, buffer + sizeof buffer - start, &result);
+  if (icu_has_failed ((UErrorCode) status, error))
+    return NULL;
+
+  return result;
+}
+
+/**
+ * icu_number_formatter_format_fixed_batch: (skip)
+ * @self: An [class@NumberFormatter].
+ * @mantissas: The unscaled values to format.
+ * @scale: The number of decimal places shared by all `mantissas`.
+ * @n_values: The number of values to format.
+ * @arena: The string to append all formatted numbers to.
+ * @out_offsets: The return location for the `n_values + 1` offsets
+ *   delimiting each formatted number in `arena`.
+ * @statuses: (nullable): The return location for the `n_values`
+ *   statuses of each number, or `NULL` to stop at the first failure.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Formats a column of fixed-point numbers like
+ * [method@NumberFormatter.format_fixed] does, appending the results
+ * to `arena` like [method@NumberFormatter.format_decimal_batch] does.
+ *
+ * Returns: `TRUE` on success, `FALSE` if `error` is set, in which case
+ *   `arena` is left unchanged.
+ */
+gboolean
+icu_number_formatter_format_fixed_batch (IcuNumberFormatter  *self,
+                                         const gint64        *mantissas,
+                                         gint32               scale,
+                                         gsize                n_values,
+                                         GString             *arena,
+                                         gsize               *out_offsets,
+                                         IcuStatus           *statuses,
+                                         GError             **error)
+{
+  FixedBatch batch = { mantissas, scale };
+
+  g_return_val_if_fail (self != NULL, FALSE);
+  g_return_val_if_fail (self->ref_count >= 1, FALSE);
+  g_return_val_if_fail (mantissas != NULL || n_values == 0, FALSE);
+  g_return_val_if_fail (arena != NULL, FALSE);
+  g_return_val_if_fail (out_offsets != NULL, FALSE);
+
+  if (self->specialization != NULL && is_specialized_scale (scale))
+    {
+      gsize i = 0;
+
+      out_offsets[0] = arena->len;
+
+      for (i = 0; i < n_values; i++)
+        {
+          append_specialized (self->specialization, mantissas[i], scale, arena);
+          out_offsets[i + 1] = arena->len;
+
+          if (statuses != NULL)
+            statuses[i] = ICU_STATUS_OK;
+        }
+
+      return TRUE;
+    }
+
+  return format_batch (self, get_fixed, &batch, n_values, arena, out_offsets, statuses, error);
+}
+
+/**
+ * icu_number_formatter_format_int128_batch: (skip)
+ * @self: An [class@NumberFormatter].
+ * @his: The upper 64 bits of each value.
+ * @los: The lower 64 bits of each value.
+ * @n_values: The number of values to format.
+ * @arena: The string to append all formatted numbers to.
+ * @out_offsets: The return location for the `n_values + 1` offsets
+ *   delimiting each formatted number in `arena`.
+ * @statuses: (nullable): The return location for the `n_values`
+ *   statuses of each number, or `NULL` to stop at the first failure.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Formats a column of 128-bit integers like
+ * [method@NumberFormatter.format_int128] does, appending the results
+ * to `arena` like [method@NumberFormatter.format_decimal_batch] does.
+ *
+ * Returns: `TRUE` on success, `FALSE` if `error` is set, in which case
+ *   `arena` is left unchanged.
+ */
+gboolean
+icu_number_formatter_format_int128_batch (IcuNumberFormatter  *self,
+                                          const gint64        *his,
+                                          const guint64       *los,
+                                          gsize                n_values,
+                                          GString             *arena,
+                                          gsize               *out_offsets,
+                                          IcuStatus           *statuses,
+                                          GError             **error)
+{
+  Int128Batch batch = { his, los };
+
+  g_return_val_if_fail (self != NULL, FALSE);
+  g_return_val_if_fail (self->ref_count >= 1, FALSE);
+  g_return_val_if_fail (his != NULL || n_values == 0, FALSE);
+  g_return_val_if_fail (los != NULL || n_values == 0, FALSE);
+  g_return_val_if_fail (arena != NULL, FALSE);
+  g_return_val_if_fail (out_offsets != NULL, FALSE);
+
+  return format_batch (self, get_int128, &batch, n_values, arena, out_offsets, statuses, error);
+}
+
+/**
+ * icu_number_formatter_append_int:
+ * @self: An [class@NumberFormatter].
+ * @value: The value to format.
+ * @out: The string to append the formatted value to.
+ * @fields: (nullable) (element-type IcuFieldPosition): The array to
+ *   append the number fields of the formatted value to, or `NULL`.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Formats `value` straight into `out` as UTF-8.
+ *
+ * The indexes of the field positions appended to `fields` are byte
+ * offsets into `out`, unlike those of [class@FormattedNumber], which
+ * count UTF-16 code units.
+ *
+ * When the memo of `self` is enabled, see
+ * [method@NumberFormatter.set_memo_capacity], values that were
+ * already formatted are copied out of it instead.
+ *
+ * Returns: `TRUE` on success, `FALSE` if `error` is set, in which case
+ *   `out` and `fields` are left unchanged.
+ */
+gboolean
+icu_number_formatter_append_int (IcuNumberFormatter  *self,
+                                 gint64               value,
+                                 GString             *out,
+                                 GArray              *fields,
+                                 GError             **error)
+{
+  g_return_val_if_fail (self != NULL, FALSE);
+  g_return_val_if_fail (self->ref_count >= 1, FALSE);
+  g_return_val_if_fail (out != NULL, FALSE);
+
+  return append_value (self, (guint64) value, FALSE, out, fields, error);
+}
+
+/**
+ * icu_number_formatter_append_double:
+ * @self: An [class@NumberFormatter].
+ * @value: The value to format.
+ * @out: The string to append the formatted value to.
+ * @fields: (nullable) (element-type IcuFieldPosition): The array to
+ *   append the number fields of the formatted value to, or `NULL`.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Formats `value` straight into `out` like
+ * [method@NumberFormatter.append_int] does.
+ *
+ * Values are memoized by their exact bit pattern, so e.g. `0.0` and
+ * `-0.0` are memoized separately.
+ *
+ * Returns: `TRUE` on success, `FALSE` if `error` is set, in which case
+ *   `out` and `fields` are left unchanged.
+ */
+gboolean
+icu_number_formatter_append_double (IcuNumberFormatter  *self,
+                                    gdouble              value,
+                                    GString             *out,
+                                    GArray              *fields,
+                                    GError             **error)
+{
+  guint64 bits = 0;
+
+  g_return_val_if_fail (self != NULL, FALSE);
+  g_return_val_if_fail (self->ref_count >= 1, FALSE);
+  g_return_val_if_fail (out != NULL, FALSE);
+
+  memcpy (&bits, &value, sizeof bits);
+
+  return append_value (self, bits, TRUE, out, fields, error);
+}
+
+/**
+ * icu_number_formatter_set_memo_capacity:
+ * @self: An [class@NumberFormatter].
+ * @capacity: The maximum number of values to memoize, or 0 to
+ *   disable the memo.
+ *
+ * Enables memoizing the output of [method@NumberFormatter.append_int]
+ * and [method@NumberFormatter.append_double], so that formatting a
+ * value that was already formatted is a lookup and a copy.
+ *
+ * This pays off when the same values are formatted over and over,
+ * like the counters and prices of a view that is refreshed
+ * periodically, which [method@NumberFormatter.get_memo_stats] can
+ * tell. Once `capacity` values are memoized, the memo starts over.
+ *
+ * The memo is disabled by default. Setting the capacity empties it and
+ * resets its statistics.
+ */
+void
+icu_number_formatter_set_memo_capacity (IcuNumberFormatter *self,
+                                        guint               capacity)
+{
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (self->ref_count >= 1);
+
+  g_mutex_lock (&self->memo_lock);
+
+  g_clear_pointer (&self->memo, g_hash_table_unref);
+
+  if (capacity > 0)
+    self->memo = g_hash_table_new_full (memo_entry_hash, memo_entry_equal, g_free, NULL);
+
+  g_atomic_int_set (&self->memo_capacity, capacity);
+  self->memo_hits = 0;
+  self->memo_misses = 0;
+
+  g_mutex_unlock (&self->memo_lock);
+}
+
+/**
+ * icu_number_formatter_get_memo_capacity:
+ * @self: An [class@NumberFormatter].
+ *
+ * Gets the maximum number of values memoized by `self`.
+ *
+ * Returns: The capacity of the memo, or 0 if it is disabled.
+ */
+guint
+icu_number_formatter_get_memo_capacity (IcuNumberFormatter *self)
+{
+  g_return_val_if_fail (self != NULL, 0);
+  g_return_val_if_fail (self->ref_count >= 1, 0);
+
+  return g_atomic_int_get (&self->memo_capacity);
+}
+
+/**
+ * icu_number_formatter_get_memo_stats:
+ * @self: An [class@NumberFormatter].
+ * @hits: (out) (optional): The return location for the number of
+ *   values copied out of the memo.
+ * @misses: (out) (optional): The return location for the number of
+ *   values that had to be formatted.
+ *
+ * Gets how well the memo of `self` has worked since it was enabled.
+ */
+void
+icu_number_formatter_get_memo_stats (IcuNumberFormatter *self,
+                                     guint64            *hits,
+                                     guint64            *misses)
+{
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (self->ref_count >= 1);
+
+  g_mutex_lock (&self->memo_lock);
+
+  if (hits != NULL)
+    *hits = self->memo_hits;
+
+  if (misses != NULL)
+    *misses = self->memo_misses;
+
+  g_mutex_unlock (&self->memo_lock);
+}
+
+/**
+ * icu_number_formatter_precompute_int_range:
+ * @self: An [class@NumberFormatter].
+ * @min: The first integer of the range.
+ * @max: The last integer of the range, which can hold up to 65536
+ *   integers.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Formats every integer from `min` to `max` once into a table, after
+ * which [method@NumberFormatter.lookup_int] gets their outputs without
+ * formatting anything, and [method@NumberFormatter.append_int] copies
+ * them out of it when no fields are asked for.
+ *
+ * This is meant for small domains that are formatted over and over,
+ * like counts, ages, page numbers or percentages. The memory the table
+ * takes up is given by [method@NumberFormatter.get_precomputed_size].
+ *
+ * Precomputing another range replaces the table, but the strings
+ * borrowed from the previous one stay valid as long as `self` does.
+ *
+ * Returns: `TRUE` on success, `FALSE` if `error` is set, e.g. to
+ *   [error@StandardError.ILLEGAL_ARGUMENT_ERROR] if the range holds
+ *   more than 65536 integers.
+ */
+gboolean
+icu_number_formatter_precompute_int_range (IcuNumberFormatter  *self,
+                                           gint64               min,
+                                           gint64               max,
+                                           GError             **error)
+{
+  g_autoptr (GString) blob = NULL;
+  g_autofree guint32 *offsets = NULL;
+  UFormattedNumber *uresult = NULL;
+  IntTable *table = NULL;
+  gsize n_values = 0;
+  gsize i = 0;
+  UErrorCode ec = U_ZERO_ERROR;
+
+  g_return_val_if_fail (self != NULL, FALSE);
+  g_return_val_if_fail (self->ref_count >= 1, FALSE);
+  g_return_val_if_fail (min <= max, FALSE);
+
+  if ((guint64) max - (guint64) min >= MAX_PRECOMPUTED_INTS)
+    return !icu_has_failed (U_ILLEGAL_ARGUMENT_ERROR, error);
+
+  n_values = (gsize) ((guint64) max - (guint64) min) + 1;
+  offsets = g_new (guint32, n_values + 1);
+  blob = g_string_sized_new (n_values * 8);
+
+  uresult = take_scratch_result (&ec);
+
+  for (i = 0; i < n_values && U_SUCCESS (ec); i++)
+    {
+      offsets[i] = (guint32) blob->len;
+
+      unumf_formatInt (get_uformatter (self, &ec), min + (gint64) i, uresult, &ec);
+      append_result (uresult, blob, &ec);
+      g_string_append_c (blob, '\0');
+    }
+
+  give_back_scratch_result (uresult);
+
+  if (icu_has_failed (ec, error))
+    return FALSE;
+
+  offsets[n_values] = (guint32) blob->len;
+
+  table = g_malloc0 (sizeof (IntTable) + (n_values + 1) * sizeof (guint32) + blob->len);
+  table->min = min;
+  table->max = max;
+  table->size = (n_values + 1) * sizeof (guint32) + blob->len;
+  table->offsets = memcpy (table + 1, offsets, (n_values + 1) * sizeof (guint32));
+  table->blob = memcpy ((gchar *) (table + 1) + (n_values + 1) * sizeof (guint32), blob->str, blob->len);
+
+  g_mutex_lock (&self->memo_lock);
+
+  if (self->int_table != NULL)
+    self->retired_int_tables = g_slist_prepend (self->retired_int_tables, self->int_table);
+
+  g_atomic_pointer_set (&self->int_table, table);
+
+  g_mutex_unlock (&self->memo_lock);
+
+  return TRUE;
+}
+
+/**
+ * icu_number_formatter_lookup_int:
+ * @self: An [class@NumberFormatter].
+ * @value: The value to look up.
+ * @length: (out) (optional): The return location for the length of
+ *   the output in bytes.
+ *
+ * Gets the output of `value` out of the table made by
+ * [method@NumberFormatter.precompute_int_range].
+ *
+ * Returns: (transfer none) (nullable): The output of `value`, owned by
+ *   `self`, or `NULL` if it is not in the precomputed range.
+ */
+const gchar *
+icu_number_formatter_lookup_int (IcuNumberFormatter *self,
+                                 gint64              value,
+                                 gsize              *length)
+{
+  IntTable *table = NULL;
+  gsize i = 0;
+
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+
+  table = g_atomic_pointer_get (&self->int_table);
+  if (table == NULL || value < table->min || value > table->max)
+    return NULL;
+
+  i = (gsize) ((guint64) value - (guint64) table->min);
+
+  if (length != NULL)
+    *length = table->offsets[i + 1] - table->offsets[i] - 1;
+
+  return table->blob + table->offsets[i];
+}
+
+/**
+ * icu_number_formatter_get_precomputed_size:
+ * @self: An [class@NumberFormatter].
+ *
+ * Gets the memory taken up by the table made by
+ * [method@NumberFormatter.precompute_int_range].
+ *
+ * Returns: The size of the table in bytes, or 0 if there is none.
+ */
+gsize
+icu_number_formatter_get_precomputed_size (IcuNumberFormatter *self)
+{
+  IntTable *table = NULL;
+
+  g_return_val_if_fail (self != NULL, 0);
+  g_return_val_if_fail (self->ref_count >= 1, 0);
+
+  table = g_atomic_pointer_get (&self->int_table);
+
+  return table != NULL ? table->size : 0;
+}
+
+/**
+ * icu_number_formatter_save_cache:
+ * @self: An [class@NumberFormatter].
+ * @filename: The path of the file to save the cache to.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Saves the outputs precomputed with
+ * [method@NumberFormatter.precompute_int_range] and memoized by
+ * [method@NumberFormatter.set_memo_capacity] to `filename`, so that
+ * later processes formatting the same values can start with them
+ * through [method@NumberFormatter.load_cache].
+ *
+ * The file is replaced atomically, so processes loading it never see
+ * it half-written.
+ *
+ * Returns: `TRUE` on success, `FALSE` if `error` is set.
+ */
+gboolean
+icu_number_formatter_save_cache (IcuNumberFormatter  *self,
+                                 const gchar         *filename,
+                                 GError             **error)
+{
+  g_autoptr (GByteArray) bytes = NULL;
+  g_autoptr (GArray) records = NULL;
+  g_autoptr (GArray) fields = NULL;
+  g_autoptr (GString) strings = NULL;
+  g_autofree gchar *key = NULL;
+  CacheFileHeader header = {0};
+  GHashTableIter iter;
+  MemoEntry *entry = NULL;
+  IntTable *table = NULL;
+  guint32 i = 0;
+
+  g_return_val_if_fail (self != NULL, FALSE);
+  g_return_val_if_fail (self->ref_count >= 1, FALSE);
+  g_return_val_if_fail (filename != NULL, FALSE);
+
+  key = get_shared_key (self->skeleton, self->locale, error);
+  if (key == NULL)
+    return FALSE;
+
+  records = g_array_new (FALSE, FALSE, sizeof (CacheFileRecord));
+  fields = g_array_new (FALSE, FALSE, sizeof (IcuFieldPosition));
+  strings = g_string_new (NULL);
+
+  memcpy (header.magic, CACHE_FILE_MAGIC, sizeof header.magic);
+  header.version = CACHE_FILE_VERSION;
+  header.key_length = strlen (key) + 1;
+  u_getVersion (header.icu_version);
+
+  // The integer table goes first, so that its offsets are also offsets
+  // into the strings section.
+  table = g_atomic_pointer_get (&self->int_table);
+  if (table != NULL)
+    {
+      header.int_min = table->min;
+      header.n_ints = (guint32) ((guint64) table->max - (guint64) table->min) + 1;
+
+      g_string_append_len (strings, table->blob, table->offsets[header.n_ints]);
+    }
+
+  g_mutex_lock (&self->memo_lock);
+
+  if (self->memo != NULL)
+    {
+      g_hash_table_iter_init (&iter, self->memo);
+
+      while (g_hash_table_iter_next (&iter, (gpointer *) &entry, NULL))
+        {
+          CacheFileRecord record = {0};
+
+          // Values memoized before a cache file was loaded may also be
+          // in it, and are only saved once, along with the rest of it.
+          if (self->mapped_memo != NULL && mapped_memo_lookup (self->mapped_memo, entry->bits, entry->is_double) != NULL)
+            continue;
+
+          record = (CacheFileRecord) {
+            .bits = entry->bits,
+            .is_double = entry->is_double,
+            .first_field = fields->len,
+            .n_fields = entry->n_fields,
+            .length = (guint32) entry->length,
+            .string_offset = strings->len,
+          };
+
+          g_array_append_vals (fields, entry->fields, entry->n_fields);
+          g_string_append_len (strings, memo_entry_get_string (entry), entry->length);
+          g_string_append_c (strings, '\0');
+          g_array_append_val (records, record);
+        }
+    }
+
+  for (i = 0; self->mapped_memo != NULL && i < self->mapped_memo->n_records; i++)
+    {
+      const CacheFileRecord *mapped = &self->mapped_memo->records[i];
+      CacheFileRecord record = *mapped;
+
+      record.first_field = fields->len;
+      record.string_offset = strings->len;
+
+      g_array_append_vals (fields, self->mapped_memo->fields + mapped->first_field, mapped->n_fields);
+      g_string_append_len (strings, self->mapped_memo->strings + mapped->string_offset, mapped->length);
+      g_string_append_c (strings, '\0');
+      g_array_append_val (records, record);
+    }
+
+  g_mutex_unlock (&self->memo_lock);
+
+  g_array_sort (records, sort_records);
+
+  header.n_records = records->len;
+  header.n_fields = fields->len;
+  header.strings_size = strings->len;
+
+  bytes = g_byte_array_new ();
+  append_section (bytes, &header, sizeof header);
+  append_section (bytes, key, header.key_length);
+
+  if (table != NULL)
+    append_section (bytes, table->offsets, (header.n_ints + 1) * sizeof (guint32));
+
+  append_section (bytes, records->data, records->len * sizeof (CacheFileRecord));
+  append_section (bytes, fields->data, fields->len * sizeof (IcuFieldPosition));
+  g_byte_array_append (bytes, (const guint8 *) strings->str, strings->len);
+
+  header.checksum = checksum_bytes (bytes->data + sizeof header, bytes->len - sizeof header);
+  memcpy (bytes->data, &header, sizeof header);
+
+  return g_file_set_contents (filename, (const gchar *) bytes->data, bytes->len, error);
+}
+
+/**
+ * icu_number_formatter_load_cache:
+ * @self: An [class@NumberFormatter].
+ * @filename: The path of the file to load the cache from.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Loads a cache saved by [method@NumberFormatter.save_cache], which
+ * makes the outputs in it be used like those precomputed or memoized
+ * by `self`.
+ *
+ * The file is memory-mapped read-only, so processes loading the same
+ * file share its memory through the page cache. It must have been
+ * saved by a formatter with an equivalent skeleton and locale, on a
+ * machine with the same ICU version and byte order.
+ *
+ * A precomputed integer table in the file replaces the one of `self`,
+ * and the memoized outputs in it replace those of a previously loaded
+ * file.
+ *
+ * Returns: `TRUE` on success, `FALSE` if `error` is set, e.g. to
+ *   [error@StandardError.INVALID_FORMAT_ERROR] if the file does not
+ *   match `self` or is damaged.
+ */
+gboolean
+icu_number_formatter_load_cache (IcuNumberFormatter  *self,
+                                 const gchar         *filename,
+                                 GError             **error)
+{
+  g_autoptr (GMappedFile) file = NULL;
+  g_autofree gchar *key = NULL;
+  g_autofree MappedMemo *memo = NULL;
+  CacheFileHeader header = {0};
+  UVersionInfo icu_version = {0};
+  const gchar *contents = NULL;
+  const gchar *key_section = NULL;
+  const guint32 *offsets = NULL;
+  const CacheFileRecord *records = NULL;
+  const IcuFieldPosition *fields = NULL;
+  const gchar *strings = NULL;
+  IntTable *table = NULL;
+  guint64 expected_length = 0;
+  gsize length = 0;
+
+  g_return_val_if_fail (self != NULL, FALSE);
+  g_return_val_if_fail (self->ref_count >= 1, FALSE);
+  g_return_val_if_fail (filename != NULL, FALSE);
+
+  key = get_shared_key (self->skeleton, self->locale, error);
+  if (key == NULL)
+    return FALSE;
+
+  file = g_mapped_file_new (filename, FALSE, error);
+  if (file == NULL)
+    return FALSE;
+
+  contents = g_mapped_file_get_contents (file);
+  length = g_mapped_file_get_length (file);
+
+  if (length < sizeof header)
+    goto invalid;
+
+  memcpy (&header, contents, sizeof header);
+  u_getVersion (icu_version);
+
+  if (memcmp (header.magic, CACHE_FILE_MAGIC, sizeof header.magic) != 0
+      || header.version != CACHE_FILE_VERSION
+      || memcmp (header.icu_version, icu_version, sizeof icu_version) != 0
+      || header.n_ints > MAX_PRECOMPUTED_INTS)
+    goto invalid;
+
+  // Every count is 32 bits wide, so none of these can overflow.
+  expected_length = sizeof header
+                    + get_section_size (header.key_length, 1)
+                    + (header.n_ints > 0 ? get_section_size (header.n_ints + 1, sizeof (guint32)) : 0)
+                    + get_section_size (header.n_records, sizeof (CacheFileRecord))
+                    + get_section_size (header.n_fields, sizeof (IcuFieldPosition));
+
+  if (header.strings_size > G_MAXUINT64 - expected_length || expected_length + header.strings_size != length)
+    goto invalid;
+
+  if (checksum_bytes ((const guint8 *) contents + sizeof header, length - sizeof header) != header.checksum)
+    goto invalid;
+
+  key_section = contents + sizeof header;
+  offsets = (const guint32 *) (key_section + get_section_size (header.key_length, 1));
+  records = (const CacheFileRecord *) ((const gchar *) offsets
+                                       + (header.n_ints > 0 ? get_section_size (header.n_ints + 1, sizeof (guint32)) : 0));
+  fields = (const IcuFieldPosition *) ((const gchar *) records
+                                       + get_section_size (header.n_records, sizeof (CacheFileRecord)));
+  strings = (const gchar *) fields + get_section_size (header.n_fields, sizeof (IcuFieldPosition));
+
+  if (header.key_length != strlen (key) + 1 || memcmp (key_section, key, header.key_length) != 0)
+    goto invalid;
+
+  if (!check_cache_file (&header, offsets, records, fields, strings))
+    goto invalid;
+
+  memo = g_new0 (MappedMemo, 1);
+  memo->file = g_mapped_file_ref (file);
+  memo->records = records;
+  memo->n_records = header.n_records;
+  memo->fields = fields;
+  memo->strings = strings;
+
+  if (header.n_ints > 0)
+    {
+      table = g_new0 (IntTable, 1);
+      table->min = header.int_min;
+      table->max = header.int_min + (gint64) (header.n_ints - 1);
+      table->size = (header.n_ints + 1) * sizeof (guint32) + offsets[header.n_ints];
+      table->offsets = offsets;
+      table->blob = strings;
+      table->file = g_mapped_file_ref (file);
+    }
+
+  g_mutex_lock (&self->memo_lock);
+
+  g_clear_pointer (&self->mapped_memo, mapped_memo_free);
+  g_atomic_pointer_set (&self->mapped_memo, g_steal_pointer (&memo));
+
+  if (table != NULL)
+    {
+      if (self->int_table != NULL)
+        self->retired_int_tables = g_slist_prepend (self->retired_int_tables, self->int_table);
+
+      g_atomic_pointer_set (&self->int_table, table);
+    }
+
+  g_mutex_unlock (&self->memo_lock);
+
+  return TRUE;
+
+invalid:
+  icu_has_failed (U_INVALID_FORMAT_ERROR, error);
+  return FALSE;
+}
+
+/**
+ * icu_number_formatter_format_int_strv:
+ * @self: An [class@NumberFormatter].
+ * @values: (array length=n_values): The values to format.
+ * @n_values: The number of values to format.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Formats every value in `values` into a string.
+ *
+ * This takes a single call from language bindings, instead of one
+ * call to format each value, another to turn it into a string and
+ * another to free it. Like [method@NumberFormatter.append_int], it
+ * uses the memo and precomputed table of `self`.
+ *
+ * Returns: (transfer full) (array zero-terminated=1): The formatted
+ *   values, or `NULL` if `error` is set.
+ */
+GStrv
+icu_number_formatter_format_int_strv (IcuNumberFormatter  *self,
+                                      const gint64        *values,
+                                      gsize                n_values,
+                                      GError             **error)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+  g_return_val_if_fail (values != NULL || n_values == 0, NULL);
+
+  return format_strv (self, values, FALSE, n_values, error);
+}
+
+/**
+ * icu_number_formatter_format_double_strv:
+ * @self: An [class@NumberFormatter].
+ * @values: (array length=n_values): The values to format.
+ * @n_values: The number of values to format.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Formats every value in `values` into a string, like
+ * [method@NumberFormatter.format_int_strv] does.
+ *
+ * Returns: (transfer full) (array zero-terminated=1): The formatted
+ *   values, or `NULL` if `error` is set.
+ */
+GStrv
+icu_number_formatter_format_double_strv (IcuNumberFormatter  *self,
+                                         const gdouble       *values,
+                                         gsize                n_values,
+                                         GError             **error)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+  g_return_val_if_fail (values != NULL || n_values == 0, NULL);
+
+  return format_strv (self, values, TRUE, n_values, error);
+}
+
+/**
+ * icu_number_formatter_format_int_packed:
+ * @self: An [class@NumberFormatter].
+ * @values: (array length=n_values): The values to format.
+ * @n_values: The number of values to format.
+ * @offsets: (out) (array length=n_offsets) (transfer full): The return
+ *   location for the offsets delimiting each formatted value.
+ * @n_offsets: (out): The return location for the number of offsets,
+ *   which is `n_values + 1`.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Formats every value in `values` into a single buffer of UTF-8, in
+ * which value `i` spans from `offsets[i]` to `offsets[i + 1]`.
+ *
+ * The formatted values are not nul-terminated. Compared to
+ * [method@NumberFormatter.format_int_strv], this makes two
+ * allocations whatever the number of values, which is cheaper when
+ * they are going to be copied elsewhere anyway.
+ *
+ * Returns: (transfer full): The formatted values, or `NULL` if `error`
+ *   is set.
+ */
+GBytes *
+icu_number_formatter_format_int_packed (IcuNumberFormatter  *self,
+                                        const gint64        *values,
+                                        gsize                n_values,
+                                        gsize              **offsets,
+                                        gsize               *n_offsets,
+                                        GError             **error)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+  g_return_val_if_fail (values != NULL || n_values == 0, NULL);
+  g_return_val_if_fail (offsets != NULL, NULL);
+  g_return_val_if_fail (n_offsets != NULL, NULL);
+
+  return format_packed (self, values, FALSE, n_values, offsets, n_offsets, error);
+}
+
+/**
+ * icu_number_formatter_format_double_packed:
+ * @self: An [class@NumberFormatter].
+ * @values: (array length=n_values): The values to format.
+ * @n_values: The number of values to format.
+ * @offsets: (out) (array length=n_offsets) (transfer full): The return
+ *   location for the offsets delimiting each formatted value.
+ * @n_offsets: (out): The return location for the number of offsets,
+ *   which is `n_values + 1`.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Formats every value in `values` into a single buffer of UTF-8, like
+ * [method@NumberFormatter.format_int_packed] does.
+ *
+ * Returns: (transfer full): The formatted values, or `NULL` if `error`
+ *   is set.
+ */
+GBytes *
+icu_number_formatter_format_double_packed (IcuNumberFormatter  *self,
+                                           const gdouble       *values,
+                                           gsize                n_values,
+                                           gsize              **offsets,
+                                           gsize               *n_offsets,
+                                           GError             **error)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+  g_return_val_if_fail (values != NULL || n_values == 0, NULL);
+  g_return_val_if_fail (offsets != NULL, NULL);
+  g_return_val_if_fail (n_offsets != NULL, NULL);
 
-  return icu_formatted_number_new (g_steal_pointer (&uresult));
+  return format_packed (self, values, TRUE, n_values, offsets, n_offsets, error);
 }
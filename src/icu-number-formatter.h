@@ -10,9 +10,12 @@
 #  error "Only <icu-gobject.h> can be included directly"
 #endif
 
-#include <glib-object.h>
+#include <gio/gio.h>
 #include "icu-version.h"
+#include "icu-error.h"
 #include "icu-formatted-number.h"
+#include "icu-number-specialization.h"
+#include "icu-number-symbols.h"
 
 G_BEGIN_DECLS
 
@@ -28,11 +31,33 @@ IcuNumberFormatter *icu_number_formatter_new (const gchar  *skeleton,
                                               const gchar  *locale,
                                               GError      **error);
 
+ICU_AVAILABLE_IN_ALL
+IcuNumberFormatter *icu_number_formatter_get_shared (const gchar  *skeleton,
+                                                     const gchar  *locale,
+                                                     GError      **error);
+
+ICU_AVAILABLE_IN_ALL
+IcuNumberFormatter *icu_number_formatter_new_specialized (const IcuNumberSpecialization *specialization);
+
+ICU_AVAILABLE_IN_ALL
+void     icu_number_formatter_prewarm        (const gchar * const  *skeletons,
+                                              const gchar * const  *locales,
+                                              GCancellable         *cancellable,
+                                              GAsyncReadyCallback   callback,
+                                              gpointer              user_data);
+ICU_AVAILABLE_IN_ALL
+gboolean icu_number_formatter_prewarm_finish (GAsyncResult         *result,
+                                              GError              **error);
+
 ICU_AVAILABLE_IN_ALL
 IcuNumberFormatter *icu_number_formatter_ref   (IcuNumberFormatter *self);
 ICU_AVAILABLE_IN_ALL
 void                icu_number_formatter_unref (IcuNumberFormatter *self);
 
+ICU_AVAILABLE_IN_ALL
+IcuNumberSymbols *icu_number_formatter_get_symbols (IcuNumberFormatter  *self,
+                                                    GError             **error);
+
 ICU_AVAILABLE_IN_ALL
 IcuFormattedNumber *icu_number_formatter_format_int     (IcuNumberFormatter  *self,
                                                          gint64               value,
@@ -45,6 +70,138 @@ ICU_AVAILABLE_IN_ALL
 IcuFormattedNumber *icu_number_formatter_format_decimal (IcuNumberFormatter  *self,
                                                          const gchar         *value,
                                                          GError             **error);
+ICU_AVAILABLE_IN_ALL
+IcuFormattedNumber *icu_number_formatter_format_decimal_len (IcuNumberFormatter  *self,
+                                                             const gchar         *value,
+                                                             gssize               length,
+                                                             GError             **error);
+ICU_AVAILABLE_IN_ALL
+IcuFormattedNumber *icu_number_formatter_format_fixed   (IcuNumberFormatter  *self,
+                                                         gint64               mantissa,
+                                                         gint32               scale,
+                                                         GError             **error);
+ICU_AVAILABLE_IN_ALL
+IcuFormattedNumber *icu_number_formatter_format_int128  (IcuNumberFormatter  *self,
+                                                         gint64               hi,
+                                                         guint64              lo,
+                                                         GError             **error);
+
+ICU_AVAILABLE_IN_ALL
+gboolean icu_number_formatter_format_decimal_batch (IcuNumberFormatter  *self,
+                                                    const gchar         *buffer,
+                                                    const gsize         *spans,
+                                                    gsize                n_values,
+                                                    GString             *arena,
+                                                    gsize               *out_offsets,
+                                                    IcuStatus           *statuses,
+                                                    GError             **error);
+
+ICU_AVAILABLE_IN_ALL
+gboolean icu_number_formatter_format_fixed_batch  (IcuNumberFormatter  *self,
+                                                   const gint64        *mantissas,
+                                                   gint32               scale,
+                                                   gsize                n_values,
+                                                   GString             *arena,
+                                                   gsize               *out_offsets,
+                                                   IcuStatus           *statuses,
+                                                   GError             **error);
+ICU_AVAILABLE_IN_ALL
+gboolean icu_number_formatter_format_int128_batch (IcuNumberFormatter  *self,
+                                                   const gint64        *his,
+                                                   const guint64       *los,
+                                                   gsize                n_values,
+                                                   GString             *arena,
+                                                   gsize               *out_offsets,
+                                                   IcuStatus           *statuses,
+                                                   GError             **error);
+
+ICU_AVAILABLE_IN_ALL
+GStrv icu_number_formatter_format_int_strv    (IcuNumberFormatter  *self,
+                                               const gint64        *values,
+                                               gsize                n_values,
+                                               GError             **error);
+ICU_AVAILABLE_IN_ALL
+GStrv icu_number_formatter_format_double_strv (IcuNumberFormatter  *self,
+                                               const gdouble       *values,
+                                               gsize                n_values,
+                                               GError             **error);
+
+ICU_AVAILABLE_IN_ALL
+GBytes *icu_number_formatter_format_int_packed    (IcuNumberFormatter  *self,
+                                                   const gint64        *values,
+                                                   gsize                n_values,
+                                                   gsize              **offsets,
+                                                   gsize               *n_offsets,
+                                                   GError             **error);
+ICU_AVAILABLE_IN_ALL
+GBytes *icu_number_formatter_format_double_packed (IcuNumberFormatter  *self,
+                                                   const gdouble       *values,
+                                                   gsize                n_values,
+                                                   gsize              **offsets,
+                                                   gsize               *n_offsets,
+                                                   GError             **error);
+
+ICU_AVAILABLE_IN_ALL
+gboolean icu_number_formatter_append_int    (IcuNumberFormatter  *self,
+                                             gint64               value,
+                                             GString             *out,
+                                             GArray              *fields,
+                                             GError             **error);
+ICU_AVAILABLE_IN_ALL
+gboolean icu_number_formatter_append_double (IcuNumberFormatter  *self,
+                                             gdouble              value,
+                                             GString             *out,
+                                             GArray              *fields,
+                                             GError             **error);
+
+ICU_AVAILABLE_IN_ALL
+void  icu_number_formatter_set_memo_capacity (IcuNumberFormatter *self,
+                                              guint               capacity);
+ICU_AVAILABLE_IN_ALL
+guint icu_number_formatter_get_memo_capacity (IcuNumberFormatter *self);
+ICU_AVAILABLE_IN_ALL
+void  icu_number_formatter_get_memo_stats    (IcuNumberFormatter *self,
+                                              guint64            *hits,
+                                              guint64            *misses);
+
+ICU_AVAILABLE_IN_ALL
+gboolean     icu_number_formatter_precompute_int_range (IcuNumberFormatter  *self,
+                                                        gint64               min,
+                                                        gint64               max,
+                                                        GError             **error);
+ICU_AVAILABLE_IN_ALL
+const gchar *icu_number_formatter_lookup_int           (IcuNumberFormatter  *self,
+                                                        gint64               value,
+                                                        gsize               *length);
+ICU_AVAILABLE_IN_ALL
+gsize        icu_number_formatter_get_precomputed_size (IcuNumberFormatter  *self);
+
+ICU_AVAILABLE_IN_ALL
+gboolean icu_number_formatter_save_cache (IcuNumberFormatter  *self,
+                                          const gchar         *filename,
+                                          GError             **error);
+ICU_AVAILABLE_IN_ALL
+gboolean icu_number_formatter_load_cache (IcuNumberFormatter  *self,
+                                          const gchar         *filename,
+                                          GError             **error);
+
+ICU_AVAILABLE_IN_ALL
+IcuStatus icu_number_formatter_try_format_int         (IcuNumberFormatter  *self,
+                                                       gint64               value,
+                                                       IcuFormattedNumber **result);
+ICU_AVAILABLE_IN_ALL
+IcuStatus icu_number_formatter_try_format_double      (IcuNumberFormatter  *self,
+                                                       gdouble              value,
+                                                       IcuFormattedNumber **result);
+ICU_AVAILABLE_IN_ALL
+IcuStatus icu_number_formatter_try_format_decimal     (IcuNumberFormatter  *self,
+                                                       const gchar         *value,
+                                                       IcuFormattedNumber **result);
+ICU_AVAILABLE_IN_ALL
+IcuStatus icu_number_formatter_try_format_decimal_len (IcuNumberFormatter  *self,
+                                                       const gchar         *value,
+                                                       gssize               length,
+                                                       IcuFormattedNumber **result);
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC (IcuNumberFormatter, icu_number_formatter_unref)
 
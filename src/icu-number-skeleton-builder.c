@@ -0,0 +1,499 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "icu-number-skeleton-builder.h"
+
+#include "icu-number-skeleton.h"
+
+// ICU does not accept more digits than this in precision settings.
+#define MAX_DIGITS 999
+
+/**
+ * IcuNumberSkeletonBuilder:
+ *
+ * Builds number skeletons out of typed settings.
+ *
+ * The skeletons are always written in the canonical form returned
+ * by [func@number_skeleton_canonicalize], whatever the order the
+ * settings were set in, so equivalent configurations produce the
+ * same skeleton and the same [method@NumberSkeletonBuilder.get_hash].
+ *
+ * Setting something twice replaces the previous value, and the
+ * currency, measure unit, percent and permille settings replace
+ * each other, as do the precision ones.
+ */
+
+struct _IcuNumberSkeletonBuilder
+{
+  guint ref_count;
+
+  // The tokens of each setting, or NULL when unset.
+  const gchar *notation;
+  gchar *unit;
+  gchar *precision;
+  const gchar *rounding_mode;
+  const gchar *grouping;
+  const gchar *unit_width;
+  const gchar *sign_display;
+};
+
+static const gchar * const notation_tokens[] = {
+  [ICU_NOTATION_SIMPLE]        = "notation-simple",
+  [ICU_NOTATION_SCIENTIFIC]    = "scientific",
+  [ICU_NOTATION_ENGINEERING]   = "engineering",
+  [ICU_NOTATION_COMPACT_SHORT] = "compact-short",
+  [ICU_NOTATION_COMPACT_LONG]  = "compact-long",
+};
+
+static const gchar * const rounding_mode_tokens[] = {
+  [ICU_ROUNDING_MODE_CEILING]      = "rounding-mode-ceiling",
+  [ICU_ROUNDING_MODE_FLOOR]        = "rounding-mode-floor",
+  [ICU_ROUNDING_MODE_DOWN]         = "rounding-mode-down",
+  [ICU_ROUNDING_MODE_UP]           = "rounding-mode-up",
+  [ICU_ROUNDING_MODE_HALF_EVEN]    = "rounding-mode-half-even",
+  [ICU_ROUNDING_MODE_HALF_DOWN]    = "rounding-mode-half-down",
+  [ICU_ROUNDING_MODE_HALF_UP]      = "rounding-mode-half-up",
+  [ICU_ROUNDING_MODE_UNNECESSARY]  = "rounding-mode-unnecessary",
+  [ICU_ROUNDING_MODE_HALF_ODD]     = "rounding-mode-half-odd",
+  [ICU_ROUNDING_MODE_HALF_CEILING] = "rounding-mode-half-ceiling",
+  [ICU_ROUNDING_MODE_HALF_FLOOR]   = "rounding-mode-half-floor",
+};
+
+static const gchar * const grouping_tokens[] = {
+  [ICU_GROUPING_OFF]        = "group-off",
+  [ICU_GROUPING_MIN2]       = "group-min2",
+  [ICU_GROUPING_AUTO]       = "group-auto",
+  [ICU_GROUPING_ON_ALIGNED] = "group-on-aligned",
+  [ICU_GROUPING_THOUSANDS]  = "group-thousands",
+};
+
+static const gchar * const sign_display_tokens[] = {
+  [ICU_SIGN_DISPLAY_AUTO]                   = "sign-auto",
+  [ICU_SIGN_DISPLAY_ALWAYS]                 = "sign-always",
+  [ICU_SIGN_DISPLAY_NEVER]                  = "sign-never",
+  [ICU_SIGN_DISPLAY_ACCOUNTING]             = "sign-accounting",
+  [ICU_SIGN_DISPLAY_ACCOUNTING_ALWAYS]      = "sign-accounting-always",
+  [ICU_SIGN_DISPLAY_EXCEPT_ZERO]            = "sign-except-zero",
+  [ICU_SIGN_DISPLAY_ACCOUNTING_EXCEPT_ZERO] = "sign-accounting-except-zero",
+  [ICU_SIGN_DISPLAY_NEGATIVE]               = "sign-negative",
+  [ICU_SIGN_DISPLAY_ACCOUNTING_NEGATIVE]    = "sign-accounting-negative",
+};
+
+static const gchar * const unit_width_tokens[] = {
+  [ICU_UNIT_WIDTH_NARROW]    = "unit-width-narrow",
+  [ICU_UNIT_WIDTH_SHORT]     = "unit-width-short",
+  [ICU_UNIT_WIDTH_FULL_NAME] = "unit-width-full-name",
+  [ICU_UNIT_WIDTH_ISO_CODE]  = "unit-width-iso-code",
+  [ICU_UNIT_WIDTH_FORMAL]    = "unit-width-formal",
+  [ICU_UNIT_WIDTH_VARIANT]   = "unit-width-variant",
+  [ICU_UNIT_WIDTH_HIDDEN]    = "unit-width-hidden",
+};
+
+G_DEFINE_BOXED_TYPE (IcuNumberSkeletonBuilder, icu_number_skeleton_builder,
+                     icu_number_skeleton_builder_ref, icu_number_skeleton_builder_unref)
+
+static void
+icu_number_skeleton_builder_free (IcuNumberSkeletonBuilder *self)
+{
+  g_assert_nonnull (self);
+  g_assert_cmpuint (self->ref_count, ==, 0);
+
+  g_clear_pointer (&self->unit, g_free);
+  g_clear_pointer (&self->precision, g_free);
+
+  g_slice_free (IcuNumberSkeletonBuilder, self);
+}
+
+static void
+append_digits (GString *out,
+               gchar    required,
+               gint     min_digits,
+               gint     max_digits)
+{
+  gint i = 0;
+
+  for (i = 0; i < min_digits; i++)
+    g_string_append_c (out, required);
+
+  if (max_digits < 0)
+    {
+      g_string_append_c (out, '*');
+      return;
+    }
+
+  for (i = min_digits; i < max_digits; i++)
+    g_string_append_c (out, '#');
+}
+
+// Writes the settings in the order icu_number_skeleton_canonicalize()
+// sorts them in.
+static gchar *
+to_skeleton (IcuNumberSkeletonBuilder *self)
+{
+  const gchar *tokens[] = {
+    self->notation,
+    self->unit,
+    self->precision,
+    self->rounding_mode,
+    self->grouping,
+    self->unit_width,
+    self->sign_display,
+  };
+  GString *skeleton = NULL;
+  gsize i = 0;
+
+  skeleton = g_string_new (NULL);
+
+  for (i = 0; i < G_N_ELEMENTS (tokens); i++)
+    {
+      if (tokens[i] == NULL)
+        continue;
+
+      if (skeleton->len > 0)
+        g_string_append_c (skeleton, ' ');
+
+      g_string_append (skeleton, tokens[i]);
+    }
+
+  return g_string_free (skeleton, FALSE);
+}
+
+/**
+ * icu_number_skeleton_builder_new:
+ *
+ * Creates a new [class@NumberSkeletonBuilder] with no settings, which
+ * builds the empty skeleton.
+ *
+ * Returns: (transfer full): A newly created
+ *   [class@NumberSkeletonBuilder].
+ */
+IcuNumberSkeletonBuilder *
+icu_number_skeleton_builder_new (void)
+{
+  IcuNumberSkeletonBuilder *self = NULL;
+
+  self = g_slice_new0 (IcuNumberSkeletonBuilder);
+  self->ref_count = 1;
+
+  return self;
+}
+
+/**
+ * icu_number_skeleton_builder_ref:
+ * @self: A [class@NumberSkeletonBuilder].
+ *
+ * Increases the reference count of `self` by one.
+ *
+ * Returns: (transfer full): The passed in
+ *   [class@NumberSkeletonBuilder].
+ */
+IcuNumberSkeletonBuilder *
+icu_number_skeleton_builder_ref (IcuNumberSkeletonBuilder *self)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+
+  g_atomic_int_inc (&self->ref_count);
+
+  return self;
+}
+
+/**
+ * icu_number_skeleton_builder_unref:
+ * @self: A [class@NumberSkeletonBuilder].
+ *
+ * Decreases the reference count of `self` by one.
+ *
+ * If the resulting reference count is zero, frees the memory of
+ * `self`.
+ */
+void
+icu_number_skeleton_builder_unref (IcuNumberSkeletonBuilder *self)
+{
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (self->ref_count >= 1);
+
+  if (g_atomic_int_dec_and_test (&self->ref_count))
+    icu_number_skeleton_builder_free (self);
+}
+
+/**
+ * icu_number_skeleton_builder_set_notation:
+ * @self: A [class@NumberSkeletonBuilder].
+ * @notation: The notation to format numbers in.
+ *
+ * Sets the notation numbers are formatted in.
+ */
+void
+icu_number_skeleton_builder_set_notation (IcuNumberSkeletonBuilder *self,
+                                          IcuNotation               notation)
+{
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (notation < G_N_ELEMENTS (notation_tokens));
+
+  self->notation = notation_tokens[notation];
+}
+
+/**
+ * icu_number_skeleton_builder_set_currency:
+ * @self: A [class@NumberSkeletonBuilder].
+ * @iso_code: The ISO 4217 code of the currency, e.g. `"EUR"`.
+ *
+ * Makes numbers be formatted as amounts of a currency.
+ */
+void
+icu_number_skeleton_builder_set_currency (IcuNumberSkeletonBuilder *self,
+                                          const gchar              *iso_code)
+{
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (iso_code != NULL);
+
+  g_free (self->unit);
+  self->unit = g_strconcat ("currency/", iso_code, NULL);
+}
+
+/**
+ * icu_number_skeleton_builder_set_measure_unit:
+ * @self: A [class@NumberSkeletonBuilder].
+ * @unit: The type and subtype of the unit, e.g. `"length-meter"`.
+ *
+ * Makes numbers be formatted as measures of a unit.
+ */
+void
+icu_number_skeleton_builder_set_measure_unit (IcuNumberSkeletonBuilder *self,
+                                              const gchar              *unit)
+{
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (unit != NULL);
+
+  g_free (self->unit);
+  self->unit = g_strconcat ("measure-unit/", unit, NULL);
+}
+
+/**
+ * icu_number_skeleton_builder_set_percent:
+ * @self: A [class@NumberSkeletonBuilder].
+ *
+ * Makes numbers be formatted as percentages, without scaling them.
+ */
+void
+icu_number_skeleton_builder_set_percent (IcuNumberSkeletonBuilder *self)
+{
+  g_return_if_fail (self != NULL);
+
+  g_free (self->unit);
+  self->unit = g_strdup ("percent");
+}
+
+/**
+ * icu_number_skeleton_builder_set_permille:
+ * @self: A [class@NumberSkeletonBuilder].
+ *
+ * Makes numbers be formatted as permilles, without scaling them.
+ */
+void
+icu_number_skeleton_builder_set_permille (IcuNumberSkeletonBuilder *self)
+{
+  g_return_if_fail (self != NULL);
+
+  g_free (self->unit);
+  self->unit = g_strdup ("permille");
+}
+
+/**
+ * icu_number_skeleton_builder_set_precision_integer:
+ * @self: A [class@NumberSkeletonBuilder].
+ *
+ * Makes numbers be rounded to integers.
+ */
+void
+icu_number_skeleton_builder_set_precision_integer (IcuNumberSkeletonBuilder *self)
+{
+  g_return_if_fail (self != NULL);
+
+  g_free (self->precision);
+  self->precision = g_strdup ("precision-integer");
+}
+
+/**
+ * icu_number_skeleton_builder_set_precision_fraction:
+ * @self: A [class@NumberSkeletonBuilder].
+ * @min_digits: The minimum number of fraction digits.
+ * @max_digits: The maximum number of fraction digits, or -1 for no
+ *   maximum.
+ *
+ * Makes numbers be rounded to a number of fraction digits.
+ */
+void
+icu_number_skeleton_builder_set_precision_fraction (IcuNumberSkeletonBuilder *self,
+                                                    gint                      min_digits,
+                                                    gint                      max_digits)
+{
+  GString *precision = NULL;
+
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (min_digits >= 0 && min_digits <= MAX_DIGITS);
+  g_return_if_fail (max_digits < 0 || (max_digits >= min_digits && max_digits <= MAX_DIGITS));
+
+  if (max_digits == 0)
+    {
+      icu_number_skeleton_builder_set_precision_integer (self);
+      return;
+    }
+
+  precision = g_string_new (".");
+  append_digits (precision, '0', min_digits, max_digits);
+
+  g_free (self->precision);
+  self->precision = g_string_free (precision, FALSE);
+}
+
+/**
+ * icu_number_skeleton_builder_set_precision_significant:
+ * @self: A [class@NumberSkeletonBuilder].
+ * @min_digits: The minimum number of significant digits.
+ * @max_digits: The maximum number of significant digits, or -1 for
+ *   no maximum.
+ *
+ * Makes numbers be rounded to a number of significant digits.
+ */
+void
+icu_number_skeleton_builder_set_precision_significant (IcuNumberSkeletonBuilder *self,
+                                                       gint                      min_digits,
+                                                       gint                      max_digits)
+{
+  GString *precision = NULL;
+
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (min_digits >= 1 && min_digits <= MAX_DIGITS);
+  g_return_if_fail (max_digits < 0 || (max_digits >= min_digits && max_digits <= MAX_DIGITS));
+
+  precision = g_string_new (NULL);
+  append_digits (precision, '@', min_digits, max_digits);
+
+  g_free (self->precision);
+  self->precision = g_string_free (precision, FALSE);
+}
+
+/**
+ * icu_number_skeleton_builder_set_rounding_mode:
+ * @self: A [class@NumberSkeletonBuilder].
+ * @rounding_mode: The rounding mode to use.
+ *
+ * Sets how numbers are rounded to the precision.
+ */
+void
+icu_number_skeleton_builder_set_rounding_mode (IcuNumberSkeletonBuilder *self,
+                                               IcuRoundingMode           rounding_mode)
+{
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (rounding_mode < G_N_ELEMENTS (rounding_mode_tokens));
+
+  self->rounding_mode = rounding_mode_tokens[rounding_mode];
+}
+
+/**
+ * icu_number_skeleton_builder_set_grouping:
+ * @self: A [class@NumberSkeletonBuilder].
+ * @grouping: The grouping strategy to use.
+ *
+ * Sets when digits are grouped, e.g. into thousands.
+ */
+void
+icu_number_skeleton_builder_set_grouping (IcuNumberSkeletonBuilder *self,
+                                          IcuGrouping               grouping)
+{
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (grouping < G_N_ELEMENTS (grouping_tokens));
+
+  self->grouping = grouping_tokens[grouping];
+}
+
+/**
+ * icu_number_skeleton_builder_set_sign_display:
+ * @self: A [class@NumberSkeletonBuilder].
+ * @sign_display: When to display the sign.
+ *
+ * Sets when the sign of numbers is displayed.
+ */
+void
+icu_number_skeleton_builder_set_sign_display (IcuNumberSkeletonBuilder *self,
+                                              IcuSignDisplay            sign_display)
+{
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (sign_display < G_N_ELEMENTS (sign_display_tokens));
+
+  self->sign_display = sign_display_tokens[sign_display];
+}
+
+/**
+ * icu_number_skeleton_builder_set_unit_width:
+ * @self: A [class@NumberSkeletonBuilder].
+ * @unit_width: The width of currencies and units.
+ *
+ * Sets how currencies and units are displayed.
+ */
+void
+icu_number_skeleton_builder_set_unit_width (IcuNumberSkeletonBuilder *self,
+                                            IcuUnitWidth              unit_width)
+{
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (unit_width < G_N_ELEMENTS (unit_width_tokens));
+
+  self->unit_width = unit_width_tokens[unit_width];
+}
+
+/**
+ * icu_number_skeleton_builder_build:
+ * @self: A [class@NumberSkeletonBuilder].
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Builds the canonical skeleton for the current settings, and checks
+ * it with [func@number_skeleton_validate], which catches things like
+ * unknown currencies or units.
+ *
+ * Returns: (transfer full): The canonical skeleton, or `NULL` if
+ *   `error` is set.
+ */
+gchar *
+icu_number_skeleton_builder_build (IcuNumberSkeletonBuilder  *self,
+                                   GError                   **error)
+{
+  g_autofree gchar *skeleton = NULL;
+
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+
+  skeleton = to_skeleton (self);
+
+  if (!icu_number_skeleton_validate (skeleton, error))
+    return NULL;
+
+  return g_steal_pointer (&skeleton);
+}
+
+/**
+ * icu_number_skeleton_builder_get_hash:
+ * @self: A [class@NumberSkeletonBuilder].
+ *
+ * Gets the stable hash of the skeleton for the current settings, as
+ * computed by [func@number_skeleton_hash], without validating it.
+ *
+ * Returns: The hash of the skeleton.
+ */
+guint64
+icu_number_skeleton_builder_get_hash (IcuNumberSkeletonBuilder *self)
+{
+  g_autofree gchar *skeleton = NULL;
+
+  g_return_val_if_fail (self != NULL, 0);
+  g_return_val_if_fail (self->ref_count >= 1, 0);
+
+  skeleton = to_skeleton (self);
+
+  return icu_number_skeleton_hash (skeleton);
+}
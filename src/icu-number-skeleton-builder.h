@@ -0,0 +1,129 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#pragma once
+
+#if !defined(_ICU_GOBJECT_INSIDE) && !defined(ICU_GOBJECT_COMPILATION)
+#  error "Only <icu-gobject.h> can be included directly"
+#endif
+
+#include <glib-object.h>
+#include "icu-version.h"
+
+G_BEGIN_DECLS
+
+typedef enum {
+  ICU_NOTATION_SIMPLE,
+  ICU_NOTATION_SCIENTIFIC,
+  ICU_NOTATION_ENGINEERING,
+  ICU_NOTATION_COMPACT_SHORT,
+  ICU_NOTATION_COMPACT_LONG,
+} IcuNotation;
+
+typedef enum {
+  ICU_ROUNDING_MODE_CEILING,
+  ICU_ROUNDING_MODE_FLOOR,
+  ICU_ROUNDING_MODE_DOWN,
+  ICU_ROUNDING_MODE_UP,
+  ICU_ROUNDING_MODE_HALF_EVEN,
+  ICU_ROUNDING_MODE_HALF_DOWN,
+  ICU_ROUNDING_MODE_HALF_UP,
+  ICU_ROUNDING_MODE_UNNECESSARY,
+  ICU_ROUNDING_MODE_HALF_ODD,
+  ICU_ROUNDING_MODE_HALF_CEILING,
+  ICU_ROUNDING_MODE_HALF_FLOOR,
+} IcuRoundingMode;
+
+typedef enum {
+  ICU_GROUPING_OFF,
+  ICU_GROUPING_MIN2,
+  ICU_GROUPING_AUTO,
+  ICU_GROUPING_ON_ALIGNED,
+  ICU_GROUPING_THOUSANDS,
+} IcuGrouping;
+
+typedef enum {
+  ICU_SIGN_DISPLAY_AUTO,
+  ICU_SIGN_DISPLAY_ALWAYS,
+  ICU_SIGN_DISPLAY_NEVER,
+  ICU_SIGN_DISPLAY_ACCOUNTING,
+  ICU_SIGN_DISPLAY_ACCOUNTING_ALWAYS,
+  ICU_SIGN_DISPLAY_EXCEPT_ZERO,
+  ICU_SIGN_DISPLAY_ACCOUNTING_EXCEPT_ZERO,
+  ICU_SIGN_DISPLAY_NEGATIVE,
+  ICU_SIGN_DISPLAY_ACCOUNTING_NEGATIVE,
+} IcuSignDisplay;
+
+typedef enum {
+  ICU_UNIT_WIDTH_NARROW,
+  ICU_UNIT_WIDTH_SHORT,
+  ICU_UNIT_WIDTH_FULL_NAME,
+  ICU_UNIT_WIDTH_ISO_CODE,
+  ICU_UNIT_WIDTH_FORMAL,
+  ICU_UNIT_WIDTH_VARIANT,
+  ICU_UNIT_WIDTH_HIDDEN,
+} IcuUnitWidth;
+
+#define ICU_TYPE_NUMBER_SKELETON_BUILDER (icu_number_skeleton_builder_get_type())
+
+typedef struct _IcuNumberSkeletonBuilder IcuNumberSkeletonBuilder;
+
+ICU_AVAILABLE_IN_ALL
+GType icu_number_skeleton_builder_get_type (void);
+
+ICU_AVAILABLE_IN_ALL
+IcuNumberSkeletonBuilder *icu_number_skeleton_builder_new (void);
+
+ICU_AVAILABLE_IN_ALL
+IcuNumberSkeletonBuilder *icu_number_skeleton_builder_ref   (IcuNumberSkeletonBuilder *self);
+ICU_AVAILABLE_IN_ALL
+void                      icu_number_skeleton_builder_unref (IcuNumberSkeletonBuilder *self);
+
+ICU_AVAILABLE_IN_ALL
+void icu_number_skeleton_builder_set_notation              (IcuNumberSkeletonBuilder *self,
+                                                            IcuNotation               notation);
+ICU_AVAILABLE_IN_ALL
+void icu_number_skeleton_builder_set_currency              (IcuNumberSkeletonBuilder *self,
+                                                            const gchar              *iso_code);
+ICU_AVAILABLE_IN_ALL
+void icu_number_skeleton_builder_set_measure_unit          (IcuNumberSkeletonBuilder *self,
+                                                            const gchar              *unit);
+ICU_AVAILABLE_IN_ALL
+void icu_number_skeleton_builder_set_percent               (IcuNumberSkeletonBuilder *self);
+ICU_AVAILABLE_IN_ALL
+void icu_number_skeleton_builder_set_permille              (IcuNumberSkeletonBuilder *self);
+ICU_AVAILABLE_IN_ALL
+void icu_number_skeleton_builder_set_precision_integer     (IcuNumberSkeletonBuilder *self);
+ICU_AVAILABLE_IN_ALL
+void icu_number_skeleton_builder_set_precision_fraction    (IcuNumberSkeletonBuilder *self,
+                                                            gint                      min_digits,
+                                                            gint                      max_digits);
+ICU_AVAILABLE_IN_ALL
+void icu_number_skeleton_builder_set_precision_significant (IcuNumberSkeletonBuilder *self,
+                                                            gint                      min_digits,
+                                                            gint                      max_digits);
+ICU_AVAILABLE_IN_ALL
+void icu_number_skeleton_builder_set_rounding_mode         (IcuNumberSkeletonBuilder *self,
+                                                            IcuRoundingMode           rounding_mode);
+ICU_AVAILABLE_IN_ALL
+void icu_number_skeleton_builder_set_grouping              (IcuNumberSkeletonBuilder *self,
+                                                            IcuGrouping               grouping);
+ICU_AVAILABLE_IN_ALL
+void icu_number_skeleton_builder_set_sign_display          (IcuNumberSkeletonBuilder *self,
+                                                            IcuSignDisplay            sign_display);
+ICU_AVAILABLE_IN_ALL
+void icu_number_skeleton_builder_set_unit_width            (IcuNumberSkeletonBuilder *self,
+                                                            IcuUnitWidth              unit_width);
+
+ICU_AVAILABLE_IN_ALL
+gchar   *icu_number_skeleton_builder_build    (IcuNumberSkeletonBuilder  *self,
+                                               GError                   **error);
+ICU_AVAILABLE_IN_ALL
+guint64  icu_number_skeleton_builder_get_hash (IcuNumberSkeletonBuilder  *self);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (IcuNumberSkeletonBuilder, icu_number_skeleton_builder_unref)
+
+G_END_DECLS
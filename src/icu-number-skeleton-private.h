@@ -0,0 +1,24 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+G_GNUC_INTERNAL
+gchar *icu_number_skeleton_replace_setting (const gchar *skeleton,
+                                            const gchar *token);
+
+G_GNUC_INTERNAL
+gboolean icu_number_has_huge_exponent (const gchar *value,
+                                       gsize        length);
+
+G_GNUC_INTERNAL
+gboolean icu_number_skeleton_has_huge_scale (const gchar *skeleton);
+
+G_END_DECLS
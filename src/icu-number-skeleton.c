@@ -0,0 +1,387 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "icu-number-skeleton.h"
+#include "icu-number-skeleton-private.h"
+
+#include <string.h>
+#include <unicode/unumberformatter.h>
+#include "icu-error-private.h"
+
+// Far beyond any real quantity, while keeping the output of decimal
+// numbers within some kilobytes.
+#define MAX_DECIMAL_EXPONENT 10000
+
+// The settings a skeleton token can configure, in the order ICU
+// itself writes them out when generating skeletons.
+typedef enum {
+  SETTING_NOTATION,
+  SETTING_UNIT,
+  SETTING_PER_UNIT,
+  SETTING_USAGE,
+  SETTING_PRECISION,
+  SETTING_ROUNDING_MODE,
+  SETTING_GROUPING,
+  SETTING_INTEGER_WIDTH,
+  SETTING_SYMBOLS,
+  SETTING_UNIT_WIDTH,
+  SETTING_SIGN,
+  SETTING_DECIMAL,
+  SETTING_SCALE,
+  SETTING_UNKNOWN,
+} Setting;
+
+static const struct
+{
+  const gchar *prefix;
+  Setting      setting;
+} setting_prefixes[] = {
+  { "notation-simple",   SETTING_NOTATION },
+  { "scientific",        SETTING_NOTATION },
+  { "engineering",       SETTING_NOTATION },
+  { "compact-",          SETTING_NOTATION },
+  { "E",                 SETTING_NOTATION },
+  { "percent",           SETTING_UNIT },
+  { "permille",          SETTING_UNIT },
+  { "base-unit",         SETTING_UNIT },
+  { "currency/",         SETTING_UNIT },
+  { "measure-unit/",     SETTING_UNIT },
+  { "unit/",             SETTING_UNIT },
+  { "per-measure-unit/", SETTING_PER_UNIT },
+  { "usage/",            SETTING_USAGE },
+  { "precision-",        SETTING_PRECISION },
+  { ".",                 SETTING_PRECISION },
+  { "@",                 SETTING_PRECISION },
+  { "rounding-mode-",    SETTING_ROUNDING_MODE },
+  { "group-",            SETTING_GROUPING },
+  { "integer-width",     SETTING_INTEGER_WIDTH },
+  { "latin",             SETTING_SYMBOLS },
+  { "numbering-system/", SETTING_SYMBOLS },
+  { "unit-width-",       SETTING_UNIT_WIDTH },
+  { "sign-",             SETTING_SIGN },
+  { "decimal-",          SETTING_DECIMAL },
+  { "scale/",            SETTING_SCALE },
+};
+
+// Concise tokens and the long ones they stand for.
+static const struct
+{
+  const gchar *concise;
+  const gchar *expanded;
+} concise_tokens[] = {
+  { "%",     "percent" },
+  { "%x100", "percent scale/100" },
+  { "K",     "compact-short" },
+  { "KK",    "compact-long" },
+  { "E0",    "scientific" },
+  { "EE0",   "engineering" },
+  { ".",     "precision-integer" },
+  { ",_",    "group-off" },
+  { ",?",    "group-min2" },
+  { ",!",    "group-on-aligned" },
+  { "+!",    "sign-always" },
+  { "+_",    "sign-never" },
+  { "+?",    "sign-except-zero" },
+  { "+-",    "sign-negative" },
+  { "()",    "sign-accounting" },
+  { "()!",   "sign-accounting-always" },
+  { "()?",   "sign-accounting-except-zero" },
+  { "()-",   "sign-accounting-negative" },
+};
+
+static Setting
+get_setting (const gchar *token)
+{
+  gsize i = 0;
+
+  for (i = 0; i < G_N_ELEMENTS (setting_prefixes); i++)
+    {
+      if (g_str_has_prefix (token, setting_prefixes[i].prefix))
+        return setting_prefixes[i].setting;
+    }
+
+  return SETTING_UNKNOWN;
+}
+
+static gint
+compare_tokens (gconstpointer a,
+                gconstpointer b)
+{
+  const gchar *token_a = *(const gchar **) a;
+  const gchar *token_b = *(const gchar **) b;
+
+  return (gint) get_setting (token_a) - (gint) get_setting (token_b);
+}
+
+static void
+add_token (GPtrArray   *tokens,
+           const gchar *token)
+{
+  g_auto (GStrv) expanded = NULL;
+  gsize i = 0;
+
+  for (i = 0; i < G_N_ELEMENTS (concise_tokens); i++)
+    {
+      if (g_str_equal (token, concise_tokens[i].concise))
+        {
+          expanded = g_strsplit (concise_tokens[i].expanded, " ", -1);
+          break;
+        }
+    }
+
+  if (expanded == NULL)
+    {
+      g_ptr_array_add (tokens, g_strdup (token));
+      return;
+    }
+
+  for (i = 0; expanded[i] != NULL; i++)
+    g_ptr_array_add (tokens, g_steal_pointer (&expanded[i]));
+}
+
+// Splits `skeleton` into its tokens, expanding the concise ones.
+static GPtrArray *
+split_tokens (const gchar *skeleton)
+{
+  g_autoptr (GPtrArray) tokens = NULL;
+  const gchar *token_start = NULL;
+  const gchar *p = NULL;
+
+  tokens = g_ptr_array_new_with_free_func (g_free);
+
+  for (p = skeleton; ; p++)
+    {
+      if (*p != '\0' && !g_ascii_isspace (*p))
+        {
+          if (token_start == NULL)
+            token_start = p;
+
+          continue;
+        }
+
+      if (token_start != NULL)
+        {
+          g_autofree gchar *token = g_strndup (token_start, p - token_start);
+
+          add_token (tokens, token);
+          token_start = NULL;
+        }
+
+      if (*p == '\0')
+        break;
+    }
+
+  return g_steal_pointer (&tokens);
+}
+
+static gchar *
+join_tokens (GPtrArray *tokens)
+{
+  // Sorting is stable, so tokens ICU would reject for configuring the
+  // same setting twice keep their relative order.
+  g_ptr_array_sort (tokens, compare_tokens);
+  g_ptr_array_add (tokens, NULL);
+
+  return g_strjoinv (" ", (gchar **) tokens->pdata);
+}
+
+// Checks whether the exponent of a decimal number is beyond
+// ±MAX_DECIMAL_EXPONENT. Malformed numbers are left for ICU to reject.
+gboolean
+icu_number_has_huge_exponent (const gchar *value,
+                              gsize        length)
+{
+  const gchar *exponent = NULL;
+  const gchar *end = value + length;
+  gint64 magnitude = 0;
+
+  exponent = memchr (value, 'e', length);
+  if (exponent == NULL)
+    exponent = memchr (value, 'E', length);
+
+  if (exponent == NULL)
+    return FALSE;
+
+  exponent++;
+  if (exponent < end && (*exponent == '+' || *exponent == '-'))
+    exponent++;
+
+  for (; exponent < end && g_ascii_isdigit (*exponent); exponent++)
+    {
+      magnitude = magnitude * 10 + (*exponent - '0');
+      if (magnitude > MAX_DECIMAL_EXPONENT)
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
+// Scales with huge exponents make every number as slow to format as
+// huge decimal numbers do.
+gboolean
+icu_number_skeleton_has_huge_scale (const gchar *skeleton)
+{
+  const gchar *scale = skeleton;
+
+  while ((scale = strstr (scale, "scale/")) != NULL)
+    {
+      scale += strlen ("scale/");
+
+      if (icu_number_has_huge_exponent (scale, strcspn (scale, " \t\n\r\f\v")))
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
+/**
+ * icu_number_skeleton_validate:
+ * @skeleton: The number skeleton to validate.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Checks that `skeleton` is a valid number skeleton.
+ *
+ * This only parses the skeleton, without loading the data of any
+ * locale, so it is cheap enough to check configuration files with.
+ * Errors tell where in the skeleton parsing failed.
+ *
+ * Skeletons that [ctor@NumberFormatter.new] refuses are also invalid,
+ * like those scaling numbers by a power of ten beyond ±10000, which
+ * fail with [error@StandardError.NUMBER_ARG_OUTOFBOUNDS_ERROR].
+ *
+ * Returns: `TRUE` if `skeleton` is valid, `FALSE` if `error` is set.
+ */
+gboolean
+icu_number_skeleton_validate (const gchar  *skeleton,
+                              GError      **error)
+{
+  g_autofree UChar *uskeleton = NULL;
+  UNumberFormatter *uformatter = NULL;
+  UParseError parse_error = {0};
+  UErrorCode ec = U_ZERO_ERROR;
+
+  g_return_val_if_fail (skeleton != NULL, FALSE);
+
+  uskeleton = g_utf8_to_utf16 (skeleton, -1, NULL, NULL, error);
+  if (uskeleton == NULL)
+    return FALSE;
+
+  if (icu_number_skeleton_has_huge_scale (skeleton))
+    return !icu_has_failed (U_NUMBER_ARG_OUTOFBOUNDS_ERROR, error);
+
+  // Locale data is only loaded once something gets formatted.
+  uformatter = unumf_openForSkeletonAndLocaleWithError (uskeleton, -1, "", &parse_error, &ec);
+  g_clear_pointer (&uformatter, unumf_close);
+
+  return !icu_has_failed_with_parse_error (ec, &parse_error, error);
+}
+
+/**
+ * icu_number_skeleton_canonicalize:
+ * @skeleton: A number skeleton.
+ *
+ * Rewrites `skeleton` into a canonical form, so that equivalent
+ * skeletons compare equal and can be used as the same cache key.
+ *
+ * Tokens are sorted by the setting they configure, the concise forms
+ * of the common ones are replaced by their long forms, and runs of
+ * whitespace are collapsed. For example, both `"unit-width-narrow
+ * currency/EUR"` and `"currency/EUR  unit-width-narrow"` become
+ * `"currency/EUR unit-width-narrow"`, and `"% ,_"` becomes
+ * `"percent group-off"`.
+ *
+ * The skeleton is not validated, see [func@number_skeleton_validate].
+ *
+ * Returns: (transfer full): The canonical form of `skeleton`.
+ */
+gchar *
+icu_number_skeleton_canonicalize (const gchar *skeleton)
+{
+  g_autoptr (GPtrArray) tokens = NULL;
+
+  g_return_val_if_fail (skeleton != NULL, NULL);
+
+  tokens = split_tokens (skeleton);
+
+  return join_tokens (tokens);
+}
+
+// Replaces the tokens of `skeleton` configuring the same setting as
+// `token` with `token`, returning the canonical form of the result.
+// Units also drop the "per" unit, which only makes sense along the
+// unit it divides, and replacing a percent drops the scale of
+// "percent scale/100", the expansion of "%x100", as it only turns
+// fractions into percentages.
+gchar *
+icu_number_skeleton_replace_setting (const gchar *skeleton,
+                                     const gchar *token)
+{
+  g_autoptr (GPtrArray) tokens = NULL;
+  Setting setting = SETTING_UNKNOWN;
+  gboolean drops_percent = FALSE;
+  guint i = 0;
+
+  setting = get_setting (token);
+  tokens = split_tokens (skeleton);
+
+  for (i = 0; setting == SETTING_UNIT && i < tokens->len; i++)
+    {
+      if (g_str_equal (g_ptr_array_index (tokens, i), "percent"))
+        drops_percent = TRUE;
+    }
+
+  i = 0;
+  while (i < tokens->len)
+    {
+      const gchar *current_token = g_ptr_array_index (tokens, i);
+      Setting current = get_setting (current_token);
+
+      if (current == setting
+          || (setting == SETTING_UNIT && current == SETTING_PER_UNIT)
+          || (drops_percent && g_str_equal (current_token, "scale/100")))
+        g_ptr_array_remove_index (tokens, i);
+      else
+        i++;
+    }
+
+  g_ptr_array_add (tokens, g_strdup (token));
+
+  return join_tokens (tokens);
+}
+
+/**
+ * icu_number_skeleton_hash:
+ * @skeleton: A number skeleton.
+ *
+ * Computes a hash of the canonical form of `skeleton`, as returned
+ * by [func@number_skeleton_canonicalize].
+ *
+ * The hash is the 64-bit FNV-1a hash of the canonical skeleton, so it
+ * is stable across processes, machines and versions of this library,
+ * and can be stored alongside cached data.
+ *
+ * Returns: The hash of `skeleton`.
+ */
+guint64
+icu_number_skeleton_hash (const gchar *skeleton)
+{
+  g_autofree gchar *canonical = NULL;
+  guint64 hash = G_GUINT64_CONSTANT (0xcbf29ce484222325);
+  const guchar *p = NULL;
+
+  g_return_val_if_fail (skeleton != NULL, 0);
+
+  canonical = icu_number_skeleton_canonicalize (skeleton);
+
+  for (p = (const guchar *) canonical; *p != '\0'; p++)
+    {
+      hash ^= *p;
+      hash *= G_GUINT64_CONSTANT (0x100000001b3);
+    }
+
+  return hash;
+}
@@ -0,0 +1,26 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#pragma once
+
+#if !defined(_ICU_GOBJECT_INSIDE) && !defined(ICU_GOBJECT_COMPILATION)
+#  error "Only <icu-gobject.h> can be included directly"
+#endif
+
+#include <glib.h>
+#include "icu-version.h"
+
+G_BEGIN_DECLS
+
+ICU_AVAILABLE_IN_ALL
+gboolean icu_number_skeleton_validate     (const gchar  *skeleton,
+                                           GError      **error);
+ICU_AVAILABLE_IN_ALL
+gchar   *icu_number_skeleton_canonicalize (const gchar  *skeleton);
+ICU_AVAILABLE_IN_ALL
+guint64  icu_number_skeleton_hash         (const gchar  *skeleton);
+
+G_END_DECLS
@@ -0,0 +1,46 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#pragma once
+
+#if !defined(_ICU_GOBJECT_INSIDE) && !defined(ICU_GOBJECT_COMPILATION)
+#  error "Only <icu-gobject.h> can be included directly"
+#endif
+
+#include <glib-object.h>
+#include "icu-version.h"
+
+G_BEGIN_DECLS
+
+/**
+ * ICU_NUMBER_SPECIALIZATION_MAX_FRACTION_DIGITS:
+ *
+ * The most fraction digits an [struct@NumberSpecialization] can show.
+ */
+#define ICU_NUMBER_SPECIALIZATION_MAX_FRACTION_DIGITS 15
+
+typedef struct _IcuNumberSpecialization
+{
+  const gchar *skeleton;
+  const gchar *locale;
+
+  const gchar *digits[10];
+  const gchar *decimal_separator;
+  const gchar *grouping_separator;
+
+  guint8 primary_grouping;
+  guint8 secondary_grouping;
+  guint8 min_grouping_digits;
+  guint8 min_fraction_digits;
+  guint8 max_fraction_digits;
+
+  const gchar *positive_prefix;
+  const gchar *positive_suffix;
+  const gchar *negative_prefix;
+  const gchar *negative_suffix;
+} IcuNumberSpecialization;
+
+G_END_DECLS
@@ -0,0 +1,376 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "icu-number-symbols.h"
+
+#include <unicode/uloc.h>
+#include <unicode/unum.h>
+#include <unicode/unumsys.h>
+#include "icu-error-private.h"
+#include "icu-locale.h"
+#include "icu-shared-cache-private.h"
+#include "icu-utf8-private.h"
+
+// Far more locales than any application formats for.
+#define MAX_CACHED_SYMBOLS 256
+
+#define N_SYMBOLS (ICU_NUMBER_SYMBOL_INTL_CURRENCY + 1)
+
+/**
+ * IcuNumberSymbols:
+ *
+ * A snapshot of the symbols a locale formats numbers with.
+ *
+ * Custom renderers, like those drawing digits out of a glyph atlas or
+ * aligning fixed-width columns, need the separators, signs and digits
+ * of a locale without going through a [class@NumberFormatter] for
+ * every number. Snapshots hold all of them as UTF-8 strings, are
+ * loaded once per locale and never change afterwards, so they can be
+ * read from any thread without calling into ICU.
+ */
+
+struct _IcuNumberSymbols
+{
+  guint ref_count;
+
+  gchar *locale;
+  gchar *numbering_system;
+  guint grouping_size;
+  guint secondary_grouping_size;
+
+  // All strings, nul-terminated one after another, which the
+  // pointers below point into.
+  gchar *strings;
+  const gchar *symbols[N_SYMBOLS];
+  const gchar *digits[10];
+};
+
+static const UNumberFormatSymbol usymbols[] = {
+  [ICU_NUMBER_SYMBOL_DECIMAL_SEPARATOR]           = UNUM_DECIMAL_SEPARATOR_SYMBOL,
+  [ICU_NUMBER_SYMBOL_GROUPING_SEPARATOR]          = UNUM_GROUPING_SEPARATOR_SYMBOL,
+  [ICU_NUMBER_SYMBOL_MONETARY_SEPARATOR]          = UNUM_MONETARY_SEPARATOR_SYMBOL,
+  [ICU_NUMBER_SYMBOL_MONETARY_GROUPING_SEPARATOR] = UNUM_MONETARY_GROUPING_SEPARATOR_SYMBOL,
+  [ICU_NUMBER_SYMBOL_PERCENT]                     = UNUM_PERCENT_SYMBOL,
+  [ICU_NUMBER_SYMBOL_PERMILLE]                    = UNUM_PERMILL_SYMBOL,
+  [ICU_NUMBER_SYMBOL_MINUS_SIGN]                  = UNUM_MINUS_SIGN_SYMBOL,
+  [ICU_NUMBER_SYMBOL_PLUS_SIGN]                   = UNUM_PLUS_SIGN_SYMBOL,
+  [ICU_NUMBER_SYMBOL_EXPONENTIAL]                 = UNUM_EXPONENTIAL_SYMBOL,
+  [ICU_NUMBER_SYMBOL_INFINITY]                    = UNUM_INFINITY_SYMBOL,
+  [ICU_NUMBER_SYMBOL_NAN]                         = UNUM_NAN_SYMBOL,
+  [ICU_NUMBER_SYMBOL_CURRENCY]                    = UNUM_CURRENCY_SYMBOL,
+  [ICU_NUMBER_SYMBOL_INTL_CURRENCY]               = UNUM_INTL_CURRENCY_SYMBOL,
+};
+
+static const UNumberFormatSymbol udigits[] = {
+  UNUM_ZERO_DIGIT_SYMBOL,
+  UNUM_ONE_DIGIT_SYMBOL,
+  UNUM_TWO_DIGIT_SYMBOL,
+  UNUM_THREE_DIGIT_SYMBOL,
+  UNUM_FOUR_DIGIT_SYMBOL,
+  UNUM_FIVE_DIGIT_SYMBOL,
+  UNUM_SIX_DIGIT_SYMBOL,
+  UNUM_SEVEN_DIGIT_SYMBOL,
+  UNUM_EIGHT_DIGIT_SYMBOL,
+  UNUM_NINE_DIGIT_SYMBOL,
+};
+
+// Snapshots of every locale asked for, keyed by canonical language
+// tag.
+static IcuSharedCache cached_symbols = ICU_SHARED_CACHE_INIT (icu_number_symbols_ref, icu_number_symbols_unref,
+                                                             MAX_CACHED_SYMBOLS);
+
+G_DEFINE_BOXED_TYPE (IcuNumberSymbols, icu_number_symbols,
+                     icu_number_symbols_ref, icu_number_symbols_unref)
+
+static void
+icu_number_symbols_free (IcuNumberSymbols *self)
+{
+  g_assert_nonnull (self);
+  g_assert_cmpuint (self->ref_count, ==, 0);
+
+  g_clear_pointer (&self->locale, g_free);
+  g_clear_pointer (&self->numbering_system, g_free);
+  g_clear_pointer (&self->strings, g_free);
+
+  g_slice_free (IcuNumberSymbols, self);
+}
+
+static void
+append_symbol (GString            *strings,
+               const UNumberFormat *uformat,
+               UNumberFormatSymbol  usymbol,
+               gsize               *offset,
+               UErrorCode          *ec)
+{
+  UChar buffer[32] = {0};
+  gint32 length = 0;
+
+  if (U_FAILURE (*ec))
+    return;
+
+  length = unum_getSymbol (uformat, usymbol, buffer, G_N_ELEMENTS (buffer), ec);
+  if (U_FAILURE (*ec))
+    return;
+
+  *offset = strings->len;
+  icu_utf8_append_utf16 (strings, buffer, length, ec);
+  g_string_append_c (strings, '\0');
+}
+
+static IcuNumberSymbols *
+icu_number_symbols_new (const gchar  *tag,
+                        GError      **error)
+{
+  g_autoptr (IcuNumberSymbols) self = NULL;
+  gchar id[ULOC_FULLNAME_CAPACITY] = {0};
+  UNumberFormat *uformat = NULL;
+  UNumberingSystem *unumsys = NULL;
+  GString *strings = NULL;
+  gsize symbol_offsets[N_SYMBOLS] = {0};
+  gsize digit_offsets[G_N_ELEMENTS (udigits)] = {0};
+  gsize i = 0;
+  UErrorCode ec = U_ZERO_ERROR;
+
+  self = g_slice_new0 (IcuNumberSymbols);
+  self->ref_count = 1;
+  self->locale = g_strdup (tag);
+
+  uloc_forLanguageTag (tag, id, sizeof id, NULL, &ec);
+  if (ec == U_STRING_NOT_TERMINATED_WARNING)
+    ec = U_BUFFER_OVERFLOW_ERROR;
+
+  if (icu_has_failed (ec, error))
+    return NULL;
+
+  unumsys = unumsys_open (id, &ec);
+  if (icu_has_failed (ec, error))
+    return NULL;
+
+  self->numbering_system = g_strdup (unumsys_getName (unumsys));
+  g_clear_pointer (&unumsys, unumsys_close);
+
+  uformat = unum_open (UNUM_DECIMAL, NULL, 0, id, NULL, &ec);
+  if (icu_has_failed (ec, error))
+    return NULL;
+
+  self->grouping_size = MAX (unum_getAttribute (uformat, UNUM_GROUPING_SIZE), 0);
+  self->secondary_grouping_size = MAX (unum_getAttribute (uformat, UNUM_SECONDARY_GROUPING_SIZE), 0);
+
+  // Secondary grouping is reported as zero when it matches the
+  // primary one.
+  if (self->secondary_grouping_size == 0)
+    self->secondary_grouping_size = self->grouping_size;
+
+  strings = g_string_new (NULL);
+
+  for (i = 0; i < N_SYMBOLS; i++)
+    append_symbol (strings, uformat, usymbols[i], &symbol_offsets[i], &ec);
+
+  for (i = 0; i < G_N_ELEMENTS (udigits); i++)
+    append_symbol (strings, uformat, udigits[i], &digit_offsets[i], &ec);
+
+  g_clear_pointer (&uformat, unum_close);
+
+  self->strings = g_string_free (strings, FALSE);
+
+  if (icu_has_failed (ec, error))
+    return NULL;
+
+  // Only point into the strings once they stopped growing.
+  for (i = 0; i < N_SYMBOLS; i++)
+    self->symbols[i] = self->strings + symbol_offsets[i];
+
+  for (i = 0; i < G_N_ELEMENTS (udigits); i++)
+    self->digits[i] = self->strings + digit_offsets[i];
+
+  return g_steal_pointer (&self);
+}
+
+static gpointer
+build_cached_symbols (const gchar  *tag,
+                      gpointer      user_data,
+                      GError      **error)
+{
+  return icu_number_symbols_new (tag, error);
+}
+
+/**
+ * icu_number_symbols_get_for_locale:
+ * @locale: (nullable): The locale to get the symbols of, or `NULL` to
+ *   use the default locale.
+ * @error: (out) (optional): The return location for a recoverable
+ *   error.
+ *
+ * Gets the symbols `locale` formats numbers with, loading them on
+ * first use.
+ *
+ * Snapshots are shared by the whole process, and equivalent spellings
+ * of `locale` share the same one, see [func@locale_canonicalize].
+ * The `numbers` and `currency` keywords of `locale`, e.g.
+ * `"ar-EG-u-nu-latn"` or `"de@currency=USD"`, select the digits and
+ * the currency the symbols are for.
+ *
+ * Returns: (transfer full): The [class@NumberSymbols] of `locale`, or
+ *   `NULL` if `error` is set.
+ */
+IcuNumberSymbols *
+icu_number_symbols_get_for_locale (const gchar  *locale,
+                                   GError      **error)
+{
+  g_autofree gchar *tag = NULL;
+
+  tag = icu_locale_canonicalize (locale != NULL ? locale : uloc_getDefault (), error);
+  if (tag == NULL)
+    return NULL;
+
+  return icu_shared_cache_get (&cached_symbols, tag, build_cached_symbols, NULL, error);
+}
+
+/**
+ * icu_number_symbols_ref:
+ * @self: An [class@NumberSymbols].
+ *
+ * Increases the reference count of `self` by one.
+ *
+ * Returns: (transfer full): The passed in [class@NumberSymbols].
+ */
+IcuNumberSymbols *
+icu_number_symbols_ref (IcuNumberSymbols *self)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (self->ref_count >= 1, NULL);
+
+  g_atomic_int_inc (&self->ref_count);
+
+  return self;
+}
+
+/**
+ * icu_number_symbols_unref:
+ * @self: An [class@NumberSymbols].
+ *
+ * Decreases the reference count of `self` by one.
+ *
+ * If the resulting reference count is zero, frees the memory of
+ * `self`.
+ */
+void
+icu_number_symbols_unref (IcuNumberSymbols *self)
+{
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (self->ref_count >= 1);
+
+  if (g_atomic_int_dec_and_test (&self->ref_count))
+    icu_number_symbols_free (self);
+}
+
+/**
+ * icu_number_symbols_get_locale:
+ * @self: An [class@NumberSymbols].
+ *
+ * Gets the canonical language tag of the locale `self` belongs to.
+ *
+ * Returns: The locale of the symbols.
+ */
+const gchar *
+icu_number_symbols_get_locale (IcuNumberSymbols *self)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+
+  return self->locale;
+}
+
+/**
+ * icu_number_symbols_get_numbering_system:
+ * @self: An [class@NumberSymbols].
+ *
+ * Gets the name of the numbering system the digits of `self` belong
+ * to, e.g. `"latn"` or `"arab"`.
+ *
+ * Returns: The numbering system of the symbols.
+ */
+const gchar *
+icu_number_symbols_get_numbering_system (IcuNumberSymbols *self)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+
+  return self->numbering_system;
+}
+
+/**
+ * icu_number_symbols_get:
+ * @self: An [class@NumberSymbols].
+ * @symbol: The symbol to get.
+ *
+ * Gets `symbol`, which may take more than one character, such as the
+ * minus sign of right-to-left locales, which includes a bidi mark.
+ *
+ * Returns: The symbol as a UTF-8 string.
+ */
+const gchar *
+icu_number_symbols_get (IcuNumberSymbols *self,
+                        IcuNumberSymbol   symbol)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (symbol < N_SYMBOLS, NULL);
+
+  return self->symbols[symbol];
+}
+
+/**
+ * icu_number_symbols_get_digit:
+ * @self: An [class@NumberSymbols].
+ * @digit: The digit to get, from 0 to 9.
+ *
+ * Gets the character `digit` is written with.
+ *
+ * Returns: The digit as a UTF-8 string.
+ */
+const gchar *
+icu_number_symbols_get_digit (IcuNumberSymbols *self,
+                              guint             digit)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (digit < G_N_ELEMENTS (self->digits), NULL);
+
+  return self->digits[digit];
+}
+
+/**
+ * icu_number_symbols_get_grouping_size:
+ * @self: An [class@NumberSymbols].
+ *
+ * Gets the number of integer digits between the decimal separator and
+ * the first grouping separator, usually 3.
+ *
+ * Returns: The primary grouping size, or 0 if the locale does not
+ *   group digits.
+ */
+guint
+icu_number_symbols_get_grouping_size (IcuNumberSymbols *self)
+{
+  g_return_val_if_fail (self != NULL, 0);
+
+  return self->grouping_size;
+}
+
+/**
+ * icu_number_symbols_get_secondary_grouping_size:
+ * @self: An [class@NumberSymbols].
+ *
+ * Gets the number of digits between the rest of grouping separators,
+ * which is 2 in locales like `hi-IN` that write `12,34,567`.
+ *
+ * Returns: The secondary grouping size, or 0 if the locale does not
+ *   group digits.
+ */
+guint
+icu_number_symbols_get_secondary_grouping_size (IcuNumberSymbols *self)
+{
+  g_return_val_if_fail (self != NULL, 0);
+
+  return self->secondary_grouping_size;
+}
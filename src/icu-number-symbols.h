@@ -0,0 +1,67 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#pragma once
+
+#if !defined(_ICU_GOBJECT_INSIDE) && !defined(ICU_GOBJECT_COMPILATION)
+#  error "Only <icu-gobject.h> can be included directly"
+#endif
+
+#include <glib-object.h>
+#include "icu-version.h"
+
+G_BEGIN_DECLS
+
+typedef enum {
+  ICU_NUMBER_SYMBOL_DECIMAL_SEPARATOR,
+  ICU_NUMBER_SYMBOL_GROUPING_SEPARATOR,
+  ICU_NUMBER_SYMBOL_MONETARY_SEPARATOR,
+  ICU_NUMBER_SYMBOL_MONETARY_GROUPING_SEPARATOR,
+  ICU_NUMBER_SYMBOL_PERCENT,
+  ICU_NUMBER_SYMBOL_PERMILLE,
+  ICU_NUMBER_SYMBOL_MINUS_SIGN,
+  ICU_NUMBER_SYMBOL_PLUS_SIGN,
+  ICU_NUMBER_SYMBOL_EXPONENTIAL,
+  ICU_NUMBER_SYMBOL_INFINITY,
+  ICU_NUMBER_SYMBOL_NAN,
+  ICU_NUMBER_SYMBOL_CURRENCY,
+  ICU_NUMBER_SYMBOL_INTL_CURRENCY,
+} IcuNumberSymbol;
+
+#define ICU_TYPE_NUMBER_SYMBOLS (icu_number_symbols_get_type())
+
+typedef struct _IcuNumberSymbols IcuNumberSymbols;
+
+ICU_AVAILABLE_IN_ALL
+GType icu_number_symbols_get_type (void);
+
+ICU_AVAILABLE_IN_ALL
+IcuNumberSymbols *icu_number_symbols_get_for_locale (const gchar  *locale,
+                                                     GError      **error);
+
+ICU_AVAILABLE_IN_ALL
+IcuNumberSymbols *icu_number_symbols_ref   (IcuNumberSymbols *self);
+ICU_AVAILABLE_IN_ALL
+void              icu_number_symbols_unref (IcuNumberSymbols *self);
+
+ICU_AVAILABLE_IN_ALL
+const gchar *icu_number_symbols_get_locale                  (IcuNumberSymbols *self);
+ICU_AVAILABLE_IN_ALL
+const gchar *icu_number_symbols_get_numbering_system        (IcuNumberSymbols *self);
+ICU_AVAILABLE_IN_ALL
+const gchar *icu_number_symbols_get                         (IcuNumberSymbols *self,
+                                                             IcuNumberSymbol   symbol);
+ICU_AVAILABLE_IN_ALL
+const gchar *icu_number_symbols_get_digit                   (IcuNumberSymbols *self,
+                                                             guint             digit);
+ICU_AVAILABLE_IN_ALL
+guint        icu_number_symbols_get_grouping_size           (IcuNumberSymbols *self);
+ICU_AVAILABLE_IN_ALL
+guint        icu_number_symbols_get_secondary_grouping_size (IcuNumberSymbols *self);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC (IcuNumberSymbols, icu_number_symbols_unref)
+
+G_END_DECLS
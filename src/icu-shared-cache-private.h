@@ -0,0 +1,49 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <glib-object.h>
+
+G_BEGIN_DECLS
+
+// Builds the item cached under `key`, or returns NULL with `error` set.
+typedef gpointer (*IcuSharedCacheBuildFunc) (const gchar  *key,
+                                             gpointer      user_data,
+                                             GError      **error);
+
+// A thread-safe cache of refcounted items keyed by string. Static
+// caches are initialized with ICU_SHARED_CACHE_INIT, and the rest with
+// icu_shared_cache_init().
+typedef struct
+{
+  GMutex lock;
+  GHashTable *items;
+
+  GBoxedCopyFunc ref_func;
+  GDestroyNotify unref_func;
+  guint max_items;
+} IcuSharedCache;
+
+#define ICU_SHARED_CACHE_INIT(ref, unref, max) \
+  { .ref_func = (GBoxedCopyFunc) (ref), .unref_func = (GDestroyNotify) (unref), .max_items = (max) }
+
+G_GNUC_INTERNAL
+void     icu_shared_cache_init  (IcuSharedCache *cache,
+                                 GBoxedCopyFunc  ref_func,
+                                 GDestroyNotify  unref_func,
+                                 guint           max_items);
+G_GNUC_INTERNAL
+void     icu_shared_cache_clear (IcuSharedCache *cache);
+
+G_GNUC_INTERNAL
+gpointer icu_shared_cache_get   (IcuSharedCache           *cache,
+                                 const gchar              *key,
+                                 IcuSharedCacheBuildFunc   build_func,
+                                 gpointer                  user_data,
+                                 GError                  **error);
+
+G_END_DECLS
@@ -0,0 +1,86 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "icu-shared-cache-private.h"
+
+// Initializes a cache whose items are referenced with `ref_func` and
+// released with `unref_func`. Once `max_items` are cached, the cache
+// starts over, or never if it is 0. Limits are meant to be far beyond
+// what applications use, so that only untrusted input reaches them.
+void
+icu_shared_cache_init (IcuSharedCache *cache,
+                       GBoxedCopyFunc  ref_func,
+                       GDestroyNotify  unref_func,
+                       guint           max_items)
+{
+  g_mutex_init (&cache->lock);
+  cache->items = NULL;
+  cache->ref_func = ref_func;
+  cache->unref_func = unref_func;
+  cache->max_items = max_items;
+}
+
+void
+icu_shared_cache_clear (IcuSharedCache *cache)
+{
+  g_clear_pointer (&cache->items, g_hash_table_unref);
+  g_mutex_clear (&cache->lock);
+}
+
+// Gets a new reference to the item cached under `key`, building it
+// with `build_func` on first use.
+gpointer
+icu_shared_cache_get (IcuSharedCache           *cache,
+                      const gchar              *key,
+                      IcuSharedCacheBuildFunc   build_func,
+                      gpointer                  user_data,
+                      GError                  **error)
+{
+  gpointer item = NULL;
+  gpointer built = NULL;
+
+  g_mutex_lock (&cache->lock);
+
+  if (cache->items != NULL)
+    item = g_hash_table_lookup (cache->items, key);
+
+  if (item != NULL)
+    cache->ref_func (item);
+
+  g_mutex_unlock (&cache->lock);
+
+  if (item != NULL)
+    return item;
+
+  // Building an item can take a while, so it is done unlocked and the
+  // first one to be built wins.
+  built = build_func (key, user_data, error);
+  if (built == NULL)
+    return NULL;
+
+  g_mutex_lock (&cache->lock);
+
+  if (cache->items == NULL)
+    cache->items = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, cache->unref_func);
+
+  item = g_hash_table_lookup (cache->items, key);
+  if (item == NULL)
+    {
+      if (cache->max_items > 0 && g_hash_table_size (cache->items) >= cache->max_items)
+        g_hash_table_remove_all (cache->items);
+
+      item = cache->ref_func (built);
+      g_hash_table_insert (cache->items, g_strdup (key), item);
+    }
+
+  cache->ref_func (item);
+
+  g_mutex_unlock (&cache->lock);
+
+  cache->unref_func (built);
+
+  return item;
+}
@@ -0,0 +1,24 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#pragma once
+
+#include <glib.h>
+#include <unicode/utypes.h>
+
+G_BEGIN_DECLS
+
+G_GNUC_INTERNAL
+void icu_utf8_append_utf16 (GString     *out,
+                            const UChar *ustring,
+                            gint32       length,
+                            UErrorCode  *ec);
+
+G_GNUC_INTERNAL
+gsize icu_utf8_length_of_utf16 (const UChar *ustring,
+                                gint32       length);
+
+G_END_DECLS
@@ -0,0 +1,75 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "icu-utf8-private.h"
+
+#include <unicode/ustring.h>
+
+// Appends `ustring` to `out` converted to UTF-8, without going
+// through an intermediate allocation. On failure, `out` is left
+// unchanged.
+void
+icu_utf8_append_utf16 (GString     *out,
+                       const UChar *ustring,
+                       gint32       length,
+                       UErrorCode  *ec)
+{
+  gsize start = 0;
+  gint32 written = 0;
+
+  if (U_FAILURE (*ec))
+    return;
+
+  // Every UTF-16 code unit takes up to three bytes in UTF-8.
+  if (length > G_MAXINT32 / 3)
+    {
+      *ec = U_INPUT_TOO_LONG_ERROR;
+      return;
+    }
+
+  start = out->len;
+  g_string_set_size (out, start + (gsize) length * 3);
+
+  u_strToUTF8 (out->str + start, length * 3, &written, ustring, length, ec);
+  if (U_FAILURE (*ec))
+    {
+      g_string_truncate (out, start);
+      return;
+    }
+
+  // The string is nul-terminated by GString anyway.
+  if (*ec == U_STRING_NOT_TERMINATED_WARNING)
+    *ec = U_ZERO_ERROR;
+
+  g_string_set_size (out, start + written);
+}
+
+// Gets the number of bytes the first `length` code units of
+// `ustring` take up in UTF-8, which maps UTF-16 indexes, like those
+// of field positions, to byte offsets.
+gsize
+icu_utf8_length_of_utf16 (const UChar *ustring,
+                          gint32       length)
+{
+  gsize utf8_length = 0;
+  gint32 i = 0;
+
+  for (i = 0; i < length; i++)
+    {
+      UChar c = ustring[i];
+
+      if (c < 0x80)
+        utf8_length += 1;
+      else if (c < 0x800)
+        utf8_length += 2;
+      else if (U16_IS_TRAIL (c) && i > 0 && U16_IS_LEAD (ustring[i - 1]))
+        utf8_length += 1;  // Its lead surrogate already counted 3 bytes
+      else
+        utf8_length += 3;
+    }
+
+  return utf8_length;
+}
@@ -0,0 +1,775 @@
+/*
+ * Copyright 2026 Nahuel Gomez https://nahuelwexd.com
+ *
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+// Generates formatters specialized for skeletons and locales known at
+// build time, see icu_number_formatter_new_specialized().
+//
+// Usage: icu-number-specializer INPUT OUTPUT-SOURCE OUTPUT-HEADER [OUTPUT-TEST]
+//
+// The input is a key file with a group for each formatter:
+//
+//   [total]
+//   skeleton=currency/USD
+//   locale=en-US
+//
+// For an input called invoice-formats.ini, the generated header
+// declares invoice_formats_get_total(), which returns a shared
+// formatter with the digits, separators, grouping and affixes ICU
+// uses for that skeleton and locale baked in.
+//
+// Every specialization is checked byte for byte against ICU on a few
+// thousand integers and fixed-point numbers before being written out,
+// and skeletons that cannot be specialized, like compact or scientific
+// ones, fail the build. When given OUTPUT-TEST, the tool also writes a
+// GTest program running the same checks on the generated getters, for
+// the build to check the compiled formatters too. As the output
+// depends on the CLDR data of the ICU the tool runs with, it has to be
+// generated again when ICU is updated.
+
+#define ICU_USE_UNSTABLE_API
+#include <icu-gobject.h>
+
+#include <string.h>
+
+#define N_RANDOM_VALUES 4096
+
+static gchar *
+make_identifier (const gchar *name)
+{
+  gchar *identifier = g_ascii_strdown (name, -1);
+  gchar *p = NULL;
+
+  for (p = identifier; *p != '\0'; p++)
+    {
+      if (!g_ascii_isalnum (*p))
+        *p = '_';
+    }
+
+  return identifier;
+}
+
+static gboolean
+format_probe (IcuNumberFormatter  *formatter,
+              gdouble              value,
+              gboolean             is_double,
+              GString             *out,
+              GArray              *fields,
+              GError             **error)
+{
+  g_string_truncate (out, 0);
+  g_array_set_size (fields, 0);
+
+  if (is_double)
+    return icu_number_formatter_append_double (formatter, value, out, fields, error);
+
+  return icu_number_formatter_append_int (formatter, (gint64) value, out, fields, error);
+}
+
+static const IcuFieldPosition *
+find_field (GArray *fields,
+            gint32  field)
+{
+  guint i = 0;
+
+  for (i = 0; i < fields->len; i++)
+    {
+      const IcuFieldPosition *position = &g_array_index (fields, IcuFieldPosition, i);
+
+      if (position->field == field)
+        return position;
+    }
+
+  return NULL;
+}
+
+static const gchar *
+get_field_text (GStringChunk           *strings,
+                GString                *out,
+                const IcuFieldPosition *position)
+{
+  return g_string_chunk_insert_len (strings, out->str + position->begin_index,
+                                    position->end_index - position->begin_index);
+}
+
+static glong
+get_field_length (GString                *out,
+                  const IcuFieldPosition *position)
+{
+  if (position == NULL)
+    return 0;
+
+  return g_utf8_strlen (out->str + position->begin_index, position->end_index - position->begin_index);
+}
+
+// Gets where the digits and separators of a formatted number start and
+// end, which is what lies between its prefix and suffix.
+static gboolean
+find_body (GArray *fields,
+           gint32 *start,
+           gint32 *end)
+{
+  const IcuFieldPosition *integer = find_field (fields, ICU_NUM_INTEGER_FIELD);
+  guint i = 0;
+
+  if (integer == NULL)
+    return FALSE;
+
+  *start = integer->begin_index;
+  *end = integer->end_index;
+
+  for (i = 0; i < fields->len; i++)
+    {
+      const IcuFieldPosition *position = &g_array_index (fields, IcuFieldPosition, i);
+
+      if (position->field == ICU_NUM_DECIMAL_SEPARATOR_FIELD ||
+          position->field == ICU_NUM_FRACTION_FIELD ||
+          position->field == ICU_NUM_GROUPING_SEPARATOR_FIELD)
+        *end = MAX (*end, position->end_index);
+    }
+
+  return TRUE;
+}
+
+static gboolean
+derive_affixes (IcuNumberFormatter  *formatter,
+                gdouble              value,
+                GStringChunk        *strings,
+                const gchar        **prefix,
+                const gchar        **suffix,
+                GString             *out,
+                GArray              *fields,
+                GError             **error)
+{
+  gint32 start = 0;
+  gint32 end = 0;
+
+  if (!format_probe (formatter, value, FALSE, out, fields, error))
+    return FALSE;
+
+  if (!find_body (fields, &start, &end))
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "“%s” has no integer digits", out->str);
+      return FALSE;
+    }
+
+  *prefix = g_string_chunk_insert_len (strings, out->str, start);
+  *suffix = g_string_chunk_insert (strings, out->str + end);
+
+  return TRUE;
+}
+
+static gboolean
+derive_grouping (IcuNumberFormatter       *formatter,
+                 IcuNumberSpecialization  *specialization,
+                 GStringChunk             *strings,
+                 GString                  *out,
+                 GArray                   *fields,
+                 GError                  **error)
+{
+  g_autoptr (GArray) groups = NULL;
+  const IcuFieldPosition *integer = NULL;
+  const IcuFieldPosition *separator = NULL;
+  gint32 group_start = 0;
+  guint i = 0;
+
+  if (!format_probe (formatter, 1234567890123, FALSE, out, fields, error))
+    return FALSE;
+
+  integer = find_field (fields, ICU_NUM_INTEGER_FIELD);
+  separator = find_field (fields, ICU_NUM_GROUPING_SEPARATOR_FIELD);
+
+  if (integer == NULL)
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "“%s” has no integer digits", out->str);
+      return FALSE;
+    }
+
+  if (separator == NULL)
+    return TRUE;
+
+  specialization->grouping_separator = get_field_text (strings, out, separator);
+
+  // The sizes of the groups of digits, from the most significant one.
+  groups = g_array_new (FALSE, FALSE, sizeof (glong));
+  group_start = integer->begin_index;
+
+  for (i = 0; i < fields->len; i++)
+    {
+      const IcuFieldPosition *position = &g_array_index (fields, IcuFieldPosition, i);
+      glong size = 0;
+
+      if (position->field != ICU_NUM_GROUPING_SEPARATOR_FIELD)
+        continue;
+
+      size = g_utf8_strlen (out->str + group_start, position->begin_index - group_start);
+      g_array_append_val (groups, size);
+      group_start = position->end_index;
+    }
+
+  g_array_append_val (groups, (glong) { g_utf8_strlen (out->str + group_start, integer->end_index - group_start) });
+
+  // The first group may be cut short, so only the rest tell the sizes.
+  if (groups->len < 3 || g_array_index (groups, glong, groups->len - 1) > G_MAXUINT8)
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "Could not tell the grouping of “%s”", out->str);
+      return FALSE;
+    }
+
+  specialization->primary_grouping = g_array_index (groups, glong, groups->len - 1);
+  specialization->secondary_grouping = g_array_index (groups, glong, groups->len - 2);
+
+  for (i = 1; i <= 4; i++)
+    {
+      gdouble value = 1;
+      guint j = 0;
+
+      for (j = 1; j < specialization->primary_grouping + i; j++)
+        value *= 10;
+
+      if (!format_probe (formatter, value, FALSE, out, fields, error))
+        return FALSE;
+
+      if (find_field (fields, ICU_NUM_GROUPING_SEPARATOR_FIELD) != NULL)
+        {
+          specialization->min_grouping_digits = i;
+          return TRUE;
+        }
+    }
+
+  g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "Could not tell when digits are grouped");
+  return FALSE;
+}
+
+static gboolean
+derive_fraction (IcuNumberFormatter       *formatter,
+                 IcuNumberSpecialization  *specialization,
+                 GStringChunk             *strings,
+                 GString                  *out,
+                 GArray                   *fields,
+                 GError                  **error)
+{
+  const IcuFieldPosition *separator = NULL;
+  glong max_fraction_digits = 0;
+
+  if (!format_probe (formatter, 1, FALSE, out, fields, error))
+    return FALSE;
+
+  specialization->min_fraction_digits = get_field_length (out, find_field (fields, ICU_NUM_FRACTION_FIELD));
+
+  separator = find_field (fields, ICU_NUM_DECIMAL_SEPARATOR_FIELD);
+  if (separator != NULL)
+    specialization->decimal_separator = get_field_text (strings, out, separator);
+
+  // A third has as many fraction digits as a double can hold, so it
+  // shows as many as the skeleton allows.
+  if (!format_probe (formatter, 1.0 / 3.0, TRUE, out, fields, error))
+    return FALSE;
+
+  max_fraction_digits = get_field_length (out, find_field (fields, ICU_NUM_FRACTION_FIELD));
+
+  if (max_fraction_digits > ICU_NUMBER_SPECIALIZATION_MAX_FRACTION_DIGITS)
+    {
+      g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED,
+                   "Shows more than %d fraction digits",
+                   ICU_NUMBER_SPECIALIZATION_MAX_FRACTION_DIGITS);
+      return FALSE;
+    }
+
+  specialization->max_fraction_digits = MAX (max_fraction_digits, specialization->min_fraction_digits);
+
+  separator = find_field (fields, ICU_NUM_DECIMAL_SEPARATOR_FIELD);
+  if (separator != NULL && specialization->decimal_separator == NULL)
+    specialization->decimal_separator = get_field_text (strings, out, separator);
+
+  if (specialization->decimal_separator == NULL)
+    specialization->decimal_separator = "";
+
+  return TRUE;
+}
+
+static gboolean
+derive_specialization (IcuNumberFormatter       *formatter,
+                       IcuNumberSpecialization  *specialization,
+                       GStringChunk             *strings,
+                       GError                  **error)
+{
+  g_autoptr (GString) out = g_string_new (NULL);
+  g_autoptr (GArray) fields = g_array_new (FALSE, FALSE, sizeof (IcuFieldPosition));
+  guint i = 0;
+
+  for (i = 0; i < G_N_ELEMENTS (specialization->digits); i++)
+    {
+      const IcuFieldPosition *integer = NULL;
+
+      if (!format_probe (formatter, i, FALSE, out, fields, error))
+        return FALSE;
+
+      integer = find_field (fields, ICU_NUM_INTEGER_FIELD);
+      if (get_field_length (out, integer) != 1)
+        {
+          g_set_error (error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "Could not tell the digit in “%s”", out->str);
+          return FALSE;
+        }
+
+      specialization->digits[i] = get_field_text (strings, out, integer);
+    }
+
+  specialization->grouping_separator = "";
+
+  if (!derive_grouping (formatter, specialization, strings, out, fields, error) ||
+      !derive_fraction (formatter, specialization, strings, out, fields, error) ||
+      !derive_affixes (formatter, 1, strings,
+                       &specialization->positive_prefix, &specialization->positive_suffix,
+                       out, fields, error) ||
+      !derive_affixes (formatter, -1, strings,
+                       &specialization->negative_prefix, &specialization->negative_suffix,
+                       out, fields, error))
+    return FALSE;
+
+  return TRUE;
+}
+
+static GArray *
+get_verification_values (void)
+{
+  GArray *values = g_array_new (FALSE, FALSE, sizeof (gint64));
+  guint32 state = 0x9E3779B9;
+  gint64 power = 1;
+  gint64 value = 0;
+  guint i = 0;
+
+  value = G_MININT64;
+  g_array_append_val (values, value);
+  value = G_MAXINT64;
+  g_array_append_val (values, value);
+
+  // Powers of ten, their neighbours and halfway points, which are
+  // where grouping, carries and rounding to even go wrong.
+  for (i = 0; i < 19; i++)
+    {
+      const gint64 multipliers[] = { 1, 5, 15, 25 };
+      guint j = 0;
+
+      for (j = 0; j < G_N_ELEMENTS (multipliers); j++)
+        {
+          const gint64 around[] = { -1, 0, 1 };
+          guint k = 0;
+
+          if (power > G_MAXINT64 / multipliers[j])
+            break;
+
+          for (k = 0; k < G_N_ELEMENTS (around); k++)
+            {
+              value = multipliers[j] * power + around[k];
+              if (value <= 0)
+                continue;
+
+              g_array_append_val (values, value);
+              value = -value;
+              g_array_append_val (values, value);
+            }
+        }
+
+      if (i < 18)
+        power *= 10;
+    }
+
+  g_array_append_val (values, (gint64) { 0 });
+
+  for (i = 0; i < N_RANDOM_VALUES; i++)
+    {
+      guint64 bits = 0;
+
+      // xorshift32, for values that are the same in every build.
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      bits = (guint64) state << 32;
+
+      state ^= state << 13;
+      state ^= state >> 17;
+      state ^= state << 5;
+      bits |= state;
+
+      value = (gint64) (bits >> (bits % 64));
+      if (bits & 1)
+        value = -value;
+
+      g_array_append_val (values, value);
+    }
+
+  return values;
+}
+
+static gboolean
+verify_specialization (const IcuNumberSpecialization  *specialization,
+                       IcuNumberFormatter             *reference,
+                       GError                        **error)
+{
+  g_autoptr (IcuNumberFormatter) specialized = NULL;
+  g_autoptr (GArray) values = NULL;
+  g_autoptr (GString) expected = g_string_new (NULL);
+  g_autoptr (GString) actual = g_string_new (NULL);
+  g_autofree gsize *expected_offsets = NULL;
+  g_autofree gsize *actual_offsets = NULL;
+  gint32 scale = 0;
+  guint i = 0;
+
+  specialized = icu_number_formatter_new_specialized (specialization);
+  values = get_verification_values ();
+
+  for (i = 0; i < values->len; i++)
+    {
+      gint64 value = g_array_index (values, gint64, i);
+
+      g_string_truncate (expected, 0);
+      g_string_truncate (actual, 0);
+
+      if (!icu_number_formatter_append_int (reference, value, expected, NULL, error))
+        return FALSE;
+
+      icu_number_formatter_append_int (specialized, value, actual, NULL, NULL);
+
+      if (!g_str_equal (expected->str, actual->str))
+        {
+          g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED,
+                       "Formats %" G_GINT64_FORMAT " as “%s” instead of “%s”",
+                       value, actual->str, expected->str);
+          return FALSE;
+        }
+    }
+
+  expected_offsets = g_new (gsize, values->len + 1);
+  actual_offsets = g_new (gsize, values->len + 1);
+
+  for (scale = -3; scale <= specialization->max_fraction_digits + 22; scale++)
+    {
+      g_string_truncate (expected, 0);
+      g_string_truncate (actual, 0);
+
+      if (!icu_number_formatter_format_fixed_batch (reference, (const gint64 *) values->data, scale, values->len,
+                                                    expected, expected_offsets, NULL, error))
+        return FALSE;
+
+      icu_number_formatter_format_fixed_batch (specialized, (const gint64 *) values->data, scale, values->len,
+                                               actual, actual_offsets, NULL, NULL);
+
+      for (i = 0; i < values->len; i++)
+        {
+          gsize expected_length = expected_offsets[i + 1] - expected_offsets[i];
+          gsize actual_length = actual_offsets[i + 1] - actual_offsets[i];
+
+          if (expected_length != actual_length ||
+              memcmp (expected->str + expected_offsets[i], actual->str + actual_offsets[i], actual_length) != 0)
+            {
+              g_set_error (error, G_IO_ERROR, G_IO_ERROR_FAILED,
+                           "Formats %" G_GINT64_FORMAT "e-%d as “%.*s” instead of “%.*s”",
+                           g_array_index (values, gint64, i), scale,
+                           (int) actual_length, actual->str + actual_offsets[i],
+                           (int) expected_length, expected->str + expected_offsets[i]);
+              return FALSE;
+            }
+        }
+    }
+
+  return TRUE;
+}
+
+static void
+append_string (GString     *out,
+               const gchar *name,
+               const gchar *value)
+{
+  g_autofree gchar *escaped = g_strescape (value, NULL);
+
+  g_string_append_printf (out, "  .%s = \"%s\",\n", name, escaped);
+}
+
+static void
+append_specialization (GString                       *source,
+                       GString                       *header,
+                       const gchar                   *prefix,
+                       const gchar                   *name,
+                       const IcuNumberSpecialization *specialization)
+{
+  g_autofree gchar *identifier = make_identifier (name);
+  guint i = 0;
+
+  g_string_append_printf (source, "static const IcuNumberSpecialization %s_specialization = {\n", identifier);
+  append_string (source, "skeleton", specialization->skeleton);
+  append_string (source, "locale", specialization->locale);
+
+  g_string_append (source, "  .digits = {");
+  for (i = 0; i < G_N_ELEMENTS (specialization->digits); i++)
+    {
+      g_autofree gchar *escaped = g_strescape (specialization->digits[i], NULL);
+
+      g_string_append_printf (source, "%s\"%s\"", i > 0 ? ", " : " ", escaped);
+    }
+  g_string_append (source, " },\n");
+
+  append_string (source, "decimal_separator", specialization->decimal_separator);
+  append_string (source, "grouping_separator", specialization->grouping_separator);
+  g_string_append_printf (source, "  .primary_grouping = %u,\n", specialization->primary_grouping);
+  g_string_append_printf (source, "  .secondary_grouping = %u,\n", specialization->secondary_grouping);
+  g_string_append_printf (source, "  .min_grouping_digits = %u,\n", specialization->min_grouping_digits);
+  g_string_append_printf (source, "  .min_fraction_digits = %u,\n", specialization->min_fraction_digits);
+  g_string_append_printf (source, "  .max_fraction_digits = %u,\n", specialization->max_fraction_digits);
+  append_string (source, "positive_prefix", specialization->positive_prefix);
+  append_string (source, "positive_suffix", specialization->positive_suffix);
+  append_string (source, "negative_prefix", specialization->negative_prefix);
+  append_string (source, "negative_suffix", specialization->negative_suffix);
+  g_string_append (source, "};\n\n");
+
+  g_string_append_printf (source,
+                          "IcuNumberFormatter *\n"
+                          "%s_get_%s (void)\n"
+                          "{\n"
+                          "  static IcuNumberFormatter *formatter = NULL;\n"
+                          "\n"
+                          "  if (g_once_init_enter (&formatter))\n"
+                          "    g_once_init_leave (&formatter, icu_number_formatter_new_specialized (&%s_specialization));\n"
+                          "\n"
+                          "  return formatter;\n"
+                          "}\n\n",
+                          prefix, identifier, identifier);
+
+  g_string_append_printf (header, "IcuNumberFormatter *%s_get_%s (void);\n", prefix, identifier);
+}
+
+static void
+append_test_case (GString                       *cases,
+                  const gchar                   *prefix,
+                  const gchar                   *name,
+                  const IcuNumberSpecialization *specialization)
+{
+  g_autofree gchar *identifier = make_identifier (name);
+  g_autofree gchar *escaped_name = g_strescape (name, NULL);
+  g_autofree gchar *escaped_skeleton = g_strescape (specialization->skeleton, NULL);
+  g_autofree gchar *escaped_locale = g_strescape (specialization->locale, NULL);
+
+  g_string_append_printf (cases, "  { \"%s\", \"%s\", \"%s\", %d, %s_get_%s },\n",
+                          escaped_name, escaped_skeleton, escaped_locale,
+                          specialization->max_fraction_digits + 22, prefix, identifier);
+}
+
+// Writes a test comparing every generated getter against a formatter
+// created by ICU, on the values verify_specialization() uses.
+static gboolean
+write_test (const gchar  *filename,
+            const gchar  *input_name,
+            const gchar  *header_name,
+            GString      *cases,
+            GError      **error)
+{
+  g_autoptr (GString) test = g_string_new (NULL);
+  g_autoptr (GArray) values = get_verification_values ();
+  guint i = 0;
+
+  g_string_append_printf (test,
+                          "/* Generated by icu-number-specializer from %s, do not edit. */\n\n"
+                          "#include \"%s\"\n\n"
+                          "#include <string.h>\n\n"
+                          "typedef struct\n"
+                          "{\n"
+                          "  const gchar *name;\n"
+                          "  const gchar *skeleton;\n"
+                          "  const gchar *locale;\n"
+                          "  gint32 max_scale;\n"
+                          "  IcuNumberFormatter *(*get_formatter) (void);\n"
+                          "} TestCase;\n\n"
+                          "static const TestCase test_cases[] = {\n"
+                          "%s"
+                          "};\n\n"
+                          "static const gint64 values[] = {",
+                          input_name, header_name, cases->str);
+
+  for (i = 0; i < values->len; i++)
+    {
+      gint64 value = g_array_index (values, gint64, i);
+
+      g_string_append (test, i % 4 == 0 ? "\n  " : " ");
+
+      if (value == G_MININT64)
+        g_string_append (test, "G_MININT64,");
+      else
+        g_string_append_printf (test, "G_GINT64_CONSTANT (%" G_GINT64_FORMAT "),", value);
+    }
+
+  g_string_append (test,
+                   "\n};\n\n"
+                   "static void\n"
+                   "test_specialization (gconstpointer data)\n"
+                   "{\n"
+                   "  const TestCase *test_case = data;\n"
+                   "  g_autoptr (IcuNumberFormatter) reference = NULL;\n"
+                   "  g_autoptr (GString) expected = g_string_new (NULL);\n"
+                   "  g_autoptr (GString) actual = g_string_new (NULL);\n"
+                   "  g_autofree gsize *expected_offsets = g_new (gsize, G_N_ELEMENTS (values) + 1);\n"
+                   "  g_autofree gsize *actual_offsets = g_new (gsize, G_N_ELEMENTS (values) + 1);\n"
+                   "  g_autoptr (GError) error = NULL;\n"
+                   "  IcuNumberFormatter *specialized = NULL;\n"
+                   "  gint32 scale = 0;\n"
+                   "  gsize i = 0;\n"
+                   "\n"
+                   "  reference = icu_number_formatter_new (test_case->skeleton, test_case->locale, &error);\n"
+                   "  g_assert_no_error (error);\n"
+                   "\n"
+                   "  specialized = test_case->get_formatter ();\n"
+                   "  g_assert_nonnull (specialized);\n"
+                   "\n"
+                   "  for (i = 0; i < G_N_ELEMENTS (values); i++)\n"
+                   "    {\n"
+                   "      g_string_truncate (expected, 0);\n"
+                   "      g_string_truncate (actual, 0);\n"
+                   "\n"
+                   "      icu_number_formatter_append_int (reference, values[i], expected, NULL, &error);\n"
+                   "      g_assert_no_error (error);\n"
+                   "      icu_number_formatter_append_int (specialized, values[i], actual, NULL, &error);\n"
+                   "      g_assert_no_error (error);\n"
+                   "\n"
+                   "      g_assert_cmpstr (actual->str, ==, expected->str);\n"
+                   "    }\n"
+                   "\n"
+                   "  for (scale = -3; scale <= test_case->max_scale; scale++)\n"
+                   "    {\n"
+                   "      g_string_truncate (expected, 0);\n"
+                   "      g_string_truncate (actual, 0);\n"
+                   "\n"
+                   "      icu_number_formatter_format_fixed_batch (reference, values, scale, G_N_ELEMENTS (values),\n"
+                   "                                               expected, expected_offsets, NULL, &error);\n"
+                   "      g_assert_no_error (error);\n"
+                   "      icu_number_formatter_format_fixed_batch (specialized, values, scale, G_N_ELEMENTS (values),\n"
+                   "                                               actual, actual_offsets, NULL, &error);\n"
+                   "      g_assert_no_error (error);\n"
+                   "\n"
+                   "      for (i = 0; i < G_N_ELEMENTS (values); i++)\n"
+                   "        {\n"
+                   "          g_assert_cmpmem (actual->str + actual_offsets[i], actual_offsets[i + 1] - actual_offsets[i],\n"
+                   "                           expected->str + expected_offsets[i], expected_offsets[i + 1] - expected_offsets[i]);\n"
+                   "        }\n"
+                   "    }\n"
+                   "}\n"
+                   "\n"
+                   "int\n"
+                   "main (int    argc,\n"
+                   "      char **argv)\n"
+                   "{\n"
+                   "  gsize i = 0;\n"
+                   "\n"
+                   "  g_test_init (&argc, &argv, NULL);\n"
+                   "\n"
+                   "  for (i = 0; i < G_N_ELEMENTS (test_cases); i++)\n"
+                   "    {\n"
+                   "      g_autofree gchar *path = g_strconcat (\"/specializations/\", test_cases[i].name, NULL);\n"
+                   "\n"
+                   "      g_test_add_data_func (path, &test_cases[i], test_specialization);\n"
+                   "    }\n"
+                   "\n"
+                   "  return g_test_run ();\n"
+                   "}\n");
+
+  return g_file_set_contents (filename, test->str, test->len, error);
+}
+
+int
+main (int    argc,
+      char **argv)
+{
+  g_autoptr (GKeyFile) key_file = g_key_file_new ();
+  g_autoptr (GStringChunk) strings = g_string_chunk_new (1024);
+  g_autoptr (GString) source = g_string_new (NULL);
+  g_autoptr (GString) header = g_string_new (NULL);
+  g_autoptr (GString) cases = g_string_new (NULL);
+  g_autoptr (GError) error = NULL;
+  g_autofree gchar *input_name = NULL;
+  g_autofree gchar *header_name = NULL;
+  g_autofree gchar *prefix = NULL;
+  g_auto (GStrv) groups = NULL;
+  gchar *extension = NULL;
+  gsize i = 0;
+
+  if (argc != 4 && argc != 5)
+    {
+      g_printerr ("Usage: %s INPUT OUTPUT-SOURCE OUTPUT-HEADER [OUTPUT-TEST]\n", argv[0]);
+      return 1;
+    }
+
+  if (!g_key_file_load_from_file (key_file, argv[1], G_KEY_FILE_NONE, &error))
+    {
+      g_printerr ("Could not load %s: %s\n", argv[1], error->message);
+      return 1;
+    }
+
+  input_name = g_path_get_basename (argv[1]);
+  header_name = g_path_get_basename (argv[3]);
+
+  extension = strrchr (input_name, '.');
+  if (extension != NULL)
+    *extension = '\0';
+
+  prefix = make_identifier (input_name);
+
+  g_string_append_printf (source,
+                          "/* Generated by icu-number-specializer from %s, do not edit. */\n\n"
+                          "#include \"%s\"\n\n",
+                          input_name, header_name);
+
+  g_string_append_printf (header,
+                          "/* Generated by icu-number-specializer from %s, do not edit. */\n\n"
+                          "#pragma once\n\n"
+                          "#ifndef ICU_USE_UNSTABLE_API\n"
+                          "#  define ICU_USE_UNSTABLE_API\n"
+                          "#endif\n"
+                          "#include <icu-gobject.h>\n\n"
+                          "G_BEGIN_DECLS\n\n",
+                          input_name);
+
+  groups = g_key_file_get_groups (key_file, NULL);
+
+  for (i = 0; groups[i] != NULL; i++)
+    {
+      g_autoptr (IcuNumberFormatter) reference = NULL;
+      IcuNumberSpecialization specialization = {0};
+      g_autofree gchar *skeleton = NULL;
+      g_autofree gchar *locale = NULL;
+
+      skeleton = g_key_file_get_string (key_file, groups[i], "skeleton", &error);
+      if (skeleton != NULL)
+        locale = g_key_file_get_string (key_file, groups[i], "locale", &error);
+
+      if (locale != NULL)
+        {
+          specialization.skeleton = skeleton;
+          specialization.locale = locale;
+
+          reference = icu_number_formatter_new (skeleton, locale, &error);
+        }
+
+      if (reference == NULL ||
+          !derive_specialization (reference, &specialization, strings, &error) ||
+          !verify_specialization (&specialization, reference, &error))
+        {
+          g_printerr ("%s: [%s] cannot be specialized: %s\n", argv[1], groups[i], error->message);
+          return 1;
+        }
+
+      append_specialization (source, header, prefix, groups[i], &specialization);
+      append_test_case (cases, prefix, groups[i], &specialization);
+    }
+
+  g_string_append (header, "\nG_END_DECLS\n");
+
+  if (!g_file_set_contents (argv[2], source->str, source->len, &error) ||
+      !g_file_set_contents (argv[3], header->str, header->len, &error) ||
+      (argc == 5 && !write_test (argv[4], input_name, header_name, cases, &error)))
+    {
+      g_printerr ("Could not write the output: %s\n", error->message);
+      return 1;
+    }
+
+  return 0;
+}